@@ -0,0 +1,105 @@
+/**
+ * @file manifest.h
+ * @brief Incremental build manifest for shellscribe
+ *
+ * The manifest is stored in the documentation directory and records, for each
+ * documented script, the state of the script when its documentation was
+ * generated. It lets unchanged scripts be skipped on later runs and the
+ * documentation of deleted scripts be pruned.
+ */
+
+#ifndef SHELLSCRIBE_CORE_MANIFEST_H
+#define SHELLSCRIBE_CORE_MANIFEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "utils/config.h"
+
+/**
+ * @brief Name of the manifest file, relative to the documentation directory
+ */
+#define MANIFEST_FILENAME ".scribe-manifest"
+
+/**
+ * @brief State of a source file used to detect changes
+ */
+typedef struct {
+    uint64_t size;          // Size of the file in bytes
+    int64_t mtime_sec;      // Modification time (seconds)
+    long mtime_nsec;        // Modification time (nanoseconds)
+    uint64_t hash;          // Hash of the contents (0 if not computed)
+} manifest_stamp_t;
+
+/**
+ * @brief Opaque manifest handle
+ */
+typedef struct manifest manifest_t;
+
+/**
+ * @brief Load the manifest of a documentation directory
+ *
+ * @param doc_path The documentation directory
+ * @param config The configuration (used to compute the configuration fingerprint)
+ * @return manifest_t* The manifest (empty if none exists), NULL on allocation failure
+ */
+manifest_t *manifest_load(const char *doc_path, const shellscribe_config_t *config);
+
+/**
+ * @brief Fill a stamp from the status of a file
+ *
+ * @param stamp The stamp to fill (its hash is reset)
+ * @param st The status of the file
+ */
+void manifest_stamp_from_stat(manifest_stamp_t *stamp, const struct stat *st);
+
+/**
+ * @brief Compute the content hash of a file
+ *
+ * @param data The contents of the file
+ * @param length The length of the contents
+ * @return uint64_t The hash of the contents
+ */
+uint64_t manifest_hash(const char *data, size_t length);
+
+/**
+ * @brief Check whether the documentation of a script is up to date
+ *
+ * @param manifest The manifest
+ * @param source_path The script
+ * @param output_path The expected documentation file of the script
+ * @param stamp The current state of the script
+ * @return bool True if the documentation does not need to be regenerated
+ *
+ * @note Safe to call from several threads while no entry is being recorded
+ */
+bool manifest_is_current(const manifest_t *manifest, const char *source_path, const char *output_path, const manifest_stamp_t *stamp);
+
+/**
+ * @brief Record the outcome of the processing of a script
+ *
+ * @param manifest The manifest
+ * @param source_path The script
+ * @param output_path The documentation file of the script, NULL if none was generated
+ * @param stamp The state of the script (ignored if output_path is NULL)
+ */
+void manifest_record(manifest_t *manifest, const char *source_path, const char *output_path, const manifest_stamp_t *stamp);
+
+/**
+ * @brief Prune stale documentation and save the manifest
+ *
+ * @param manifest The manifest
+ * @return int Number of documentation files pruned, -1 if the manifest could not be saved
+ */
+int manifest_save(manifest_t *manifest);
+
+/**
+ * @brief Free a manifest
+ *
+ * @param manifest The manifest (can be NULL)
+ */
+void manifest_free(manifest_t *manifest);
+
+#endif /* SHELLSCRIBE_CORE_MANIFEST_H */
@@ -12,6 +12,70 @@
 #include "utils/config.h"
 #include "parsers/types.h"
 
+/**
+ * @brief Contents of a shell script loaded in memory
+ */
+typedef struct {
+    char *data;        // Contents of the file, NUL-terminated
+    size_t length;     // Length of the contents in bytes (without the terminator)
+} shellscribe_source_t;
+
+/**
+ * @brief Default number of bytes probed by probe_shell_source() and probe_shell_script()
+ */
+#define SHELLSCRIBE_PROBE_DEFAULT_SIZE (16 * 1024)
+
+/**
+ * @brief What the leading comment header of a shell script tells about it
+ */
+typedef struct {
+    bool is_binary;    // Contents start with the ELF magic number or hold NUL bytes
+    bool is_elf;       // Contents start with the ELF magic number
+    bool is_skipped;   // The header marks the script with @skip
+    char *interpreter; // Interpreter named by the shebang (NULL if none)
+    char *brief;       // File-level @brief of the header (NULL if none)
+} shellscribe_probe_t;
+
+/**
+ * @brief Read a shell script into memory
+ * 
+ * @param file_path Path to the shell script file
+ * @param source Output parameter receiving the contents of the file
+ * @return bool True on success, false if the file could not be read
+ */
+bool load_shell_script(const char *file_path, shellscribe_source_t *source);
+
+/**
+ * @brief Release the contents of a shell script loaded with load_shell_script()
+ * 
+ * @param source The loaded contents
+ */
+void free_shell_script(shellscribe_source_t *source);
+
+/**
+ * @brief Build the path of a temporary file next to a file
+ * 
+ * The name holds the process id and a per-process counter, so that threads
+ * and concurrent runs writing the same file never share a temporary file.
+ * 
+ * @param path The file to be replaced
+ * @param temp_path Buffer receiving the temporary path
+ * @param size Size of the buffer
+ * @return bool True on success, false if the path does not fit in the buffer
+ */
+bool make_temp_path(const char *path, char *temp_path, size_t size);
+
+/**
+ * @brief Parse a shell script already loaded in memory
+ * 
+ * @param file_path Path to the shell script file
+ * @param source Contents of the shell script (split into lines in place)
+ * @param block_count Output parameter to store the number of blocks
+ * @param config Configuration options
+ * @return shellscribe_docblock_t* Array of documentation blocks, or NULL on error
+ */
+shellscribe_docblock_t* parse_shell_source(const char *file_path, shellscribe_source_t *source, int *block_count, const shellscribe_config_t *config);
+
 /**
  * @brief Parse a shell script and return the documentation blocks
  * 
@@ -22,4 +86,31 @@
  */
 shellscribe_docblock_t* parse_shell_script(const char *file_path, int *block_count, const shellscribe_config_t *config);
 
+/**
+ * @brief Probe the flags of the header of a shell script already loaded in memory
+ * 
+ * @param source Contents of the shell script (restored before returning)
+ * @param max_size Maximum number of bytes probed (0 for SHELLSCRIBE_PROBE_DEFAULT_SIZE)
+ * @param probe Output parameter receiving the flags (interpreter and brief are left NULL)
+ * @return bool True on success, false if a parameter is NULL
+ */
+bool probe_shell_source(shellscribe_source_t *source, size_t max_size, shellscribe_probe_t *probe);
+
+/**
+ * @brief Probe the header of a shell script, reading only the beginning of the file
+ * 
+ * @param file_path Path to the shell script file
+ * @param max_size Maximum number of bytes read (0 for SHELLSCRIBE_PROBE_DEFAULT_SIZE)
+ * @param probe Output parameter receiving what the header tells
+ * @return bool True on success, false if the file could not be read
+ */
+bool probe_shell_script(const char *file_path, size_t max_size, shellscribe_probe_t *probe);
+
+/**
+ * @brief Release the strings of a probe filled by probe_shell_source() or probe_shell_script()
+ * 
+ * @param probe The probe
+ */
+void free_shell_probe(shellscribe_probe_t *probe);
+
 #endif /* SHELLSCRIBE_H */
@@ -19,6 +19,16 @@
  */
 bool process_alert_tag(shellscribe_docblock_t *docblock, const char *tag, const char *content);
 
+/**
+ * @brief Add an alert of a given type to a documentation block
+ *
+ * @param docblock The documentation block
+ * @param alert_type The alert type code (NOTE, TIP, IMPORTANT, WARNING, CAUTION, ...)
+ * @param content The alert content
+ * @return true if successful, false otherwise
+ */
+bool add_alert_to_docblock(shellscribe_docblock_t *docblock, const char *alert_type, const char *content);
+
 /**
  * @brief Check if a tag is a GitHub alert tag
  *
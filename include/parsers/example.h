@@ -18,12 +18,12 @@ typedef struct parser_state parser_state_t;
 /**
  * @brief Extracts example content from documentation comments
  *
- * @param file File pointer at the current position
+ * @param state Parser state positioned on the line of the example tag
  * @param initial_content Initial content of the example
  * @param config Configuration options
  * @return Extracted example content
  */
-char *extract_example_content(FILE *file, const char *initial_content, const shellscribe_config_t *config);
+char *extract_example_content(parser_state_t *state, const char *initial_content, const shellscribe_config_t *config);
 
 /**
  * @brief Adds an example to a documentation block
@@ -29,11 +29,12 @@ bool is_exitcode_tag(const char *tag);
 /**
  * @brief Parse the exitcode content to extract the code and its description
  * 
+ * @param arena Arena allocating the extracted strings
  * @param content The exitcode content to parse
  * @param code Output parameter for the extracted exit code
  * @param description Output parameter for the extracted description
  * @return true if parsing was successful, false otherwise
  */
-bool parse_exitcode_content(const char *content, char **code, char **description);
+bool parse_exitcode_content(arena_t *arena, const char *content, char **code, char **description);
 
 #endif /* SHELLSCRIBE_EXITCODE_H */ 
@@ -0,0 +1,74 @@
+/**
+ * @file line_class.h
+ * @brief Line classification for shell script parsing
+ *
+ * This module tells what a line of a shell script is in a single walk over
+ * it, and records where the parts that the parser stages need next start, so
+ * that none of them has to skip the leading whitespace or look for the comment
+ * character again.
+ */
+
+#ifndef SHELLSCRIBE_LINE_CLASS_H
+#define SHELLSCRIBE_LINE_CLASS_H
+
+#include "parsers/tag.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Kinds of lines
+ */
+typedef enum {
+    LINE_BLANK,                 // Empty or whitespace-only line
+    LINE_CODE,                  // Any other line that is not a comment
+    LINE_FUNCTION,              // Function declaration ("name() {" or "function name")
+    LINE_COMMENT,               // Comment line without anything more specific
+    LINE_TAG,                   // Comment line holding a documentation tag ("# @name content")
+    LINE_SHELLCHECK,            // Comment line holding a shellcheck directive
+    LINE_SHEBANG                // Interpreter line ("#!" at the start of the first line)
+} line_kind_t;
+
+/**
+ * @brief Classification of a line, with offsets into the line
+ */
+typedef struct {
+    line_kind_t kind;           // Kind of the line
+    size_t indent;              // Offset of the first non-whitespace character ('#' for comment kinds)
+    size_t text;                // Offset of the text following '#' and whitespace (comment kinds only)
+    size_t name;                // Offset of the declared function name (LINE_FUNCTION only)
+    size_t name_length;         // Length of the declared function name (0 if none)
+    tag_t tag;                  // Lexed tag, as views into the line (LINE_TAG only)
+} line_class_t;
+
+/**
+ * @brief Classify a line
+ *
+ * @param line Line to classify (NUL-terminated)
+ * @param length Length of the line
+ * @param first Whether the line is the first line of the file
+ * @param cls Filled with the classification of the line
+ * @return line_kind_t The kind of the line
+ */
+line_kind_t classify_line(const char *line, size_t length, bool first, line_class_t *cls);
+
+/**
+ * @brief Classify a line whose first non-blank character is already known
+ *
+ * @param line Line to classify (NUL-terminated)
+ * @param length Length of the line
+ * @param indent Offset of the first non-blank character (length if the line is blank)
+ * @param first Whether the line is the first line of the file
+ * @param cls Filled with the classification of the line
+ * @return line_kind_t The kind of the line
+ */
+line_kind_t classify_line_at(const char *line, size_t length, size_t indent, bool first, line_class_t *cls);
+
+/**
+ * @brief Check whether a kind of line is a comment
+ *
+ * @param kind Kind of line
+ * @return bool True for comments, tags, shellcheck directives and shebangs
+ */
+bool line_kind_is_comment(line_kind_t kind);
+
+#endif /* SHELLSCRIBE_LINE_CLASS_H */
@@ -29,12 +29,13 @@ bool is_option_tag(const char *tag);
 /**
  * @brief Parse the option content to extract the option and its description
  * 
+ * @param arena Arena allocating the extracted strings
  * @param content The option content to parse
  * @param option Output parameter for the extracted option
  * @param description Output parameter for the extracted description
  * @param arg_spec Output parameter for the argument specification, if any
  * @return true if parsing was successful, false otherwise
  */
-bool parse_option_content(const char *content, char **option, char **description, char **arg_spec);
+bool parse_option_content(arena_t *arena, const char *content, char **option, char **description, char **arg_spec);
 
 #endif /* SHELLSCRIBE_OPTION_H */ 
@@ -20,11 +20,23 @@
  * 
  * @param file_path Path to the shell script file
  * @param config Configuration options
- * @param docblocks Array to store the extracted documentation blocks
- * @param max_blocks Maximum number of blocks to extract
+ * @param docblocks List receiving the extracted documentation blocks (empty, with an arena, on entry)
  * @return Number of blocks extracted or -1 on error
  */
 int parse_shell_file(const char *file_path, const shellscribe_config_t *config,
-    shellscribe_docblock_t *docblocks, int max_blocks);
+    shellscribe_docblock_list_t *docblocks);
+
+/**
+ * @brief Parse an in-memory shell script to extract documentation
+ * 
+ * @param file_path Path of the shell script (used as the file name)
+ * @param buffer Contents of the shell script, split into lines in place (buffer[length] must be writable)
+ * @param length Length of the contents in bytes
+ * @param config Configuration options
+ * @param docblocks List receiving the extracted documentation blocks (empty, with an arena, on entry)
+ * @return Number of blocks extracted or 0 on error
+ */
+int parse_shell_buffer(const char *file_path, char *buffer, size_t length,
+    const shellscribe_config_t *config, shellscribe_docblock_list_t *docblocks);
 
 #endif /* SHELLSCRIBE_PARSER_ENGINE_H */ 
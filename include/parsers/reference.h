@@ -29,12 +29,13 @@ bool is_see_tag(const char *tag);
 /**
  * @brief Parse the see content to extract the reference name and URL (if any)
  * 
+ * @param arena Arena allocating the extracted strings
  * @param content The see tag content to parse
  * @param name Output parameter for the extracted reference name
  * @param url Output parameter for the extracted URL, if any
  * @param is_internal Output parameter indicating if this is an internal reference
  * @return true if parsing was successful, false otherwise
  */
-bool parse_see_content(const char *content, char **name, char **url, bool *is_internal);
+bool parse_see_content(arena_t *arena, const char *content, char **name, char **url, bool *is_internal);
 
 #endif /* SHELLSCRIBE_REFERENCE_H */ 
@@ -28,6 +28,9 @@ char *extract_shellcheck_directive(const char *line);
 /**
  * @brief Add a shellcheck directive to a docblock
  * 
+ * Each code of a multi-code directive (e.g., "disable=SC2034,SC2086") is added
+ * as an entry of its own, sharing the reason of the directive.
+ * 
  * @param docblock The docblock to add the directive to
  * @param directive The directive to add
  * @return true if successful, false otherwise
@@ -7,20 +7,29 @@
 #define SHELLSCRIBE_STATE_H
 
 #include "parsers/types.h"
+#include "parsers/tag.h"
+#include "parsers/line_class.h"
 #include "utils/config.h"
+#include "utils/line_scanner.h"
 #include <stdio.h>
 #include <stdbool.h>
-
-#define MAX_LINE_LENGTH 4096
+#include <stdint.h>
 
 /**
  * @brief Parser state structure
  */
 typedef struct parser_state {
-    FILE *file;                    // Current file being parsed
+    line_scanner_t scanner;        // Lines of the file being parsed
     shellscribe_docblock_t *current_block; // Current documentation block
-    char line[MAX_LINE_LENGTH];    // Current line buffer
-    int line_number;               // Current line number
+    shellscribe_docblock_t *file_block; // File-level documentation block (NULL if not tracked)
+    bool in_header;                // Whether the lines consumed so far are all comment lines
+    uint64_t file_tags_seen;       // File-level tags processed while file_block was current (bit per tag_id_t)
+    char *line;                    // Current line (NUL-terminated, points into the scanned buffer)
+    size_t line_length;            // Length of the current line
+    line_class_t line_class;       // Classification of the current line
+    line_class_t next_class;       // Classification of the next line, once peeked at
+    bool next_classified;          // Whether next_class holds the classification of the next line
+    int line_number;               // Number of the current line (1-based, 0 before the first line)
     bool in_docblock;              // Whether we're inside a documentation block
     const char *file_path;         // Path to the file being parsed
     const shellscribe_config_t *config; // Configuration options
@@ -36,6 +45,17 @@ typedef struct parser_state {
  */
 bool init_parser_state(parser_state_t *state, const char *file_path, const shellscribe_config_t *config);
 
+/**
+ * @brief Initialize the parser state over an in-memory copy of a file
+ * 
+ * @param state Parser state to initialize
+ * @param buffer Contents of the file to parse, split into lines in place (buffer[length] must be writable)
+ * @param length Length of the contents in bytes
+ * @param config Configuration options
+ * @return true if successful, false otherwise
+ */
+bool init_parser_state_from_buffer(parser_state_t *state, char *buffer, size_t length, const shellscribe_config_t *config);
+
 /**
  * @brief Clean up the parser state
  * 
@@ -43,15 +63,86 @@ bool init_parser_state(parser_state_t *state, const char *file_path, const shell
  */
 void cleanup_parser_state(parser_state_t *state);
 
+/**
+ * @brief Look at a line after the current one without consuming it
+ * 
+ * @param state Parser state
+ * @param ahead Number of lines to look past (0 for the line following the current one)
+ * @param line Filled with the line
+ * @return true if the line exists, false past the end of the file
+ */
+bool state_peek_line(const parser_state_t *state, size_t ahead, line_span_t *line);
+
+/**
+ * @brief Classify the line following the current one without consuming it
+ * 
+ * @param state Parser state
+ * @param line Filled with the line
+ * @return const line_class_t* The classification of the line (reused when it is consumed), NULL past the end of the file
+ */
+const line_class_t *state_peek_class(parser_state_t *state, line_span_t *line);
+
+/**
+ * @brief Consume the next line, making it the current line
+ * 
+ * @param state Parser state
+ * @return true if a line was consumed and classified, false at the end of the file
+ */
+bool state_next_line(parser_state_t *state);
+
+/**
+ * @brief Consume the run of code lines following the current one
+ * 
+ * @param state Parser state, positioned on a line that is not a comment
+ * @return size_t The number of lines skipped (lines that may declare a function are never skipped)
+ */
+size_t state_skip_code_lines(parser_state_t *state);
+
+/**
+ * @brief Collect the comment lines continuing a multi-line tag
+ * 
+ * @param state Parser state, positioned on the line of the tag
+ * @param initial_content Content of the tag line
+ * @return char* Newly allocated string containing the collected content (to be freed by the caller)
+ */
+char *state_collect_continued_content(parser_state_t *state, const char *initial_content);
+
+/**
+ * @brief Handler of a tag
+ * 
+ * @param state Current parser state
+ * @param id Identifier of the tag
+ * @param content Tag content (collected across continuation lines for continued tags)
+ * @return true if successful, false otherwise
+ */
+typedef bool (*tag_handler_t)(parser_state_t *state, tag_id_t id, const char *content);
+
+/**
+ * @brief Dispatch information of a known tag
+ */
+typedef struct {
+    tag_handler_t handler;      // Handler of the tag (NULL for tags that are recognized but ignored)
+    bool file_level;            // Whether the tag is file-level metadata, also picked up from the header
+    bool continued;             // Whether the content continues on the following comment lines
+    const char *alert_type;     // Type of the alert created by the tag (NULL if not an alert)
+} tag_spec_t;
+
+/**
+ * @brief Get the dispatch information of a tag
+ * 
+ * @param id Identifier of the tag
+ * @return const tag_spec_t* The dispatch information (all unset for TAG_UNKNOWN)
+ */
+const tag_spec_t *get_tag_spec(tag_id_t id);
+
 /**
  * @brief Process a tag in the current parser state
  * 
  * @param state Current parser state
- * @param tag Tag name
- * @param content Tag content
+ * @param tag Lexed tag
  * @return true if successful, false otherwise
  */
-bool state_process_tag(parser_state_t *state, const char *tag, const char *content);
+bool state_process_tag(parser_state_t *state, const tag_t *tag);
 
 /**
  * @brief Process an example tag using the current parser state
@@ -7,15 +7,70 @@
 #define SHELLSCRIBE_PARSERS_TAG_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "parsers/types.h"
 #include "utils/config.h"
 
+// Forward declaration
+struct parser_state;
+typedef struct parser_state parser_state_t;
+
+/**
+ * @brief Identifier of a known tag
+ */
+typedef enum {
+    TAG_UNKNOWN = 0,
+    // File-level metadata
+    TAG_FILE,
+    TAG_VERSION,
+    TAG_AUTHOR,
+    TAG_LICENSE,
+    TAG_COPYRIGHT,
+    TAG_SINCE,
+    TAG_DESCRIPTION,
+    TAG_PACKAGE,
+    TAG_MODULE,
+    TAG_LINK,
+    TAG_REPO,
+    TAG_SEE,
+    TAG_ENV,
+    TAG_SKIP,
+    // Function documentation
+    TAG_FUNCTION,
+    TAG_BRIEF,
+    TAG_ARG,
+    TAG_ARGUMENT,
+    TAG_PARAM,
+    TAG_RETURN,
+    TAG_RETURNS,
+    TAG_EXITCODE,
+    TAG_EXAMPLE,
+    TAG_STDOUT,
+    TAG_STDERR,
+    TAG_INTERNAL,
+    // Alerts
+    TAG_NOTE,
+    TAG_WARNING,
+    TAG_ERROR,
+    TAG_TIP,
+    TAG_IMPORTANT,
+    TAG_INFO,
+    TAG_DANGER,
+    TAG_HINT,
+    TAG_CAUTION,
+    TAG_ALERT,
+    TAG_ID_COUNT
+} tag_id_t;
+
 /**
- * @brief Structure representing a parsed tag
+ * @brief Structure representing a lexed tag, as views into its line
  */
 typedef struct {
-    char *name;        // Tag name (without @ prefix)
-    char *content;     // Tag content
+    tag_id_t id;            // Identifier of the tag (TAG_UNKNOWN if not a known tag)
+    const char *name;       // Tag name (without @ prefix), not NUL-terminated
+    size_t name_length;     // Length of the tag name
+    const char *content;    // Tag content (runs to the end of the line, so it is NUL-terminated)
+    size_t content_length;  // Length of the tag content
 } tag_t;
 
 /**
@@ -27,20 +82,32 @@ typedef struct {
 extern bool is_tag_line(const char *line);
 
 /**
- * @brief Extract tag name from a line
+ * @brief Split a tag line into the name and the content of its tag
+ * 
+ * @param line Line to lex (NUL-terminated)
+ * @param length Length of the line
+ * @param tag Filled with views into the line
+ * @return bool True if the line contains a tag, false otherwise (tag is then left untouched)
+ * @note Nothing is allocated: the views are only valid as long as the line
+ */
+bool lex_tag_line(const char *line, size_t length, tag_t *tag);
+
+/**
+ * @brief Resolve a tag name to its identifier
  * 
- * @param line Line containing a tag
- * @return char* Newly allocated string containing the tag name (to be freed by the caller), NULL on error
+ * @param name Tag name (without @ prefix), not necessarily NUL-terminated
+ * @param length Length of the tag name
+ * @return tag_id_t The identifier of the tag, TAG_UNKNOWN if it is not a known tag
  */
-extern char *extract_tag_name(const char *line);
+tag_id_t tag_lookup(const char *name, size_t length);
 
 /**
- * @brief Extract tag content from a line
+ * @brief Get the name of a known tag
  * 
- * @param line Line containing a tag
- * @return char* Newly allocated string containing the tag content (to be freed by the caller), NULL on error
+ * @param id Identifier of the tag
+ * @return const char* The tag name (without @ prefix), NULL for TAG_UNKNOWN
  */
-extern char *extract_tag_content(const char *line);
+const char *tag_id_name(tag_id_t id);
 
 /**
  * @brief Process a tag and update a documentation block
@@ -56,11 +123,11 @@ bool process_tag(shellscribe_docblock_t *docblock, const char *tag, const char *
 /**
  * @brief Collect continued content from multi-line comments
  * 
- * @param file Input file
+ * @param state Parser state positioned on the first line of the comment
  * @param initial_content Initial content from the first line
  * @param config Configuration options
  * @return char* Newly allocated string containing the collected content (to be freed by the caller)
  */
-char *collect_continued_content(FILE *file, const char *initial_content, const shellscribe_config_t *config);
+char *collect_continued_content(parser_state_t *state, const char *initial_content, const shellscribe_config_t *config);
 
 #endif /* SHELLSCRIBE_PARSERS_TAG_H */ 
@@ -6,6 +6,8 @@
 #ifndef SHELLSCRIBE_PARSERS_COMMON_TYPES_H
 #define SHELLSCRIBE_PARSERS_COMMON_TYPES_H
 
+#include "utils/arena.h"
+#include "utils/vector.h"
 #include <stdio.h>
 #include <stdbool.h>
 
@@ -14,7 +16,7 @@
  */
 typedef struct {
     char *name;            // Name of the argument
-    char *type;            // Type of the argument
+    const char *type;      // Type of the argument (interned)
     char *description;     // Description of the argument
 } shellscribe_argument_t;
 
@@ -85,7 +87,7 @@ typedef struct {
  * @brief Structure representing an alert
  */
 typedef struct {
-    char *type;        // Alert type: NOTE, TIP, IMPORTANT, WARNING, CAUTION
+    const char *type;  // Alert type: NOTE, TIP, IMPORTANT, WARNING, CAUTION (interned)
     char *content;     // Alert content
 } shellscribe_alert_t;
 
@@ -111,15 +113,33 @@ typedef struct {
  * @brief Structure to store shellcheck directive details
  */
 typedef struct {
-    char *code;       /**< The shellcheck error code (e.g., SC2034) */
-    char *directive;  /**< The full shellcheck directive */
+    const char *code; /**< The shellcheck error code (e.g., SC2034), interned */
+    int code_number;  /**< The number of the code (e.g., 2034), 0 for named checks and whole directives */
     char *reason;     /**< The reason provided for the directive (if any) */
 } shellscribe_shellcheck_t;
 
+/**
+ * @brief Vectors of the list fields of a documentation block
+ */
+VECTOR_DECLARE(shellscribe_string_vector, const char *)
+VECTOR_DECLARE(shellscribe_argument_vector, shellscribe_argument_t)
+VECTOR_DECLARE(shellscribe_param_vector, shellscribe_param_t)
+VECTOR_DECLARE(shellscribe_return_vector, shellscribe_return_t)
+VECTOR_DECLARE(shellscribe_exitcode_vector, shellscribe_exitcode_t)
+VECTOR_DECLARE(shellscribe_option_vector, shellscribe_option_t)
+VECTOR_DECLARE(shellscribe_env_var_vector, shellscribe_env_var_t)
+VECTOR_DECLARE(shellscribe_see_also_vector, shellscribe_see_also_t)
+VECTOR_DECLARE(shellscribe_alert_vector, shellscribe_alert_t)
+VECTOR_DECLARE(shellscribe_global_var_vector, shellscribe_global_var_t)
+VECTOR_DECLARE(shellscribe_shellcheck_vector, shellscribe_shellcheck_t)
+
 /**
  * @brief Structure representing one documentation block
  */
 typedef struct {
+    // Arena holding the strings and arrays of the block (shared by the blocks of a file)
+    arena_t *arena;
+
     // Script metadata
     char *file_name;
     char *brief;
@@ -127,7 +147,7 @@ typedef struct {
     
     // Additional file metadata
     char *version;
-    char *author;
+    const char *author;
     char *author_contact;
     char *project;
     char *license;
@@ -145,17 +165,14 @@ typedef struct {
     shellscribe_section_t *section;
 
     // Arguments
-    shellscribe_argument_t *arguments;
-    int arg_count;
+    shellscribe_argument_vector_t arguments;
     bool no_args;           // Explicitly marked as taking no arguments
 
     // Parameters (alternative to arguments)
-    shellscribe_param_t *params;
-    int param_count;
+    shellscribe_param_vector_t params;
 
     // Return values
-    shellscribe_return_t *returns;
-    int return_count;
+    shellscribe_return_vector_t returns;
 
     // Inputs/outputs
     char *stdin_doc;
@@ -163,23 +180,19 @@ typedef struct {
     char *stderr_doc;
 
     // Return codes
-    shellscribe_exitcode_t *exitcodes;
-    int exitcode_count;
+    shellscribe_exitcode_vector_t exitcodes;
 
     // Options
-    shellscribe_option_t *options;
-    int option_count;
+    shellscribe_option_vector_t options;
 
     // Environment variables
-    shellscribe_env_var_t *env_vars;
-    int env_var_count;
+    shellscribe_env_var_vector_t env_vars;
 
     // Examples
     char *example;
 
     // References (see also)
-    shellscribe_see_also_t *see_also;
-    int see_also_count;
+    shellscribe_see_also_vector_t see_also;
 
     // Internal flags
     bool is_internal;
@@ -189,46 +202,46 @@ typedef struct {
     shellscribe_deprecation_t deprecation;
 
     // Alerts
-    int alert_count;
-    shellscribe_alert_t *alerts;
+    shellscribe_alert_vector_t alerts;
     
     // Warnings
-    char **warnings;
-    int warning_count;
+    shellscribe_string_vector_t warnings;
     
     // Dependencies
-    char **dependencies;
-    int dependency_count;
+    shellscribe_string_vector_t dependencies;
     
     // Internal calls
-    char **internal_calls;
-    int internal_call_count;
+    shellscribe_string_vector_t internal_calls;
     
     // Required dependencies (@requires)
-    char **requires;
-    int requires_count;
+    shellscribe_string_vector_t requires;
     
     // Functions using this function (@used-by)
-    char **used_by;
-    int used_by_count;
+    shellscribe_string_vector_t used_by;
     
     // External function calls (@calls)
-    char **calls;
-    int calls_count;
+    shellscribe_string_vector_t calls;
     
     // Services/features provided (@provides)
-    char **provides;
-    int provides_count;
+    shellscribe_string_vector_t provides;
     
     // Global variables set by the function
-    shellscribe_global_var_t *set_vars;
-    int set_var_count;
+    shellscribe_global_var_vector_t set_vars;
     
     // Shellcheck directives
-    shellscribe_shellcheck_t *shellcheck_directives;
-    int shellcheck_count;
+    shellscribe_shellcheck_vector_t shellcheck_directives;
 } shellscribe_docblock_t;
 
+/**
+ * @brief Growable array of documentation blocks
+ */
+typedef struct {
+    arena_t *arena;                 // Arena holding the blocks and their contents
+    shellscribe_docblock_t *blocks; // Blocks (the first one documents the file itself)
+    int count;                      // Number of blocks in use
+    int capacity;                   // Number of allocated blocks
+} shellscribe_docblock_list_t;
+
 /**
  * @brief Memory management functions for documentation blocks
  */
@@ -241,7 +254,7 @@ typedef struct {
 void init_docblock(shellscribe_docblock_t *docblock);
 
 /**
- * @brief Free memory associated with a documentation block
+ * @brief Reset a documentation block, leaving its contents to its arena
  * 
  * @param docblock Pointer to the documentation block to free
  */
@@ -250,9 +263,26 @@ void free_docblock(shellscribe_docblock_t *docblock);
 /**
  * @brief Free an array of documentation blocks
  * 
- * @param docblocks Array of documentation blocks
+ * @param docblocks Array of documentation blocks, allocated in the arena of its blocks
  * @param count Number of blocks in the array
+ * @note The arena of the blocks is reset, so the array itself is released too
  */
 void free_docblocks(shellscribe_docblock_t *docblocks, int count);
 
+/**
+ * @brief Append a new documentation block to a list
+ * 
+ * @param list List of documentation blocks (zero-initialized, with an arena, when empty)
+ * @return shellscribe_docblock_t* The new, initialized block, or NULL on allocation failure
+ * @note Growing the list moves its blocks, invalidating pointers to them
+ */
+shellscribe_docblock_t *append_docblock(shellscribe_docblock_list_t *list);
+
+/**
+ * @brief Free a list of documentation blocks and its array
+ * 
+ * @param list List of documentation blocks, left empty (its arena is reset, not destroyed)
+ */
+void free_docblock_list(shellscribe_docblock_list_t *list);
+
 #endif /* SHELLSCRIBE_PARSERS_COMMON_TYPES_H */ 
@@ -29,12 +29,13 @@ bool is_set_tag(const char *tag);
 /**
  * @brief Parse the set content to extract the variable name, type and description
  * 
+ * @param arena Arena allocating the extracted strings
  * @param content The set content to parse
  * @param name Output parameter for the extracted variable name
  * @param type Output parameter for the extracted variable type
  * @param description Output parameter for the extracted description
  * @return true if parsing was successful, false otherwise
  */
-bool parse_set_content(const char *content, char **name, char **type, char **description);
+bool parse_set_content(arena_t *arena, const char *content, char **name, char **type, char **description);
 
 #endif /* SHELLSCRIBE_VARIABLE_H */ 
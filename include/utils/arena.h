@@ -0,0 +1,105 @@
+/**
+ * @file arena.h
+ * @brief Arena allocator for shellscribe
+ *
+ * This module provides a bump allocator that serves allocations from large
+ * chunks of memory chained together. Allocations are never freed one by one:
+ * resetting the arena releases all of them at once, so that data whose
+ * lifetime is bound to a single task (e.g. the documentation blocks of a file)
+ * can be built without tracking each string and array it is made of.
+ */
+
+#ifndef SHELLSCRIBE_ARENA_H
+#define SHELLSCRIBE_ARENA_H
+
+#include <stddef.h>
+
+/**
+ * @brief Opaque arena handle
+ */
+typedef struct arena arena_t;
+
+/**
+ * @brief Create an empty arena
+ *
+ * @param chunk_size Size of the chunks allocated by the arena (0 for the default size)
+ * @return arena_t* The new arena, NULL on allocation failure
+ */
+arena_t *arena_create(size_t chunk_size);
+
+/**
+ * @brief Allocate memory from an arena
+ *
+ * @param arena The arena
+ * @param size Size of the allocation in bytes
+ * @return void* Pointer to the allocated memory (suitably aligned for any type), NULL on failure
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Allocate zero-initialized memory from an arena
+ *
+ * @param arena The arena
+ * @param count Number of elements
+ * @param size Size of each element in bytes
+ * @return void* Pointer to the allocated memory, NULL on failure
+ */
+void *arena_calloc(arena_t *arena, size_t count, size_t size);
+
+/**
+ * @brief Resize an allocation of an arena
+ *
+ * @param arena The arena
+ * @param ptr The allocation to resize (NULL to allocate)
+ * @param old_size Current size of the allocation in bytes
+ * @param new_size New size of the allocation in bytes
+ * @return void* Pointer to the resized allocation, NULL on failure (ptr is then left untouched)
+ * @note The last allocation of the arena is resized in place when its chunk has room
+ */
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Duplicate a string in an arena
+ *
+ * @param arena The arena
+ * @param str The string to duplicate
+ * @return char* The copy, NULL if str is NULL or on failure
+ */
+char *arena_strdup(arena_t *arena, const char *str);
+
+/**
+ * @brief Duplicate the beginning of a string in an arena
+ *
+ * @param arena The arena
+ * @param str The string to duplicate
+ * @param length Maximum number of characters to copy
+ * @return char* The NUL-terminated copy, NULL if str is NULL or on failure
+ */
+char *arena_strndup(arena_t *arena, const char *str, size_t length);
+
+/**
+ * @brief Concatenate two strings in an arena
+ *
+ * @param arena The arena
+ * @param str1 The first string
+ * @param str2 The second string
+ * @return char* The concatenation, NULL if a string is NULL or on failure
+ */
+char *arena_concat(arena_t *arena, const char *str1, const char *str2);
+
+/**
+ * @brief Release all the allocations of an arena
+ *
+ * @param arena The arena (can be NULL)
+ * @note The first chunk is kept to serve the allocations made after the reset
+ */
+void arena_reset(arena_t *arena);
+
+/**
+ * @brief Free an arena and all its allocations
+ *
+ * @param arena The arena (can be NULL)
+ */
+void arena_destroy(arena_t *arena);
+
+#endif /* SHELLSCRIBE_ARENA_H */
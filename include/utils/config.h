@@ -8,6 +8,11 @@
 
 #include <stdbool.h>
 
+/**
+ * @brief Upper bound accepted for the number of jobs (--jobs option or jobs key)
+ */
+#define MAX_JOBS 256
+
 /**
  * @brief Structure representing a markdown style
  */
@@ -120,6 +125,9 @@ typedef struct {
     
     // Behavior
     bool traverse_symlinks;
+    bool parallel_walk;          // Walk directories on several threads (one per job)
+    bool sort_files;             // Process files in path order, once the directory is walked
+    int jobs;                    // Number of worker threads (0 = online CPUs or cgroup quota)
     
     // Style configuration
     shellscribe_style_t style;
@@ -0,0 +1,63 @@
+/**
+ * @file dir_walker.h
+ * @brief Directory tree walkers for shellscribe
+ *
+ * This module finds the files of a directory tree whose name matches a
+ * predicate. The sequential walker visits files in directory order; the
+ * parallel walker reads directories on several threads and visits files in
+ * the order they are found.
+ */
+
+#ifndef SHELLSCRIBE_DIR_WALKER_H
+#define SHELLSCRIBE_DIR_WALKER_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Predicate selecting the files to visit, from their name only
+ *
+ * @param file_name The name of the file (without directory)
+ * @return bool True if the file must be visited
+ */
+typedef bool (*dir_walker_match_t)(const char *file_name);
+
+/**
+ * @brief Callback receiving each matching file
+ *
+ * Always invoked on the thread that started the walk.
+ *
+ * @param path The path of the file (only valid during the call)
+ * @param user_data Opaque pointer from the walker options
+ */
+typedef void (*dir_walker_visit_t)(const char *path, void *user_data);
+
+/**
+ * @brief Options of a directory walk
+ */
+typedef struct {
+    bool traverse_symlinks;         // Follow symbolic links to files and directories
+    dir_walker_match_t match;       // Predicate selecting the files to visit
+    dir_walker_visit_t visit;       // Callback receiving each matching file
+    void *user_data;                // Opaque pointer passed to the callback
+} dir_walker_options_t;
+
+/**
+ * @brief Walk a directory tree on the calling thread
+ *
+ * @param root The root of the directory tree
+ * @param options The walk options
+ * @return int The number of files visited
+ */
+int dir_walker_walk(const char *root, const dir_walker_options_t *options);
+
+/**
+ * @brief Walk a directory tree on several threads
+ *
+ * @param root The root of the directory tree
+ * @param threads The number of walker threads (1 or less walks sequentially)
+ * @param options The walk options
+ * @return int The number of files visited
+ */
+int dir_walker_walk_parallel(const char *root, int threads, const dir_walker_options_t *options);
+
+#endif /* SHELLSCRIBE_DIR_WALKER_H */
@@ -0,0 +1,39 @@
+/**
+ * @file hash.h
+ * @brief Non-cryptographic hashing for shellscribe
+ *
+ * This module provides the 64-bit FNV-1a hash shared by the hash tables and
+ * the incremental build manifest.
+ */
+
+#ifndef SHELLSCRIBE_HASH_H
+#define SHELLSCRIBE_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Initial value of an FNV-1a 64-bit hash
+ */
+#define HASH_FNV1A_OFFSET_BASIS 0xcbf29ce484222325ULL
+
+/**
+ * @brief Continue an FNV-1a hash over a block of memory
+ *
+ * @param hash The current hash value (HASH_FNV1A_OFFSET_BASIS to start a hash)
+ * @param data The data to hash
+ * @param length The length of the data
+ * @return uint64_t The updated hash value
+ */
+uint64_t hash_fnv1a_update(uint64_t hash, const void *data, size_t length);
+
+/**
+ * @brief Compute the FNV-1a hash of a block of memory
+ *
+ * @param data The data to hash
+ * @param length The length of the data
+ * @return uint64_t The hash value
+ */
+uint64_t hash_fnv1a(const void *data, size_t length);
+
+#endif /* SHELLSCRIBE_HASH_H */
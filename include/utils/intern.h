@@ -0,0 +1,43 @@
+/**
+ * @file intern.h
+ * @brief Thread-safe string interning for shellscribe
+ *
+ * This module keeps a single copy of each distinct string it is given and
+ * hands out a stable canonical pointer to it. Short strings that repeat all
+ * over a project (argument and alert types, required commands, shellcheck
+ * codes, authors) are stored once per run instead of once per occurrence, and
+ * two interned strings are equal if and only if their pointers are. The
+ * strings of a run are kept in a string set (see utils/string_set.h).
+ */
+
+#ifndef SHELLSCRIBE_INTERN_H
+#define SHELLSCRIBE_INTERN_H
+
+#include <stddef.h>
+
+/**
+ * @brief Intern a string in the table of the run
+ *
+ * @param str The string (can be NULL)
+ * @return const char* The canonical copy of the string, NULL if str is NULL or on failure
+ */
+const char *intern_string(const char *str);
+
+/**
+ * @brief Intern the beginning of a string in the table of the run
+ *
+ * @param str The string (can be NULL)
+ * @param length The length of the string
+ * @return const char* The canonical copy of the string, NULL if str is NULL or on failure
+ */
+const char *intern_string_length(const char *str, size_t length);
+
+/**
+ * @brief Free the table of the run
+ *
+ * @note Every string interned with intern_string is released: this must only
+ *       be called once the run is over
+ */
+void intern_cleanup(void);
+
+#endif /* SHELLSCRIBE_INTERN_H */
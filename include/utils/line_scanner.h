@@ -0,0 +1,117 @@
+/**
+ * @file line_scanner.h
+ * @brief Zero-copy line scanner for shellscribe
+ *
+ * This module splits a buffer holding a whole file into lines in place: line
+ * terminators are replaced by NUL characters, so that every line can be used
+ * as a C string pointing into the buffer, without copying it or measuring it
+ * again. Lines are then returned one at a time as spans, and can be looked
+ * at before being consumed. While the buffer is split, the first non-blank
+ * character of every line is located as well, so that the lines that are not
+ * comments can be told apart without reading them again.
+ */
+
+#ifndef SHELLSCRIBE_LINE_SCANNER_H
+#define SHELLSCRIBE_LINE_SCANNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Flags of a line, set while the buffer is split
+ */
+#define LINE_SPAN_COMMENT 0x1u  // The first non-blank character of the line is '#'
+#define LINE_SPAN_PAREN 0x2u    // The line contains an opening parenthesis
+
+/**
+ * @brief A line of a scanned buffer
+ */
+typedef struct {
+    char *start;                // First character of the line (NUL-terminated, without its newline)
+    size_t length;              // Length of the line
+    size_t indent;              // Offset of the first non-blank character (length if the line is blank)
+    unsigned int flags;         // LINE_SPAN_* flags of the line
+} line_span_t;
+
+/**
+ * @brief A line scanner
+ */
+typedef struct {
+    char *data;                 // Scanned buffer
+    size_t length;              // Length of the buffer (a NUL character follows it)
+    bool owns_data;             // Whether data was loaded by the scanner and must be freed
+    line_span_t *lines;         // Lines of the buffer
+    size_t line_count;          // Number of lines
+    size_t position;            // Index of the next line to return
+} line_scanner_t;
+
+/**
+ * @brief Initialize a scanner over a buffer
+ *
+ * @param scanner The scanner to initialize
+ * @param data The buffer, split into lines in place; data[length] must be writable
+ * @param length The length of the buffer
+ * @return bool True on success, false on allocation failure
+ */
+bool line_scanner_init(line_scanner_t *scanner, char *data, size_t length);
+
+/**
+ * @brief Initialize a scanner over the contents of a file
+ *
+ * @param scanner The scanner to initialize
+ * @param file_path The file to read
+ * @return bool True on success, false if the file cannot be read or on allocation failure
+ */
+bool line_scanner_load(line_scanner_t *scanner, const char *file_path);
+
+/**
+ * @brief Get the next line
+ *
+ * @param scanner The scanner
+ * @param line Filled with the next line
+ * @return bool True if a line was returned, false at the end of the buffer
+ */
+bool line_scanner_next(line_scanner_t *scanner, line_span_t *line);
+
+/**
+ * @brief Look at a line ahead without consuming it
+ *
+ * @param scanner The scanner
+ * @param ahead The number of lines to look past (0 for the next line)
+ * @param line Filled with the line
+ * @return bool True if the line exists, false past the end of the buffer
+ */
+bool line_scanner_peek(const line_scanner_t *scanner, size_t ahead, line_span_t *line);
+
+/**
+ * @brief Consume lines without returning them
+ *
+ * @param scanner The scanner
+ * @param count The number of lines to consume
+ */
+void line_scanner_skip(line_scanner_t *scanner, size_t count);
+
+/**
+ * @brief Get the position of the scanner
+ *
+ * @param scanner The scanner
+ * @return size_t The index of the next line to return
+ */
+size_t line_scanner_tell(const line_scanner_t *scanner);
+
+/**
+ * @brief Move the scanner to a position returned by line_scanner_tell()
+ *
+ * @param scanner The scanner
+ * @param position The index of the next line to return
+ */
+void line_scanner_seek(line_scanner_t *scanner, size_t position);
+
+/**
+ * @brief Release the resources of a scanner
+ *
+ * @param scanner The scanner
+ */
+void line_scanner_free(line_scanner_t *scanner);
+
+#endif /* SHELLSCRIBE_LINE_SCANNER_H */
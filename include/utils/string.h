@@ -6,8 +6,25 @@
 #ifndef SHELLSCRIBE_UTILS_STRING_UTILS_H
 #define SHELLSCRIBE_UTILS_STRING_UTILS_H
 
+#include "utils/arena.h"
+#include <stdbool.h>
 #include <stddef.h>
 
+/**
+ * @brief Growable string, built by appending to it
+ */
+typedef struct {
+    arena_t *arena;             // Arena allocating the string (NULL to allocate it on the heap)
+    char *data;                 // String built so far, NUL-terminated (NULL until the first append)
+    size_t length;              // Length of the string
+    size_t capacity;            // Size of the allocation of the string
+} string_builder_t;
+
+/**
+ * @brief Opaque compiled regular expression handle
+ */
+typedef struct string_regex string_regex_t;
+
 /**
  * @brief Duplicates a string
  * 
@@ -73,4 +90,100 @@ int string_matches_regex(const char *str, const char *pattern);
 int string_extract_regex(const char *str, const char *pattern, 
                         char **matches, int max_matches);
 
+/**
+ * @brief Compiles a regular expression once for repeated matching
+ * 
+ * @param pattern Regular expression
+ * @param flags Compilation flags of regcomp (e.g., REG_EXTENDED)
+ * @return string_regex_t* Compiled expression (must be freed with string_regex_free), or NULL on error
+ */
+string_regex_t *string_regex_compile(const char *pattern, int flags);
+
+/**
+ * @brief Checks if a string matches a compiled regular expression
+ * 
+ * @param regex Compiled expression
+ * @param str String to check
+ * @return int 1 if the string matches, 0 otherwise, -1 on error
+ * @note A compiled expression can be matched by several threads at once
+ */
+int string_regex_match(const string_regex_t *regex, const char *str);
+
+/**
+ * @brief Extracts groups matching a compiled regular expression
+ * 
+ * @param regex Compiled expression with capture groups
+ * @param str Source string
+ * @param matches Array of strings to store matches (must be freed by the caller)
+ * @param max_matches Maximum number of matches
+ * @return int Number of matches found, or -1 on error
+ */
+int string_regex_extract(const string_regex_t *regex, const char *str,
+                         char **matches, int max_matches);
+
+/**
+ * @brief Frees a compiled regular expression
+ * 
+ * @param regex Compiled expression (can be NULL)
+ */
+void string_regex_free(string_regex_t *regex);
+
+/**
+ * @brief Frees the expressions cached by string_matches_regex and string_extract_regex
+ * 
+ * @note Must only be called once no other thread matches strings anymore
+ */
+void string_regex_cleanup(void);
+
+/**
+ * @brief Initializes an empty string builder
+ * 
+ * @param builder String builder to initialize
+ * @param arena Arena allocating the string, or NULL to allocate it on the heap
+ */
+void string_builder_init(string_builder_t *builder, arena_t *arena);
+
+/**
+ * @brief Makes room in a string builder for characters to be appended
+ * 
+ * @param builder String builder
+ * @param length Number of characters that will be appended
+ * @return bool true on success, false on allocation failure
+ */
+bool string_builder_reserve(string_builder_t *builder, size_t length);
+
+/**
+ * @brief Appends the beginning of a string to a string builder
+ * 
+ * @param builder String builder
+ * @param str String to append
+ * @param length Number of characters to append (str must hold at least that many)
+ * @return bool true on success, false on allocation failure
+ */
+bool string_builder_append_length(string_builder_t *builder, const char *str, size_t length);
+
+/**
+ * @brief Appends a string to a string builder
+ * 
+ * @param builder String builder
+ * @param str String to append
+ * @return bool true on success, false on allocation failure
+ */
+bool string_builder_append(string_builder_t *builder, const char *str);
+
+/**
+ * @brief Takes the string out of a string builder, leaving the builder empty
+ * 
+ * @param builder String builder
+ * @return char* The string (to be freed by the caller unless it was allocated in an arena), or NULL on allocation failure
+ */
+char *string_builder_finish(string_builder_t *builder);
+
+/**
+ * @brief Releases the string of a string builder, leaving the builder empty
+ * 
+ * @param builder String builder
+ */
+void string_builder_free(string_builder_t *builder);
+
 #endif /* SHELLSCRIBE_UTILS_STRING_UTILS_H */
@@ -0,0 +1,67 @@
+/**
+ * @file string_set.h
+ * @brief Thread-safe set of strings for shellscribe
+ *
+ * This module keeps a set of strings that can be queried and extended by
+ * several threads at once. Each string is stored once, and the stored copy
+ * serves as the canonical pointer of the string.
+ */
+
+#ifndef SHELLSCRIBE_STRING_SET_H
+#define SHELLSCRIBE_STRING_SET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Opaque string set handle
+ */
+typedef struct string_set string_set_t;
+
+/**
+ * @brief Create an empty string set
+ *
+ * @return string_set_t* The new set, NULL on allocation failure
+ */
+string_set_t *string_set_create(void);
+
+/**
+ * @brief Check whether a string is in a set
+ *
+ * @param set The set (can be NULL)
+ * @param str The string
+ * @param length The length of the string
+ * @return bool True if the string is in the set
+ */
+bool string_set_contains(string_set_t *set, const char *str, size_t length);
+
+/**
+ * @brief Add a string to a set
+ *
+ * @param set The set (can be NULL)
+ * @param str The string
+ * @param length The length of the string
+ * @return bool True if the string is in the set, false on allocation failure
+ */
+bool string_set_add(string_set_t *set, const char *str, size_t length);
+
+/**
+ * @brief Add a string to a set and get its stored copy
+ *
+ * @param set The set (can be NULL)
+ * @param str The string (need not be NUL-terminated)
+ * @param length The length of the string
+ * @return const char* The copy of the string stored in the set, NULL on allocation failure
+ * @note The stored copy lives until the set is freed, and every call with the
+ *       same string returns the same pointer
+ */
+const char *string_set_intern(string_set_t *set, const char *str, size_t length);
+
+/**
+ * @brief Free a string set
+ *
+ * @param set The set (can be NULL)
+ */
+void string_set_free(string_set_t *set);
+
+#endif /* SHELLSCRIBE_STRING_SET_H */
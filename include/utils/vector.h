@@ -0,0 +1,88 @@
+/**
+ * @file vector.h
+ * @brief Typed growable arrays for shellscribe
+ *
+ * This module provides arrays that track their capacity and grow
+ * geometrically, so that appending to them costs amortized constant time. A
+ * vector type is generated per element type: VECTOR_DECLARE(name, type)
+ * declares the type name_t and its functions, and VECTOR_DEFINE(name, type)
+ * defines the functions, in a single source file. Elements are allocated in
+ * an arena when one is given, and on the heap otherwise. A zero-initialized
+ * vector is empty and ready to use.
+ */
+
+#ifndef SHELLSCRIBE_VECTOR_H
+#define SHELLSCRIBE_VECTOR_H
+
+#include "utils/arena.h"
+#include "utils/memory.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Make room for elements in a vector of any type
+ *
+ * @param items Pointer to the elements of the vector
+ * @param capacity Pointer to the number of allocated elements
+ * @param count Number of elements in use
+ * @param needed Number of elements the vector must be able to hold
+ * @param element_size Size of an element in bytes
+ * @param arena Arena allocating the elements (NULL for the heap)
+ * @return bool True on success, false on allocation failure (the vector is then left untouched)
+ */
+bool vector_reserve(void **items, int *capacity, int count, int needed, size_t element_size, arena_t *arena);
+
+/**
+ * @brief Declare a vector type and its functions
+ *
+ * @param name Name of the vector (the type is name_t)
+ * @param type Type of the elements
+ */
+#define VECTOR_DECLARE(name, type)                                              \
+    typedef struct {                                                            \
+        type *items;            /* Elements of the vector */                    \
+        int count;              /* Number of elements in use */                 \
+        int capacity;           /* Number of allocated elements */              \
+    } name##_t;                                                                 \
+                                                                                \
+    /* Make room for count elements (false on allocation failure) */            \
+    bool name##_reserve(name##_t *vector, arena_t *arena, int count);           \
+                                                                                \
+    /* Append a zeroed element and return it (NULL on allocation failure) */    \
+    type *name##_push(name##_t *vector, arena_t *arena);                        \
+                                                                                \
+    /* Free the elements of a heap vector, and empty the vector */              \
+    void name##_release(name##_t *vector, arena_t *arena);
+
+/**
+ * @brief Define the functions of a vector type declared with VECTOR_DECLARE
+ *
+ * @param name Name of the vector
+ * @param type Type of the elements
+ */
+#define VECTOR_DEFINE(name, type)                                               \
+    bool name##_reserve(name##_t *vector, arena_t *arena, int count) {          \
+        return vector_reserve((void **)&vector->items, &vector->capacity,       \
+            vector->count, count, sizeof(type), arena);                         \
+    }                                                                           \
+                                                                                \
+    type *name##_push(name##_t *vector, arena_t *arena) {                       \
+        if (!name##_reserve(vector, arena, vector->count + 1)) {                \
+            return NULL;                                                        \
+        }                                                                       \
+        type *item = &vector->items[vector->count++];                           \
+        memset(item, 0, sizeof(type));                                          \
+        return item;                                                            \
+    }                                                                           \
+                                                                                \
+    void name##_release(name##_t *vector, arena_t *arena) {                     \
+        if (arena == NULL) {                                                    \
+            shell_free((void **)&vector->items);                                \
+        }                                                                       \
+        vector->items = NULL;                                                   \
+        vector->count = 0;                                                      \
+        vector->capacity = 0;                                                   \
+    }
+
+#endif /* SHELLSCRIBE_VECTOR_H */
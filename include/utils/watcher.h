@@ -0,0 +1,81 @@
+/**
+ * @file watcher.h
+ * @brief Recursive directory change watcher for shellscribe
+ *
+ * This module watches a directory tree with inotify and collects the paths
+ * of the files and directories that are modified, created, moved or deleted.
+ * Directories created inside the tree are watched automatically, except for
+ * excluded ones, such as the directory the watching program writes to.
+ */
+
+#ifndef SHELLSCRIBE_WATCHER_H
+#define SHELLSCRIBE_WATCHER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Opaque watcher handle
+ */
+typedef struct watcher watcher_t;
+
+/**
+ * @brief Create a watcher
+ *
+ * @return watcher_t* The new watcher, NULL if inotify is unavailable or on allocation failure
+ */
+watcher_t *watcher_create(void);
+
+/**
+ * @brief Exclude a directory and its subdirectories from the watched trees
+ *
+ * @param watcher The watcher
+ * @param dir_path The directory (need not exist yet)
+ * @return bool True on success, false on allocation failure
+ * @note Must be called before the trees holding the directory are added
+ */
+bool watcher_exclude(watcher_t *watcher, const char *dir_path);
+
+/**
+ * @brief Watch a directory and all its subdirectories
+ *
+ * @param watcher The watcher
+ * @param dir_path The root of the directory tree
+ * @return bool True if the root directory is watched
+ */
+bool watcher_add_tree(watcher_t *watcher, const char *dir_path);
+
+/**
+ * @brief Wait for changes in the watched trees
+ *
+ * @param watcher The watcher
+ * @param timeout_ms Maximum time to wait in milliseconds (-1 to wait indefinitely)
+ * @return int Number of changes collected, 0 on timeout, -1 on error or interruption
+ */
+int watcher_poll(watcher_t *watcher, int timeout_ms);
+
+/**
+ * @brief Take the paths changed since the last call
+ *
+ * @param watcher The watcher
+ * @param count Pointer to store the number of paths
+ * @return char** Sorted array of unique paths (to be freed with watcher_free_changes()), NULL if none
+ */
+char **watcher_take_changes(watcher_t *watcher, size_t *count);
+
+/**
+ * @brief Free an array returned by watcher_take_changes()
+ *
+ * @param paths The paths (can be NULL)
+ * @param count The number of paths
+ */
+void watcher_free_changes(char **paths, size_t count);
+
+/**
+ * @brief Free a watcher
+ *
+ * @param watcher The watcher (can be NULL)
+ */
+void watcher_free(watcher_t *watcher);
+
+#endif /* SHELLSCRIBE_WATCHER_H */
@@ -0,0 +1,82 @@
+/**
+ * @file worker_pool.h
+ * @brief Fixed-size worker thread pool for shellscribe
+ *
+ * This module runs a stream of independent items on a pool of worker threads
+ * while reporting their completion to the submitting thread in submission
+ * order, so that console output stays deterministic regardless of scheduling.
+ * The number of items in flight is bounded, so that memory usage does not
+ * depend on how many items are submitted.
+ */
+
+#ifndef SHELLSCRIBE_WORKER_POOL_H
+#define SHELLSCRIBE_WORKER_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Opaque worker pool handle
+ */
+typedef struct worker_pool worker_pool_t;
+
+/**
+ * @brief Task callback executed on a worker thread
+ *
+ * @param item Item submitted with worker_pool_submit()
+ * @param user_data Opaque pointer passed to worker_pool_create()
+ */
+typedef void (*worker_pool_task_t)(void *item, void *user_data);
+
+/**
+ * @brief Completion callback executed on the submitting thread
+ *
+ * Completion callbacks are invoked strictly in submission order, once the
+ * item (and every item submitted before it) has been processed.
+ *
+ * @param item Item submitted with worker_pool_submit()
+ * @param user_data Opaque pointer passed to worker_pool_create()
+ */
+typedef void (*worker_pool_done_t)(void *item, void *user_data);
+
+/**
+ * @brief Determine the default number of worker threads
+ *
+ * Uses the number of online CPUs, restricted by the process CPU affinity
+ * mask and by the cgroup CPU quota when one is configured.
+ *
+ * @return int Number of worker threads to use (always at least 1)
+ */
+int worker_pool_default_jobs(void);
+
+/**
+ * @brief Create a worker pool
+ *
+ * @param jobs Number of worker threads to use (1 or less runs sequentially)
+ * @param capacity Maximum number of items in flight before worker_pool_submit() blocks
+ * @param task Callback executed for each item on a worker thread
+ * @param done Callback executed in submission order on the submitting thread (can be NULL)
+ * @param user_data Opaque pointer passed to both callbacks
+ * @return worker_pool_t* The new pool, NULL on invalid parameters or allocation failure
+ */
+worker_pool_t *worker_pool_create(int jobs, size_t capacity, worker_pool_task_t task, worker_pool_done_t done, void *user_data);
+
+/**
+ * @brief Submit an item to a worker pool
+ *
+ * Blocks while the pool is full, reporting completed items in the meantime.
+ *
+ * @param pool The worker pool
+ * @param item The item to process
+ * @return bool True if the item was accepted
+ */
+bool worker_pool_submit(worker_pool_t *pool, void *item);
+
+/**
+ * @brief Wait for every submitted item, report them and destroy a worker pool
+ *
+ * @param pool The worker pool (can be NULL)
+ */
+void worker_pool_finish(worker_pool_t *pool);
+
+#endif /* SHELLSCRIBE_WORKER_POOL_H */
@@ -0,0 +1,562 @@
+/**
+ * @file manifest.c
+ * @brief Implementation of the incremental build manifest
+ *
+ * The manifest is a text file with one line per documented script. Each line
+ * holds tab-separated fields: the size, modification time and content hash of
+ * the script, the fingerprint of the configuration used to document it, the
+ * path of the script and the path of its documentation. Scripts whose entry
+ * still matches are not parsed again, and the documentation of scripts that
+ * no longer exist is removed when the manifest is saved.
+ */
+
+#include "core/manifest.h"
+#include "core/shellscribe.h"
+#include "utils/hash.h"
+#include "utils/memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <limits.h>
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+#ifndef SHELLSCRIBE_VERSION
+#define SHELLSCRIBE_VERSION "1.0.0"
+#endif
+
+/**
+ * @brief First line of a manifest file, identifying its format
+ */
+#define MANIFEST_HEADER "# shellscribe manifest v1"
+
+/**
+ * @brief A manifest entry
+ */
+typedef struct {
+    char *source_path;              // Path of the script
+    char *output_path;              // Path of the generated documentation
+    manifest_stamp_t stamp;         // State of the script when it was documented
+    uint64_t config_fingerprint;    // Fingerprint of the configuration used
+    bool seen;                      // Set once the script is processed by the current run
+    bool removed;                   // Set when the script no longer exists
+} manifest_entry_t;
+
+/**
+ * @brief A manifest
+ */
+struct manifest {
+    char *file_path;                // Path of the manifest file
+    char *doc_path;                 // Documentation directory
+    uint64_t config_fingerprint;    // Fingerprint of the current configuration
+    bool exists;                    // Whether a manifest file was loaded
+    manifest_entry_t *entries;      // Entries loaded from the manifest file
+    size_t entry_count;             // Number of loaded entries
+    size_t *index;                  // Open addressing index of the loaded entries (entry + 1, 0 if empty)
+    size_t index_size;              // Number of slots in the index (power of two)
+    manifest_entry_t *records;      // Entries recorded by the current run
+    size_t record_count;            // Number of recorded entries
+    size_t record_capacity;         // Allocated number of recorded entries
+    bool dirty;                     // Whether the manifest file must be written again
+};
+
+/**
+ * @brief Continue an FNV-1a hash over a string
+ *
+ * The terminator is included so that consecutive strings cannot collide by
+ * moving characters from one to the other; NULL hashes differently from "".
+ *
+ * @param hash The current hash value
+ * @param str The string to hash (can be NULL)
+ * @return uint64_t The updated hash value
+ */
+static uint64_t fnv1a_string(uint64_t hash, const char *str) {
+    if (str == NULL) {
+        return hash_fnv1a_update(hash, "\xff", 1);
+    }
+    return hash_fnv1a_update(hash, str, strlen(str) + 1);
+}
+
+/**
+ * @brief Compute the fingerprint of the configuration settings affecting the output
+ *
+ * @param config The configuration
+ * @return uint64_t The fingerprint
+ */
+static uint64_t compute_config_fingerprint(const shellscribe_config_t *config) {
+    uint64_t hash = fnv1a_string(HASH_FNV1A_OFFSET_BASIS, SHELLSCRIBE_VERSION);
+    const char *strings[] = {
+        config->output_file, config->doc_filename, config->format,
+        config->footer_text, config->version_placement, config->copyright_placement,
+        config->license_placement, config->example_display, config->highlight_language,
+        config->arguments_display, config->shellcheck_display
+    };
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+        hash = fnv1a_string(hash, strings[i]);
+    }
+    const bool flags[] = {
+        config->generate_index, config->linkify_usernames, config->highlight_code,
+        config->show_toc, config->show_alerts, config->show_shellcheck
+    };
+    hash = hash_fnv1a_update(hash, flags, sizeof(flags));
+    const char *const *style = (const char *const *)&config->style;
+    for (size_t i = 0; i < sizeof(config->style) / sizeof(char *); i++) {
+        hash = fnv1a_string(hash, style[i]);
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Compute the content hash of a file
+ *
+ * @param data The contents of the file
+ * @param length The length of the contents
+ * @return uint64_t The hash of the contents (never 0)
+ */
+uint64_t manifest_hash(const char *data, size_t length) {
+    uint64_t hash = hash_fnv1a(data, length);
+    return (hash == 0) ? 1 : hash;
+}
+
+/**
+ * @brief Fill a stamp from the status of a file
+ *
+ * @param stamp The stamp to fill (its hash is reset)
+ * @param st The status of the file
+ */
+void manifest_stamp_from_stat(manifest_stamp_t *stamp, const struct stat *st) {
+    stamp->size = (uint64_t)st->st_size;
+    stamp->mtime_sec = (int64_t)st->st_mtim.tv_sec;
+    stamp->mtime_nsec = st->st_mtim.tv_nsec;
+    stamp->hash = 0;
+}
+
+/**
+ * @brief Find the loaded entry of a script
+ *
+ * @param manifest The manifest
+ * @param source_path The script
+ * @return manifest_entry_t* The entry, or NULL if the script is not in the manifest
+ */
+static manifest_entry_t *find_entry(const manifest_t *manifest, const char *source_path) {
+    if (manifest->index_size == 0) {
+        return NULL;
+    }
+    size_t mask = manifest->index_size - 1;
+    size_t slot = (size_t)fnv1a_string(HASH_FNV1A_OFFSET_BASIS, source_path) & mask;
+    while (manifest->index[slot] != 0) {
+        manifest_entry_t *entry = &manifest->entries[manifest->index[slot] - 1];
+        if (strcmp(entry->source_path, source_path) == 0) {
+            return entry;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Build the lookup index of the loaded entries
+ *
+ * @param manifest The manifest
+ * @return bool True on success, false on allocation failure
+ */
+static bool build_index(manifest_t *manifest) {
+    size_t size = 16;
+    while (size < manifest->entry_count * 2) {
+        size *= 2;
+    }
+    manifest->index = (size_t *)shell_calloc(size, sizeof(size_t));
+    if (manifest->index == NULL) {
+        return false;
+    }
+    manifest->index_size = size;
+    for (size_t i = 0; i < manifest->entry_count; i++) {
+        size_t slot = (size_t)fnv1a_string(HASH_FNV1A_OFFSET_BASIS, manifest->entries[i].source_path) & (size - 1);
+        while (manifest->index[slot] != 0) {
+            slot = (slot + 1) & (size - 1);
+        }
+        manifest->index[slot] = i + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Append an entry to an entry array
+ *
+ * @param entries The entry array
+ * @param count The number of entries in the array
+ * @param capacity The allocated number of entries
+ * @param entry The entry to append; the array takes ownership of its strings
+ * @return bool True on success, false on allocation failure
+ */
+static bool append_entry(manifest_entry_t **entries, size_t *count, size_t *capacity, const manifest_entry_t *entry) {
+    if (*count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 64 : *capacity * 2;
+        manifest_entry_t *new_entries = (manifest_entry_t *)shell_realloc(*entries, new_capacity * sizeof(manifest_entry_t));
+        if (new_entries == NULL) {
+            return false;
+        }
+        *entries = new_entries;
+        *capacity = new_capacity;
+    }
+    (*entries)[(*count)++] = *entry;
+    return true;
+}
+
+/**
+ * @brief Parse one line of a manifest file
+ *
+ * @param line The line to parse (modified in place)
+ * @param entry The entry to fill; its strings are newly allocated
+ * @return bool True if the line holds a valid entry
+ */
+static bool parse_entry(char *line, manifest_entry_t *entry) {
+    char *end = NULL;
+    memset(entry, 0, sizeof(*entry));
+    entry->stamp.size = strtoull(line, &end, 10);
+    if (*end != '\t') {
+        return false;
+    }
+    entry->stamp.mtime_sec = strtoll(end + 1, &end, 10);
+    if (*end != '\t') {
+        return false;
+    }
+    entry->stamp.mtime_nsec = strtol(end + 1, &end, 10);
+    if (*end != '\t') {
+        return false;
+    }
+    entry->stamp.hash = strtoull(end + 1, &end, 16);
+    if (*end != '\t') {
+        return false;
+    }
+    entry->config_fingerprint = strtoull(end + 1, &end, 16);
+    if (*end != '\t') {
+        return false;
+    }
+    char *source_path = end + 1;
+    char *output_path = strchr(source_path, '\t');
+    if (output_path == NULL || output_path == source_path || output_path[1] == '\0') {
+        return false;
+    }
+    *output_path++ = '\0';
+    entry->source_path = shell_strdup(source_path);
+    entry->output_path = shell_strdup(output_path);
+    if (entry->source_path == NULL || entry->output_path == NULL) {
+        shell_free((void **)&entry->source_path);
+        shell_free((void **)&entry->output_path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Load the manifest of a documentation directory
+ *
+ * A missing, unreadable or incompatible manifest file yields an empty
+ * manifest, so that every script is documented again.
+ *
+ * @param doc_path The documentation directory
+ * @param config The configuration (used to compute the configuration fingerprint)
+ * @return manifest_t* The manifest, NULL on allocation failure
+ */
+manifest_t *manifest_load(const char *doc_path, const shellscribe_config_t *config) {
+    if (doc_path == NULL || config == NULL) {
+        return NULL;
+    }
+    manifest_t *manifest = (manifest_t *)shell_calloc(1, sizeof(manifest_t));
+    if (manifest == NULL) {
+        return NULL;
+    }
+    char file_path[PATH_MAX];
+    snprintf(file_path, sizeof(file_path), "%s/%s", doc_path, MANIFEST_FILENAME);
+    manifest->file_path = shell_strdup(file_path);
+    manifest->doc_path = shell_strdup(doc_path);
+    if (manifest->file_path == NULL || manifest->doc_path == NULL) {
+        manifest_free(manifest);
+        return NULL;
+    }
+    manifest->config_fingerprint = compute_config_fingerprint(config);
+    shellscribe_source_t source;
+    if (!load_shell_script(manifest->file_path, &source)) {
+        return manifest;
+    }
+    manifest->exists = true;
+    size_t capacity = 0;
+    char *saveptr = NULL;
+    char *line = strtok_r(source.data, "\n", &saveptr);
+    if (line != NULL && strcmp(line, MANIFEST_HEADER) == 0) {
+        while ((line = strtok_r(NULL, "\n", &saveptr)) != NULL) {
+            manifest_entry_t entry;
+            if (!parse_entry(line, &entry)) {
+                continue;
+            }
+            if (!append_entry(&manifest->entries, &manifest->entry_count, &capacity, &entry)) {
+                shell_free((void **)&entry.source_path);
+                shell_free((void **)&entry.output_path);
+                break;
+            }
+        }
+    }
+    free_shell_script(&source);
+    if (!build_index(manifest)) {
+        manifest_free(manifest);
+        return NULL;
+    }
+
+    return manifest;
+}
+
+/**
+ * @brief Check whether the documentation of a script is up to date
+ *
+ * The documentation is up to date if the script has an entry generated with
+ * the same configuration and output path, if the documentation file still
+ * exists, and if the script has the same size and either the same content
+ * hash (when stamp->hash is set) or the same modification time.
+ *
+ * @param manifest The manifest
+ * @param source_path The script
+ * @param output_path The expected documentation file of the script
+ * @param stamp The current state of the script
+ * @return bool True if the documentation does not need to be regenerated
+ */
+bool manifest_is_current(const manifest_t *manifest, const char *source_path, const char *output_path, const manifest_stamp_t *stamp) {
+    if (manifest == NULL || source_path == NULL || output_path == NULL || stamp == NULL) {
+        return false;
+    }
+    const manifest_entry_t *entry = find_entry(manifest, source_path);
+    if (entry == NULL || entry->config_fingerprint != manifest->config_fingerprint ||
+        entry->stamp.size != stamp->size || strcmp(entry->output_path, output_path) != 0) {
+        return false;
+    }
+    if (stamp->hash != 0) {
+        if (entry->stamp.hash != stamp->hash) {
+            return false;
+        }
+    } else if (entry->stamp.mtime_sec != stamp->mtime_sec || entry->stamp.mtime_nsec != stamp->mtime_nsec) {
+        return false;
+    }
+    struct stat st;
+
+    return (stat(output_path, &st) == 0 && S_ISREG(st.st_mode));
+}
+
+/**
+ * @brief Check whether a recorded entry matches the loaded entry of its script
+ *
+ * @param previous The loaded entry (can be NULL)
+ * @param entry The recorded entry
+ * @return bool True if writing the recorded entry would not change the manifest
+ */
+static bool is_same_entry(const manifest_entry_t *previous, const manifest_entry_t *entry) {
+    return previous != NULL &&
+           previous->stamp.size == entry->stamp.size &&
+           previous->stamp.mtime_sec == entry->stamp.mtime_sec &&
+           previous->stamp.mtime_nsec == entry->stamp.mtime_nsec &&
+           previous->stamp.hash == entry->stamp.hash &&
+           previous->config_fingerprint == entry->config_fingerprint &&
+           previous->output_path != NULL && entry->output_path != NULL &&
+           strcmp(previous->output_path, entry->output_path) == 0;
+}
+
+/**
+ * @brief Record the outcome of the processing of a script
+ *
+ * Marks the script as present. If documentation was generated, the script is
+ * recorded in the manifest with its current state; otherwise it is dropped
+ * from the manifest, but its previous documentation is left in place.
+ *
+ * @param manifest The manifest
+ * @param source_path The script
+ * @param output_path The documentation file of the script, NULL if none was generated
+ * @param stamp The state of the script (ignored if output_path is NULL)
+ *
+ * @note If stamp has no hash, the hash of the previous entry is kept
+ * @note Scripts whose paths contain tabs or newlines are never recorded
+ */
+void manifest_record(manifest_t *manifest, const char *source_path, const char *output_path, const manifest_stamp_t *stamp) {
+    if (manifest == NULL || source_path == NULL) {
+        return;
+    }
+    manifest_entry_t *previous = find_entry(manifest, source_path);
+    if (previous != NULL) {
+        previous->seen = true;
+    }
+    if (output_path == NULL || stamp == NULL ||
+        strpbrk(source_path, "\t\n") != NULL || strpbrk(output_path, "\t\n") != NULL) {
+        if (previous != NULL) {
+            manifest->dirty = true;
+        }
+        return;
+    }
+    manifest_entry_t entry = {
+        .source_path = shell_strdup(source_path),
+        .output_path = shell_strdup(output_path),
+        .stamp = *stamp,
+        .config_fingerprint = manifest->config_fingerprint,
+        .seen = true
+    };
+    if (entry.stamp.hash == 0 && previous != NULL) {
+        entry.stamp.hash = previous->stamp.hash;
+    }
+    if (!is_same_entry(previous, &entry)) {
+        manifest->dirty = true;
+    }
+    if (entry.source_path == NULL || entry.output_path == NULL ||
+        !append_entry(&manifest->records, &manifest->record_count, &manifest->record_capacity, &entry)) {
+        shell_free((void **)&entry.source_path);
+        shell_free((void **)&entry.output_path);
+    }
+}
+
+/**
+ * @brief Write an entry to a manifest file
+ *
+ * @param file The manifest file
+ * @param entry The entry to write
+ */
+static void write_entry(FILE *file, const manifest_entry_t *entry) {
+    fprintf(file, "%" PRIu64 "\t%" PRId64 "\t%ld\t%016" PRIx64 "\t%016" PRIx64 "\t%s\t%s\n",
+            entry->stamp.size, entry->stamp.mtime_sec, entry->stamp.mtime_nsec,
+            entry->stamp.hash, entry->config_fingerprint, entry->source_path, entry->output_path);
+}
+
+/**
+ * @brief Check whether a documentation file was generated by the current run
+ *
+ * @param manifest The manifest
+ * @param output_path The documentation file
+ * @return bool True if a recorded entry uses this documentation file
+ */
+static bool is_recorded_output(const manifest_t *manifest, const char *output_path) {
+    for (size_t i = 0; i < manifest->record_count; i++) {
+        if (strcmp(manifest->records[i].output_path, output_path) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Remove a documentation file and its empty parent directories
+ *
+ * Parent directories are removed up to, but not including, the documentation
+ * directory.
+ *
+ * @param manifest The manifest
+ * @param output_path The documentation file
+ * @return bool True if the documentation file was removed
+ */
+static bool prune_output(const manifest_t *manifest, const char *output_path) {
+    if (unlink(output_path) != 0) {
+        return false;
+    }
+    char dir_path[PATH_MAX];
+    snprintf(dir_path, sizeof(dir_path), "%s", output_path);
+    size_t doc_path_len = strlen(manifest->doc_path);
+    char *last_slash = strrchr(dir_path, '/');
+    while (last_slash != NULL && (size_t)(last_slash - dir_path) > doc_path_len) {
+        *last_slash = '\0';
+        if (rmdir(dir_path) != 0) {
+            break;
+        }
+        last_slash = strrchr(dir_path, '/');
+    }
+    return true;
+}
+
+/**
+ * @brief Prune stale documentation and save the manifest
+ *
+ * Loaded entries whose script was processed by the current run are replaced
+ * by the recorded entries. Entries of scripts that were not processed are kept
+ * if the script still exists; otherwise their documentation is removed. The
+ * manifest file is written to a temporary file and renamed into place, but
+ * only if an entry changed or was removed, so that runs with nothing to do
+ * leave the documentation directory untouched.
+ *
+ * @param manifest The manifest
+ * @return int Number of documentation files pruned, -1 if the manifest could not be saved
+ */
+int manifest_save(manifest_t *manifest) {
+    if (manifest == NULL) {
+        return -1;
+    }
+    int pruned = 0;
+    for (size_t i = 0; i < manifest->entry_count; i++) {
+        manifest_entry_t *entry = &manifest->entries[i];
+        struct stat st;
+        if (entry->seen || stat(entry->source_path, &st) == 0) {
+            continue;
+        }
+        entry->removed = true;
+        manifest->dirty = true;
+        if (!is_recorded_output(manifest, entry->output_path) && prune_output(manifest, entry->output_path)) {
+            pruned++;
+        }
+    }
+    if (!manifest->dirty) {
+        return pruned;
+    }
+    char temp_path[PATH_MAX];
+    if (!make_temp_path(manifest->file_path, temp_path, sizeof(temp_path))) {
+        return -1;
+    }
+    FILE *file = fopen(temp_path, "wx");
+    if (file == NULL) {
+        return -1;
+    }
+    fprintf(file, "%s\n", MANIFEST_HEADER);
+    for (size_t i = 0; i < manifest->record_count; i++) {
+        write_entry(file, &manifest->records[i]);
+    }
+    for (size_t i = 0; i < manifest->entry_count; i++) {
+        const manifest_entry_t *entry = &manifest->entries[i];
+        if (!entry->seen && !entry->removed) {
+            write_entry(file, entry);
+        }
+    }
+    if (fclose(file) != 0 || rename(temp_path, manifest->file_path) != 0) {
+        unlink(temp_path);
+        return -1;
+    }
+    manifest->dirty = false;
+
+    return pruned;
+}
+
+/**
+ * @brief Free the strings of an entry array and the array itself
+ *
+ * @param entries The entry array
+ * @param count The number of entries
+ */
+static void free_entries(manifest_entry_t **entries, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        shell_free((void **)&(*entries)[i].source_path);
+        shell_free((void **)&(*entries)[i].output_path);
+    }
+    shell_free((void **)entries);
+}
+
+/**
+ * @brief Free a manifest
+ *
+ * @param manifest The manifest (can be NULL)
+ */
+void manifest_free(manifest_t *manifest) {
+    if (manifest == NULL) {
+        return;
+    }
+    free_entries(&manifest->entries, manifest->entry_count);
+    free_entries(&manifest->records, manifest->record_count);
+    shell_free((void **)&manifest->index);
+    shell_free((void **)&manifest->file_path);
+    shell_free((void **)&manifest->doc_path);
+    shell_free((void **)&manifest);
+}
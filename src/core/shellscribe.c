@@ -14,15 +14,20 @@
 
 #include "core/shellscribe.h"
 #include "parsers/parser_engine.h"
+#include "parsers/line_class.h"
 #include "renderers/renderer_engine.h"
+#include "utils/arena.h"
 #include "utils/debug.h"
 #include "utils/memory.h"
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <errno.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 // If PATH_MAX is not defined, define it with a reasonable value
 #ifndef PATH_MAX
@@ -30,23 +35,182 @@
 #endif
 
 /**
- * @brief Maximum number of documentation blocks supported per processing
+ * @brief Read a shell script into memory
+ * 
+ * Loads the whole file with a single open/fstat/read sequence into a
+ * NUL-terminated buffer, so that binary detection, @skip detection and
+ * parsing can all work on the same copy without reopening the file.
+ * 
+ * @param file_path Path to the shell script file to read
+ * @param source Output parameter receiving the contents of the file
+ * 
+ * @return bool true if the file was read, false if it could not be opened,
+ *              read, or if memory allocation failed
+ * 
+ * @note The contents must be released with free_shell_script()
+ */
+bool load_shell_script(const char *file_path, shellscribe_source_t *source) {
+    if (file_path == NULL || source == NULL) {
+        return false;
+    }
+    source->data = NULL;
+    source->length = 0;
+    int fd = open(file_path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    size_t capacity = (size_t)st.st_size;
+    char *data = (char *)shell_malloc(capacity + 1);
+    if (data == NULL) {
+        close(fd);
+        return false;
+    }
+    size_t length = 0;
+    while (length < capacity) {
+        ssize_t bytes_read = read(fd, data + length, capacity - length);
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            shell_free((void **)&data);
+            return false;
+        }
+        if (bytes_read == 0) {
+            break;
+        }
+        length += (size_t)bytes_read;
+    }
+    close(fd);
+    data[length] = '\0';
+    source->data = data;
+    source->length = length;
+    
+    return true;
+}
+
+/**
+ * @brief Release the contents of a shell script loaded with load_shell_script()
+ * 
+ * @param source The loaded contents; its fields are reset
+ */
+void free_shell_script(shellscribe_source_t *source) {
+    if (source == NULL) {
+        return;
+    }
+    shell_free((void **)&source->data);
+    source->length = 0;
+}
+
+/**
+ * @brief Build the path of a temporary file next to a file
+ * 
+ * @param path The file to be replaced
+ * @param temp_path Buffer receiving the temporary path
+ * @param size Size of the buffer
+ * @return bool True on success, false if the path does not fit in the buffer
+ */
+bool make_temp_path(const char *path, char *temp_path, size_t size) {
+    static unsigned long temp_counter = 0;
+    unsigned long id = __atomic_add_fetch(&temp_counter, 1, __ATOMIC_RELAXED);
+    int length = snprintf(temp_path, size, "%s.%ld.%lu.tmp", path, (long)getpid(), id);
+
+    return (length >= 0 && (size_t)length < size);
+}
+
+/**
+ * @brief Key of the parse arena of each thread
+ */
+static pthread_key_t parse_arena_key;
+
+/**
+ * @brief Guard creating parse_arena_key once
+ */
+static pthread_once_t parse_arena_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Create the key of the parse arenas
  *
- * This constant defines the upper limit on the number of documentation blocks
- * that can be extracted from a single shell script file. This limit helps prevent
- * memory allocation issues when processing large scripts.
+ * Arenas are destroyed when the thread owning them exits.
  */
-#define MAX_DOCBLOCKS 1000
+static void create_parse_arena_key(void) {
+    pthread_key_create(&parse_arena_key, (void (*)(void *))arena_destroy);
+}
 
 /**
- * @brief Reduced block allocation for memory-efficient processing
+ * @brief Get the parse arena of the calling thread
  *
- * This constant defines a smaller allocation size used for more memory-efficient
- * processing in situations where we know a file will have fewer documentation blocks.
- * Using this smaller allocation can reduce memory usage significantly when processing
- * many small files.
+ * Each thread parses its files into its own arena, which is reset rather than
+ * freed between files: after the first few files, parsing a script no longer
+ * goes through malloc() for the strings and arrays of its blocks.
+ *
+ * @return arena_t* The arena of the thread, created on first use, or NULL on
+ *         allocation failure
  */
-#define REDUCED_DOCBLOCKS 100
+static arena_t *get_parse_arena(void) {
+    pthread_once(&parse_arena_once, create_parse_arena_key);
+    arena_t *arena = pthread_getspecific(parse_arena_key);
+    if (arena == NULL) {
+        arena = arena_create(0);
+        if (arena != NULL && pthread_setspecific(parse_arena_key, arena) != 0) {
+            arena_destroy(arena);
+            arena = NULL;
+        }
+    }
+    return arena;
+}
+
+/**
+ * @brief Parse a shell script already loaded in memory
+ * 
+ * Extracts all documentation blocks from the contents of a shell script that
+ * was read with load_shell_script(). This is the entry point used when the
+ * caller needs to inspect the file contents before parsing (e.g. to detect
+ * binaries), so the file is read only once. The contents are split into
+ * lines in place, so that the parser never copies them: newlines are replaced
+ * by NUL characters.
+ * 
+ * @param file_path Path to the shell script file, recorded in the first block
+ * @param source Contents of the shell script, modified by parsing
+ * @param block_count Output parameter to store the number of documentation blocks found
+ * @param config Configuration options controlling parsing behavior
+ * 
+ * @return shellscribe_docblock_t* Array of documentation blocks, or NULL on error.
+ *         The caller is responsible for freeing the blocks and the array using
+ *         free_docblocks().
+ * 
+ * @note The array grows with the number of functions in the script, so there
+ *       is no limit on the number of documentation blocks
+ * @note The blocks are allocated in the parse arena of the calling thread: they
+ *       must be freed before the thread parses another script
+ * 
+ * @see parse_shell_buffer
+ * @see parse_shell_script
+ */
+shellscribe_docblock_t* parse_shell_source(const char *file_path, shellscribe_source_t *source, int *block_count, const shellscribe_config_t *config) {
+    if (file_path == NULL || source == NULL || source->data == NULL || block_count == NULL || config == NULL) {
+        return NULL;
+    }
+    shellscribe_docblock_list_t docblocks = {get_parse_arena(), NULL, 0, 0};
+    if (docblocks.arena == NULL) {
+        fprintf(stderr, "Error: unable to parse file %s\n", file_path);
+        return NULL;
+    }
+    int count = parse_shell_buffer(file_path, source->data, source->length, config, &docblocks);
+    if (count <= 0) {
+        fprintf(stderr, "Error: unable to parse file %s\n", file_path);
+        free_docblock_list(&docblocks);
+        return NULL;
+    }
+    
+    *block_count = count;
+    return docblocks.blocks;
+}
 
 /**
  * @brief Parse a shell script and return the documentation blocks
@@ -60,40 +224,254 @@
  * @param config Configuration options controlling parsing behavior
  * 
  * @return shellscribe_docblock_t* Array of documentation blocks, or NULL on error.
- *         The caller is responsible for freeing this memory using free_docblocks().
+ *         The caller is responsible for freeing the blocks and the array using
+ *         free_docblocks().
  * 
  * @note If any parameter is NULL, the function returns NULL
  * @note If no documentation blocks are found or an error occurs during parsing,
  *       the function returns NULL and prints an error message
- * @note Memory is allocated for up to MAX_DOCBLOCKS documentation blocks
+ * @note Memory is allocated for as many documentation blocks as the script holds
  * @note The actual number of blocks found is stored in the block_count parameter
  * 
- * @see parse_shell_file
+ * @see load_shell_script
+ * @see parse_shell_source
  * @see free_docblocks
- * @see MAX_DOCBLOCKS
  */
 shellscribe_docblock_t* parse_shell_script(const char *file_path, int *block_count, const shellscribe_config_t *config) {
     if (file_path == NULL || block_count == NULL || config == NULL) {
         return NULL;
     }
-    shellscribe_docblock_t *docblocks = (shellscribe_docblock_t *)shell_calloc(MAX_DOCBLOCKS, sizeof(shellscribe_docblock_t));
-    if (docblocks == NULL) {
-        fprintf(stderr, "Error: unable to allocate memory for documentation blocks\n");
+    shellscribe_source_t source;
+    if (!load_shell_script(file_path, &source)) {
+        fprintf(stderr, "Error: unable to read file %s\n", file_path);
         return NULL;
     }
-    int count = parse_shell_file(file_path, config, docblocks, MAX_DOCBLOCKS);
-    if (count <= 0) {
-        fprintf(stderr, "Error: unable to parse file %s\n", file_path);
-        for (int i = 0; i < MAX_DOCBLOCKS; i++) {
-            free_docblock(&docblocks[i]);
+    shellscribe_docblock_t *docblocks = parse_shell_source(file_path, &source, block_count, config);
+    free_shell_script(&source);
+    
+    return docblocks;
+}
+
+/**
+ * @brief Replace a string field of a probe with a copy of a value
+ * 
+ * @param field The field (its previous value is freed)
+ * @param value The value
+ * 
+ * @return bool true on success, false on allocation failure
+ */
+static bool set_probe_field(char **field, const char *value) {
+    shell_free((void **)field);
+    *field = shell_strdup(value);
+    return (*field != NULL);
+}
+
+/**
+ * @brief Probe the header held by the beginning of the contents of a script
+ * 
+ * The header is read the way the parser reads it: it is made of the comment
+ * lines at the top of the script and ends at the first line that is not a
+ * comment. The shebang and the @brief of the file-level block are recorded,
+ * and a @skip tag found there marks the script as skipped: before any
+ * @function tag, or afterwards at the start of a line, which is when the
+ * parser records it for the whole file.
+ * 
+ * Only the first max_size bytes are looked at, so that a script is classified
+ * the same whether it was loaded whole or read by probe_shell_script(): the
+ * binary check covers them all, and the header scan stops at the last line
+ * they hold completely. A shell header followed by a binary payload (as in
+ * self-extracting archives) is thus still a script.
+ * 
+ * Lines are classified where they lie: each one is terminated in place while
+ * it is looked at, and its newline put back right after, so that the contents
+ * end up unchanged without being copied.
+ * 
+ * @param data The contents, followed by a NUL byte unless truncated
+ * @param length The length of the contents
+ * @param max_size The size of the window probed (0 for SHELLSCRIBE_PROBE_DEFAULT_SIZE)
+ * @param truncated Whether the contents are only the beginning of the script
+ * @param with_strings Whether to record the interpreter and the brief, or only the flags
+ * @param probe Output parameter receiving what the header tells
+ * 
+ * @return bool true on success, false on allocation failure
+ * 
+ * @note Binary contents are not scanned for a header
+ */
+static bool probe_contents(char *data, size_t length, size_t max_size, bool truncated, bool with_strings, shellscribe_probe_t *probe) {
+    *probe = (shellscribe_probe_t){0};
+    if (max_size == 0) {
+        max_size = SHELLSCRIBE_PROBE_DEFAULT_SIZE;
+    }
+    if (length > max_size) {
+        length = max_size;
+        truncated = true;
+    }
+    if (length >= 4 && memcmp(data, "\x7f" "ELF", 4) == 0) {
+        probe->is_binary = true;
+        probe->is_elf = true;
+        return true;
+    }
+    if (memchr(data, '\0', length) != NULL) {
+        probe->is_binary = true;
+        return true;
+    }
+    if (truncated) {
+        while (length > 0 && data[length - 1] != '\n') {
+            length--;
         }
-        void *docblocks_ptr = docblocks;
-        shell_free(&docblocks_ptr);
-        return NULL;
+    }
+    bool in_file_block = true;
+    bool success = true;
+    char *end = data + length;
+    for (char *line = data; success && line < end; ) {
+        char *newline = memchr(line, '\n', (size_t)(end - line));
+        size_t line_length = (newline != NULL) ? (size_t)(newline - line) : (size_t)(end - line);
+        if (newline != NULL) {
+            *newline = '\0';
+        }
+        line_class_t cls;
+        line_kind_t kind = classify_line(line, line_length, line == data, &cls);
+        if (!line_kind_is_comment(kind)) {
+            if (newline != NULL) {
+                *newline = '\n';
+            }
+            break;
+        }
+        if (strncmp(line, "#!", 2) == 0) {
+            const char *interpreter = line + 2;
+            while (*interpreter == ' ' || *interpreter == '\t') {
+                interpreter++;
+            }
+            if (with_strings && *interpreter) {
+                success = set_probe_field(&probe->interpreter, interpreter);
+            }
+        } else if (kind == LINE_TAG) {
+            if (cls.tag.id == TAG_FUNCTION) {
+                in_file_block = false;
+            } else if (cls.tag.id == TAG_SKIP && (in_file_block || cls.indent == 0)) {
+                probe->is_skipped = true;
+            } else if (cls.tag.id == TAG_BRIEF && in_file_block && with_strings) {
+                success = set_probe_field(&probe->brief, cls.tag.content);
+            }
+        }
+        if (newline != NULL) {
+            *newline = '\n';
+        }
+        line += line_length + 1;
+    }
+    if (!success) {
+        free_shell_probe(probe);
     }
     
-    *block_count = count;
-    return docblocks;
+    return success;
+}
+
+/**
+ * @brief Probe the header of a shell script already loaded in memory
+ * 
+ * Tells whether a loaded script is binary or marked with @skip in its header,
+ * without parsing it, so that skipped scripts cost no more than their
+ * reading. Only the flags of the probe are set: the interpreter and the brief
+ * are left NULL, so that probing a script allocates nothing. Unlike parsing,
+ * probing leaves the contents as they were. Only the first max_size bytes are
+ * probed, as by probe_shell_script().
+ * 
+ * @param source Contents of the shell script (restored before returning)
+ * @param max_size Maximum number of bytes probed (0 for SHELLSCRIBE_PROBE_DEFAULT_SIZE)
+ * @param probe Output parameter receiving the flags of the header
+ * 
+ * @return bool true on success, false if a parameter is NULL
+ * 
+ * @note A script whose header is not marked with @skip can still be skipped by
+ *       a @skip tag further down, which only parsing finds
+ * 
+ * @see probe_shell_script
+ */
+bool probe_shell_source(shellscribe_source_t *source, size_t max_size, shellscribe_probe_t *probe) {
+    if (source == NULL || source->data == NULL || probe == NULL) {
+        return false;
+    }
+    
+    return probe_contents(source->data, source->length, max_size, false, false, probe);
+}
+
+/**
+ * @brief Probe the header of a shell script, reading only the beginning of the file
+ * 
+ * Reads at most max_size bytes of the script with a single open/read
+ * sequence and probes the header they hold. A line cut by the size limit is
+ * left out, and so is whatever of the header lies beyond it.
+ * 
+ * @param file_path Path to the shell script file
+ * @param max_size Maximum number of bytes read (0 for SHELLSCRIBE_PROBE_DEFAULT_SIZE)
+ * @param probe Output parameter receiving what the header tells
+ * 
+ * @return bool true on success, false if the file could not be opened or
+ *              read, or if memory allocation failed
+ * 
+ * @note The strings of the probe must be released with free_shell_probe()
+ * 
+ * @see probe_shell_source
+ */
+bool probe_shell_script(const char *file_path, size_t max_size, shellscribe_probe_t *probe) {
+    if (file_path == NULL || probe == NULL) {
+        return false;
+    }
+    if (max_size == 0) {
+        max_size = SHELLSCRIBE_PROBE_DEFAULT_SIZE;
+    }
+    int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    bool truncated = ((size_t)st.st_size > max_size);
+    size_t capacity = truncated ? max_size : (size_t)st.st_size;
+    char *data = (char *)shell_malloc(capacity + 1);
+    if (data == NULL) {
+        close(fd);
+        return false;
+    }
+    size_t length = 0;
+    while (length < capacity) {
+        ssize_t bytes_read = read(fd, data + length, capacity - length);
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            shell_free((void **)&data);
+            return false;
+        }
+        if (bytes_read == 0) {
+            break;
+        }
+        length += (size_t)bytes_read;
+    }
+    close(fd);
+    data[length] = '\0';
+    bool success = probe_contents(data, length, max_size, truncated, true, probe);
+    shell_free((void **)&data);
+    
+    return success;
+}
+
+/**
+ * @brief Release the strings of a probe
+ * 
+ * @param probe The probe filled by probe_shell_source() or probe_shell_script();
+ *              its strings are reset
+ */
+void free_shell_probe(shellscribe_probe_t *probe) {
+    if (probe == NULL) {
+        return;
+    }
+    shell_free((void **)&probe->interpreter);
+    shell_free((void **)&probe->brief);
 }
 
 /**
@@ -8,17 +8,36 @@
 #include <string.h>
 #include <stdbool.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
 #include <limits.h>  // For PATH_MAX
+#include <errno.h>
+#include <signal.h>
 
 #include "core/shellscribe.h"
+#include "core/manifest.h"
 #include "utils/config.h"
 #include "utils/debug.h"
 #include "utils/memory.h"
+#include "utils/worker_pool.h"
+#include "utils/watcher.h"
+#include "utils/dir_walker.h"
+#include "utils/string_set.h"
+#include "utils/intern.h"
+#include "utils/string.h"
 #include "parsers/types.h"
 #include "renderers/renderer_engine.h"
 
-#define MAX_FILES 1000
+/**
+ * @brief Number of files kept in flight per worker thread during directory processing
+ */
+#define FILES_IN_FLIGHT_PER_JOB 4
+
+/**
+ * @brief Quiet period after the last change before watch mode regenerates documentation
+ */
+#define WATCH_DEBOUNCE_MS 200
 
 // Define SHELLSCRIBE_VERSION if not defined already
 #ifndef SHELLSCRIBE_VERSION
@@ -41,26 +60,126 @@
 #define STATUS_FAILED    "[" COLOR_RED "FAILED" COLOR_RESET "]"
 #define SKIP_TAG         COLOR_ORANGE "@skip" COLOR_RESET
 
+#define SKIP_REASON_ELF      "ELF binary detected"
+#define SKIP_REASON_BINARY   "binary file detected"
+#define SKIP_REASON_MARKED   "marked with @skip"
+
+/**
+ * @brief Outcome of the processing of a single file
+ */
+typedef enum {
+    FILE_STATUS_OK,
+    FILE_STATUS_UNCHANGED,
+    FILE_STATUS_SKIPPED,
+    FILE_STATUS_FAILED
+} file_status_t;
+
+/**
+ * @brief A file scheduled for documentation generation
+ */
+typedef struct {
+    char *file_path;            // Path of the input script
+    char *display_path;         // Path displayed in the status line (relative to the base directory)
+    char *output_path;          // Path of the documentation file, NULL if none was generated
+    manifest_stamp_t stamp;     // State of the input script, recorded in the manifest
+    file_status_t status;       // Outcome of the processing
+    const char *message;        // Skip reason or error message, NULL if none
+} file_task_t;
+
+/**
+ * @brief A stream of files shared between the worker threads and the reporting thread
+ */
+typedef struct {
+    worker_pool_t *pool;                 // Worker pool processing the files
+    manifest_t *manifest;                // Incremental build manifest of the documentation directory
+    string_set_t *known_dirs;            // Output directories known to exist
+    const char *base_dir;                // Base directory used to compute display paths
+    const shellscribe_config_t *config;  // Configuration
+    int total_files;                     // Number of files submitted
+    int processed_files;                 // Number of files documented successfully
+    int unchanged_files;                 // Number of files whose documentation was already up to date
+    int skipped_files;                   // Number of files skipped
+    int failed_files;                    // Number of files that failed
+    char **deferred_files;               // Files held back until the walk completes (sort_files only)
+    size_t deferred_count;               // Number of deferred files
+    size_t deferred_capacity;            // Allocated number of deferred files
+} file_pipeline_t;
+
+/**
+ * @brief Command-line options
+ */
+typedef struct {
+    char *input_file;           // Input file or directory
+    char *config_file;          // Configuration file
+    char *files_from;           // File listing the scripts to process ("-" for standard input)
+    char *base_dir;             // Base directory of the listed scripts (default: current directory)
+    bool null_separated;        // Listed scripts are separated by NUL characters instead of newlines
+    int jobs;                   // Number of worker threads (0 = use the configuration)
+    bool watch;                 // Keep running and regenerate documentation on changes
+    bool parallel_walk;         // Walk directories on several threads
+    bool sort_files;            // Process files in path order
+    bool list_only;             // Print the path and brief of each script instead of documenting it
+    bool show_version;          // Display the version and exit
+    bool show_help;             // Display the usage help and exit
+} cli_options_t;
+
+/**
+ * @brief Scripts found by list mode
+ */
+typedef struct {
+    const char *base_dir;       // Base directory used to compute display paths (NULL for a single script)
+    bool sort;                  // Print the scripts in path order once the walk completes
+    char **lines;               // Lines held back until the walk completes (sort only)
+    size_t count;               // Number of held lines
+    size_t capacity;            // Allocated number of held lines
+    int failed;                 // Number of scripts that could not be listed
+} script_list_t;
+
+/**
+ * @brief Set by the signal handler to stop watch mode
+ */
+static volatile sig_atomic_t watch_interrupted = 0;
+
 // Forward declarations
 static void print_version(void);
 static void print_usage(const char *program_name);
 static char *normalize_path(const char *path);
-static int get_shell_scripts_recursive(const char *dir_path, char **files, int max_files, int current_count, bool traverse_symlinks);
-static int get_shell_scripts(const char *dir_path, char **files, int max_files, const shellscribe_config_t *config);
+static void submit_shell_script(const char *path, void *user_data);
+static int get_shell_scripts(const char *dir_path, file_pipeline_t *pipeline, const shellscribe_config_t *config);
 static bool is_directory(const char *path);
-static bool is_elf_binary(const char *file_path);
-static bool should_skip_file(const char *input_file, const shellscribe_config_t *config, char **skip_reason);
-static bool create_directories_recursive(const char *path);
-static bool parse_arguments(int argc, char *argv[], char **input_file, char **config_file, bool *show_version, bool *show_help);
+static bool create_directories_recursive(const char *path, string_set_t *known_dirs);
+static bool has_shell_script_extension(const char *file_name);
+static bool parse_arguments(int argc, char *argv[], cli_options_t *options);
 static bool initialize_config(shellscribe_config_t *config, const char *config_file);
 static void finalize_config(shellscribe_config_t *config);
 static int process_directory(const char *input_file, const shellscribe_config_t *config);
-static int process_files(char **files, int file_count, const char *base_dir, const shellscribe_config_t *config);
-static bool process_single_file(const char *file_path, char *display_path, const shellscribe_config_t *config, int *processed_files, int *skipped_files, int *failed_files);
-static void handle_skipped_file(char *skip_reason, char *display_path, int *skipped_files);
-static bool generate_documentation(const char *file_path, char *display_path, const shellscribe_config_t *config);
-static bool prepare_output_path(const char *relative_path, const shellscribe_config_t *config, char *output_path);
+static int watch_directory(const char *input_file, const shellscribe_config_t *config);
+static int process_file_list(const char *list_path, bool null_separated, const char *base_dir, const shellscribe_config_t *config);
+static void process_changes(char **paths, size_t path_count, const char *base_dir, const shellscribe_config_t *config);
+static bool is_inside_walked_directory(char **walked, size_t walked_count, const char *path);
+static void handle_watch_signal(int signal_number);
+static bool file_pipeline_start(file_pipeline_t *pipeline, const char *base_dir, const shellscribe_config_t *config);
+static void file_pipeline_submit(file_pipeline_t *pipeline, const char *file_path);
+static void file_pipeline_enqueue(file_pipeline_t *pipeline, const char *file_path);
+static bool file_pipeline_defer(file_pipeline_t *pipeline, const char *file_path);
+static int compare_file_paths(const void *a, const void *b);
+static int file_pipeline_finish(file_pipeline_t *pipeline);
+static file_task_t *create_file_task(const char *file_path, const char *display_path);
+static void free_file_task(file_task_t *task);
+static bool set_file_status(file_task_t *task, file_status_t status, const char *message);
+static void process_file_task(void *item, void *user_data);
+static void report_file_task(void *item, void *user_data);
+static bool process_single_file(file_task_t *task, const shellscribe_config_t *config, const manifest_t *manifest, string_set_t *known_dirs);
+static void report_file_status(const file_task_t *task);
+static bool generate_documentation(const char *output_path, const shellscribe_docblock_t *docblocks, int block_count, const shellscribe_config_t *config, string_set_t *known_dirs, bool *unchanged, const char **error);
+static bool is_file_identical(const char *path, const char *data, size_t length);
+static bool write_file_atomically(const char *path, const char *data, size_t length);
+static bool get_output_path(const file_task_t *task, const shellscribe_config_t *config, char *output_path, const char **error);
+static void build_output_path(const char *relative_path, const shellscribe_config_t *config, char *output_path);
+static bool create_output_directory(const char *output_path, string_set_t *known_dirs, const char **error);
 static int process_file(const char *input_file, const shellscribe_config_t *config);
+static void list_shell_script(const char *path, void *user_data);
+static int list_scripts(const char *input_path, bool is_dir, const shellscribe_config_t *config);
 
 /**
  * Prints the program version
@@ -86,6 +205,14 @@ static void print_usage(const char *program_name) {
     printf("  --help, -h         Display this help message\n");
     printf("  --version, -v      Display version information\n");
     printf("  --config-file=FILE, -c=FILE Specify a custom configuration file\n");
+    printf("  --jobs=N, -j=N     Number of files processed in parallel (default: available CPUs)\n");
+    printf("  --watch, -w        Keep running and regenerate documentation when scripts change\n");
+    printf("  --files-from=FILE  Process the scripts listed in FILE, one per line (- for standard input)\n");
+    printf("  --null, -0         Scripts listed by --files-from are separated by NUL characters\n");
+    printf("  --base-dir=DIR     Directory the listed scripts are documented relative to (default: .)\n");
+    printf("  --parallel-walk    Walk directories on several threads\n");
+    printf("  --sort             Process scripts in path order\n");
+    printf("  --list             Print the path and brief of each script without generating documentation\n");
     printf("\n");
 }
 
@@ -122,71 +249,58 @@ static char *normalize_path(const char *path) {
 }
 
 /**
- * @brief Get all shell scripts in a directory, with optional recursion into subdirectories
+ * @brief Check whether a file name looks like a shell script
  * 
- * Get all shell scripts in a directory, with optional recursion into subdirectories
- * 
- * @param dir_path The directory path to search
- * @param files The array to store the shell script paths
- * @param max_files The maximum number of files to store
- * @param current_count The current count of files
- * @param traverse_symlinks Whether to traverse symlinks
- * @return int The number of shell scripts found
+ * @param file_name The file name to check
+ * @return bool True if the name contains a shell script extension
  */
-static int get_shell_scripts_recursive(const char *dir_path, char **files, int max_files, int current_count, bool traverse_symlinks) {
-    if (files == NULL || max_files <= 0 || current_count >= max_files) {
-        return current_count;
-    }
-    DIR *dir = opendir(dir_path);
-    if (dir == NULL) {
-        return current_count;
-    }
-    int count = current_count;
-    struct dirent *entry;
-    char full_path[PATH_MAX];
-    struct stat file_stat;
-    while ((entry = readdir(dir)) != NULL && count < max_files) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-        snprintf(full_path, sizeof(full_path), "%s/%s", dir_path, entry->d_name);
-        if (stat(full_path, &file_stat) != 0) {
-            continue;
-        }
-        if (S_ISDIR(file_stat.st_mode)) {
-            count = get_shell_scripts_recursive(full_path, files, max_files, count, traverse_symlinks);
-        } else if (S_ISREG(file_stat.st_mode) || (S_ISLNK(file_stat.st_mode) && traverse_symlinks)) {
-            const char *extensions[] = {".sh", ".bash", ".zsh"};
-            for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
-                if (strstr(entry->d_name, extensions[i])) {
-                    files[count] = shell_strdup(full_path);
-                    if (files[count] == NULL) {
-                        fprintf(stderr, "Error: Failed to allocate memory for file path\n");
-                        break;
-                    }
-                    count++;
-                    break;
-                }
-            }
+static bool has_shell_script_extension(const char *file_name) {
+    const char *extensions[] = {".sh", ".bash", ".zsh"};
+    for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+        if (strstr(file_name, extensions[i])) {
+            return true;
         }
     }
+    return false;
+}
 
-    closedir(dir);
-    return count;
+/**
+ * @brief Directory walker callback submitting a shell script to a pipeline
+ * 
+ * @param path The path of the shell script
+ * @param user_data The file pipeline
+ */
+static void submit_shell_script(const char *path, void *user_data) {
+    file_pipeline_submit((file_pipeline_t *)user_data, path);
 }
 
 /**
  * @brief Get all shell scripts in a directory
  * 
- * This function gets all shell scripts in a directory.
+ * This function walks a directory tree and submits every shell script found
+ * to the pipeline as soon as it is found. With the parallel_walk option, the
+ * tree is walked by as many threads as there are jobs, which hides directory
+ * read latency on network filesystems; scripts are then found in no
+ * particular order unless sort_files is set.
  * 
  * @param dir_path The directory path to search
- * @param files The array to store the shell script paths
- * @param max_files The maximum number of files to store
+ * @param pipeline The pipeline receiving the shell script paths
  * @param config The configuration
+ * @return int The number of shell scripts found
  */
-static int get_shell_scripts(const char *dir_path, char **files, int max_files, const shellscribe_config_t *config) {
-    return get_shell_scripts_recursive(dir_path, files, max_files, 0, config->traverse_symlinks);
+static int get_shell_scripts(const char *dir_path, file_pipeline_t *pipeline, const shellscribe_config_t *config) {
+    dir_walker_options_t options = {
+        .traverse_symlinks = config->traverse_symlinks,
+        .match = has_shell_script_extension,
+        .visit = submit_shell_script,
+        .user_data = pipeline
+    };
+    if (config->parallel_walk) {
+        int threads = (config->jobs > 0) ? config->jobs : worker_pool_default_jobs();
+        return dir_walker_walk_parallel(dir_path, threads, &options);
+    }
+
+    return dir_walker_walk(dir_path, &options);
 }
 
 /**
@@ -205,101 +319,78 @@ static bool is_directory(const char *path) {
     return S_ISDIR(path_stat.st_mode);
 }
 
-/**
- * Check if a file is an ELF binary
- */
-static bool is_elf_binary(const char *file_path) {
-    FILE *file = fopen(file_path, "rb");
-    if (file == NULL) {
-        return false;
-    }
-    unsigned char magic[4];
-    size_t bytes_read = fread(magic, 1, 4, file);
-    fclose(file);
-    
-    if (bytes_read != 4) {
-        return false;
-    }
-    return (magic[0] == 0x7F && magic[1] == 'E' && magic[2] == 'L' && magic[3] == 'F');
-}
-
-/**
- * @brief Check if a file should be skipped based on the @skip annotation or if it's an ELF binary
- * 
- * This function checks if a file should be skipped based on the @skip annotation or if it's an ELF binary.
- * 
- * @param input_file The input file to check
- * @param config The configuration
- * @param skip_reason The skip reason
- */
-static bool should_skip_file(const char *input_file, const shellscribe_config_t *config, char **skip_reason) {
-    if (is_elf_binary(input_file)) {
-        if (skip_reason) {
-            *skip_reason = shell_strdup("ELF binary detected");
-        }
-        return true;
-    }
-    int block_count = 0;
-    shellscribe_docblock_t *docblocks = parse_shell_script(input_file, &block_count, config);
-    if (docblocks == NULL || block_count <= 0) {
-        return false;
-    }
-    bool should_skip = (block_count > 0 && docblocks[0].is_skipped);
-    if (should_skip && skip_reason) {
-        *skip_reason = shell_strdup("marked with @skip");
-    }
-    free_docblocks(docblocks, block_count);
-    return should_skip;
-}
-
 /**
  * Create a directory and all parent directories recursively
  * 
+ * Directories found in known_dirs are assumed to exist; the others are
+ * created if needed and added to known_dirs, so that every directory is only
+ * checked once per run, whatever the number of files written to it.
+ * 
  * @param path Directory path to create
+ * @param known_dirs Directories known to exist (can be NULL)
  * @return true if successful, false otherwise
  */
-static bool create_directories_recursive(const char *path) {
+static bool create_directories_recursive(const char *path, string_set_t *known_dirs) {
     if (path == NULL) {
         return false;
     }
     char tmp[PATH_MAX];
-    char *p = NULL;
     size_t len;
     strncpy(tmp, path, PATH_MAX - 1);
     tmp[PATH_MAX - 1] = '\0';
     len = strlen(tmp);
     if (len > 0 && tmp[len - 1] == '/') {
-        tmp[len - 1] = '\0';
+        tmp[--len] = '\0';
+    }
+    if (len == 0 || string_set_contains(known_dirs, tmp, len)) {
+        return true;
     }
-    for (p = tmp + 1; *p; p++) {
-        if (*p == '/') {
+    for (char *p = tmp + 1; ; p++) {
+        if (*p != '/' && *p != '\0') {
+            continue;
+        }
+        size_t prefix_len = (size_t)(p - tmp);
+        if (!string_set_contains(known_dirs, tmp, prefix_len)) {
+            char separator = *p;
             *p = '\0';
             struct stat st;
             if (stat(tmp, &st) != 0) {
-                if (mkdir(tmp, 0755) != 0) {
+                if (mkdir(tmp, 0755) != 0 && errno != EEXIST) {
                     return false;
                 }
             } else if (!S_ISDIR(st.st_mode)) {
                 return false;
             }
-            *p = '/';
+            *p = separator;
+            string_set_add(known_dirs, tmp, prefix_len);
         }
-    }
-    struct stat st;
-    if (stat(tmp, &st) != 0) {
-        if (mkdir(tmp, 0755) != 0) {
-            return false;
+        if (*p == '\0') {
+            break;
         }
-    } else if (!S_ISDIR(st.st_mode)) {
-        return false;
     }
 
     return true;
 }
 
+/**
+ * Skip the leading "./" components of a path
+ * 
+ * @param path Path to process
+ * @return Pointer inside path past its "./" components ("." alone gives "")
+ */
+static const char *skip_current_directory(const char *path) {
+    while (path[0] == '.' && (path[1] == '/' || path[1] == '\0')) {
+        path += (path[1] == '/') ? 2 : 1;
+    }
+    return path;
+}
+
 /**
  * Extract relative path from a full path based on a base directory
  * 
+ * Leading "./" components are ignored, so that relative paths can be
+ * resolved against the current directory (".").
+ * 
  * @param full_path Full path to process
  * @param base_dir Base directory to extract relative path from
  * @return Newly allocated string with relative path or NULL if error
@@ -315,25 +406,18 @@ static char *get_relative_path(const char *full_path, const char *base_dir) {
         shell_free((void **)&norm_base_dir);
         return NULL;
     }
-    size_t base_len = strlen(norm_base_dir);
-    if (base_len > 0 && norm_base_dir[base_len - 1] != '/') {
-        char *new_base = shell_malloc(base_len + 2);
-        if (!new_base) {
-            shell_free((void **)&norm_full_path);
-            shell_free((void **)&norm_base_dir);
-            return NULL;
-        }
-        snprintf(new_base, base_len + 2, "%s/", norm_base_dir);
-        shell_free((void **)&norm_base_dir);
-        norm_base_dir = new_base;
-        base_len++;
-    }
+    const char *full = skip_current_directory(norm_full_path);
+    const char *base = skip_current_directory(norm_base_dir);
+    size_t base_len = strlen(base);
+    bool has_trailing_slash = (base_len > 0 && base[base_len - 1] == '/');
     char *relative_path = NULL;
-    if (strncmp(norm_full_path, norm_base_dir, base_len) == 0) {
-        relative_path = shell_strdup(norm_full_path + base_len);
+    if (base_len == 0 && full[0] != '/') {
+        relative_path = shell_strdup(full);
+    } else if (base_len > 0 && strncmp(full, base, base_len) == 0 && (has_trailing_slash || full[base_len] == '/')) {
+        relative_path = shell_strdup(full + base_len + (has_trailing_slash ? 0 : 1));
     } else {
-        const char *filename = strrchr(norm_full_path, '/');
-        relative_path = shell_strdup(filename ? filename + 1 : norm_full_path);
+        const char *filename = strrchr(full, '/');
+        relative_path = shell_strdup(filename ? filename + 1 : full);
     }
     shell_free((void **)&norm_full_path);
     shell_free((void **)&norm_base_dir);
@@ -349,28 +433,58 @@ static char *get_relative_path(const char *full_path, const char *base_dir) {
  * @param argv The command-line arguments
  */
 int main(int argc, char *argv[]) {
-    char *input_file = NULL;
-    char *config_file = NULL;
-    bool show_version = false;
-    bool show_help = false;
-    if (!parse_arguments(argc, argv, &input_file, &config_file, &show_version, &show_help)) {
+    cli_options_t options = {0};
+    if (!parse_arguments(argc, argv, &options)) {
         return 1;
     }
-    if (show_version) {
+    if (options.show_version) {
         print_version();
         return 0;
     }
-    if (show_help || input_file == NULL) {
+    if (options.show_help || (options.input_file == NULL && options.files_from == NULL)) {
         print_usage(argv[0]);
         return 0;
     }
+    if (options.files_from != NULL && (options.input_file != NULL || options.watch)) {
+        fprintf(stderr, "Error: --files-from cannot be combined with an input path or --watch\n");
+        return 1;
+    }
+    if (options.files_from == NULL && (options.null_separated || options.base_dir != NULL)) {
+        fprintf(stderr, "Error: -0 and --base-dir require --files-from\n");
+        return 1;
+    }
+    if (options.list_only && (options.files_from != NULL || options.watch)) {
+        fprintf(stderr, "Error: --list cannot be combined with --files-from or --watch\n");
+        return 1;
+    }
+    bool is_dir = (options.input_file != NULL) && is_directory(options.input_file);
+    if (options.watch && !is_dir) {
+        fprintf(stderr, "Error: --watch requires a directory\n");
+        return 1;
+    }
     shellscribe_config_t config;
-    if (!initialize_config(&config, config_file)) {
+    if (!initialize_config(&config, options.config_file)) {
         return 1;
     }
-    bool is_dir = is_directory(input_file);
+    if (options.jobs > 0) {
+        config.jobs = options.jobs;
+    }
+    if (options.parallel_walk) {
+        config.parallel_walk = true;
+    }
+    if (options.sort_files) {
+        config.sort_files = true;
+    }
     int result = 0;
-    result = is_dir ? process_directory(input_file, &config) : process_file(input_file, &config);
+    if (options.list_only) {
+        result = list_scripts(options.input_file, is_dir, &config);
+    } else if (options.files_from != NULL) {
+        result = process_file_list(options.files_from, options.null_separated, options.base_dir ? options.base_dir : ".", &config);
+    } else if (options.watch) {
+        result = watch_directory(options.input_file, &config);
+    } else {
+        result = is_dir ? process_directory(options.input_file, &config) : process_file(options.input_file, &config);
+    }
     finalize_config(&config);
 
     return result;
@@ -383,22 +497,42 @@ int main(int argc, char *argv[]) {
  * 
  * @param argc The number of command-line arguments
  * @param argv The command-line arguments
- * @param input_file Pointer to store the input file or directory
- * @param config_file Pointer to store the configuration file
- * @param show_version Pointer to store whether to show version information
- * @param show_help Pointer to store whether to show help information
+ * @param options Pointer to store the parsed options
  * @return bool True if parsing was successful, false otherwise
  */
-static bool parse_arguments(int argc, char *argv[], char **input_file, char **config_file, bool *show_version, bool *show_help) {
+static bool parse_arguments(int argc, char *argv[], cli_options_t *options) {
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
-            *show_help = true;
+            options->show_help = true;
         } else if (strcmp(argv[i], "--version") == 0 || strcmp(argv[i], "-v") == 0) {
-            *show_version = true;
+            options->show_version = true;
+        } else if (strcmp(argv[i], "--watch") == 0 || strcmp(argv[i], "-w") == 0) {
+            options->watch = true;
+        } else if (strcmp(argv[i], "--parallel-walk") == 0) {
+            options->parallel_walk = true;
+        } else if (strcmp(argv[i], "--sort") == 0) {
+            options->sort_files = true;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            options->list_only = true;
         } else if (strncmp(argv[i], "--config-file=", 14) == 0 || strncmp(argv[i], "-c=", 3) == 0) {
-            *config_file = argv[i] + 14;
+            options->config_file = strchr(argv[i], '=') + 1;
+        } else if (strncmp(argv[i], "--files-from=", 13) == 0) {
+            options->files_from = argv[i] + 13;
+        } else if (strncmp(argv[i], "--base-dir=", 11) == 0) {
+            options->base_dir = argv[i] + 11;
+        } else if (strcmp(argv[i], "-0") == 0 || strcmp(argv[i], "--null") == 0) {
+            options->null_separated = true;
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0 || strncmp(argv[i], "-j=", 3) == 0) {
+            const char *value = strchr(argv[i], '=') + 1;
+            char *end = NULL;
+            long requested = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || requested < 1 || requested > MAX_JOBS) {
+                fprintf(stderr, "Invalid number of jobs: %s (expected 1-%d)\n", value, MAX_JOBS);
+                return false;
+            }
+            options->jobs = (int)requested;
         } else if (argv[i][0] != '-') {
-            *input_file = argv[i];
+            options->input_file = argv[i];
         } else {
             fprintf(stderr, "Unknown option: %s\n", argv[i]);
             return false;
@@ -437,11 +571,15 @@ static bool initialize_config(shellscribe_config_t *config, const char *config_f
 /**
  * @brief Finalize the configuration
  * 
- * This function finalizes the configuration by cleaning up memory tracking and printing memory statistics.
+ * This function finalizes the configuration by releasing the interned strings
+ * and the cached regular expressions of the run, cleaning up memory tracking
+ * and printing memory statistics.
  * 
  * @param config Pointer to the configuration structure
  */
 static void finalize_config(shellscribe_config_t *config) {
+    intern_cleanup();
+    string_regex_cleanup();
     if (config->memory_tracking && config->memory_stats) {
         shell_memory_stats();
         if (shell_check_leaks()) {
@@ -454,159 +592,719 @@ static void finalize_config(shellscribe_config_t *config) {
 }
 
 /**
- * @brief Process a single file
+ * @brief Process a directory
  * 
- * This function processes a single file and generates documentation.
+ * This function generates documentation for every shell script found in a
+ * directory. Files are processed while the directory is still being walked.
  * 
- * @param input_file The input file to process
+ * @param input_file The directory to process
  * @param config The configuration
  * @return int 0 on success, 1 on failure
  */
 static int process_directory(const char *input_file, const shellscribe_config_t *config) {
     fprintf(stderr, "Processing shell scripts in directory: %s\n", input_file);
-    char *files[MAX_FILES];
-    int file_count = get_shell_scripts(input_file, files, MAX_FILES, config);
+    file_pipeline_t pipeline;
+    if (!file_pipeline_start(&pipeline, input_file, config)) {
+        return 1;
+    }
+    int file_count = get_shell_scripts(input_file, &pipeline, config);
+    int result = file_pipeline_finish(&pipeline);
     if (file_count <= 0) {
         fprintf(stderr, "Error: No shell scripts found in directory\n");
         return 1;
     }
-    fprintf(stderr, "Found %d shell scripts to process\n", file_count);
-    int result = process_files(files, file_count, input_file, config);
-    for (int i = 0; i < file_count; i++) {
-        if (files[i] != NULL) {
-            void *ptr = files[i];
-            shell_free(&ptr);
+
+    return result;
+}
+
+/**
+ * @brief Process a list of files
+ * 
+ * This function generates documentation for the shell scripts listed in a
+ * file, e.g. the scripts changed since the last build as reported by the
+ * build system. Scripts are processed by the same pipeline as directories,
+ * while the list is read, and documented relative to base_dir. Listed paths
+ * that do not exist are ignored, so that lists of changed files can include
+ * deleted scripts: their documentation is removed by the build manifest.
+ * 
+ * @param list_path The file listing the scripts ("-" for standard input)
+ * @param null_separated True if the paths are separated by NUL characters instead of newlines
+ * @param base_dir The directory the listed scripts are documented relative to
+ * @param config The configuration
+ * @return int 0 on success, 1 on failure
+ */
+static int process_file_list(const char *list_path, bool null_separated, const char *base_dir, const shellscribe_config_t *config) {
+    bool from_stdin = (strcmp(list_path, "-") == 0);
+    FILE *list = from_stdin ? stdin : fopen(list_path, "r");
+    if (list == NULL) {
+        fprintf(stderr, "Error: unable to open file list %s\n", list_path);
+        return 1;
+    }
+    fprintf(stderr, "Processing shell scripts listed in: %s\n", from_stdin ? "standard input" : list_path);
+    file_pipeline_t pipeline;
+    if (!file_pipeline_start(&pipeline, base_dir, config)) {
+        if (!from_stdin) {
+            fclose(list);
+        }
+        return 1;
+    }
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+    int delimiter = null_separated ? '\0' : '\n';
+    while ((length = getdelim(&line, &line_capacity, delimiter, list)) != -1) {
+        while (length > 0 && (line[length - 1] == (char)delimiter || (!null_separated && line[length - 1] == '\r'))) {
+            line[--length] = '\0';
+        }
+        if (length == 0) {
+            continue;
+        }
+        const char *file_name = strrchr(line, '/');
+        struct stat file_stat;
+        if (!has_shell_script_extension(file_name ? file_name + 1 : line)) {
+            continue;
         }
+        if (stat(line, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+            debug_message(config, "Ignoring listed path %s: not a regular file\n", line);
+            continue;
+        }
+        file_pipeline_submit(&pipeline, line);
+    }
+    free(line);
+    if (!from_stdin) {
+        fclose(list);
+    }
+    int result = file_pipeline_finish(&pipeline);
+    if (pipeline.total_files <= 0) {
+        fprintf(stderr, "No shell scripts to process\n");
     }
 
     return result;
 }
 
 /**
- * @brief Process a single file
+ * @brief Signal handler stopping watch mode
  * 
- * This function processes a single file and generates documentation.
+ * @param signal_number The received signal
+ */
+static void handle_watch_signal(int signal_number) {
+    (void)signal_number;
+    watch_interrupted = 1;
+}
+
+/**
+ * @brief Process a directory, then keep its documentation up to date
  * 
- * @param input_file The input file to process
+ * This function documents the whole directory once, then watches the directory
+ * tree for changes until interrupted. Changes are debounced: documentation is
+ * regenerated once no change has been seen for WATCH_DEBOUNCE_MS, and only for
+ * the scripts that changed. Thanks to the build manifest, documentation of
+ * deleted scripts is removed at the same time. The documentation directory is
+ * excluded from the watched tree, since writing to it would otherwise trigger
+ * another regeneration.
+ * 
+ * @param input_file The directory to watch
  * @param config The configuration
  * @return int 0 on success, 1 on failure
  */
-static int process_files(char **files, int file_count, const char *base_dir, const shellscribe_config_t *config) {
-    int failed_files = 0;
-    int processed_files = 0;
-    int skipped_files = 0;
-    for (int i = 0; i < file_count; i++) {
-        const char *file_path = files[i];
-        char *display_path = get_relative_path(file_path, base_dir);
-        if (!process_single_file(file_path, display_path, config, &processed_files, &skipped_files, &failed_files)) {
+static int watch_directory(const char *input_file, const shellscribe_config_t *config) {
+    watcher_t *watcher = watcher_create();
+    if (watcher == NULL || !watcher_exclude(watcher, config->doc_path) || !watcher_add_tree(watcher, input_file)) {
+        fprintf(stderr, "Error: unable to watch directory %s\n", input_file);
+        watcher_free(watcher);
+        return 1;
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_watch_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    process_directory(input_file, config);
+    fprintf(stderr, "\nWatching %s for changes (press Ctrl+C to stop)\n", input_file);
+    while (!watch_interrupted) {
+        if (watcher_poll(watcher, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Error: unable to read directory changes\n");
+            break;
+        }
+        while (!watch_interrupted && watcher_poll(watcher, WATCH_DEBOUNCE_MS) > 0) {
             continue;
         }
+        size_t path_count = 0;
+        char **paths = watcher_take_changes(watcher, &path_count);
+        if (!watch_interrupted && path_count > 0) {
+            process_changes(paths, path_count, input_file, config);
+        }
+        watcher_free_changes(paths, path_count);
     }
-    fprintf(stderr, "\nSummary: %d OK, %d SKIPPED, %d FAILED (total: %d)\n", processed_files, skipped_files, failed_files, file_count);
+    watcher_free(watcher);
 
-    return (failed_files > 0) ? 1 : 0;
+    return 0;
 }
 
 /**
- * @brief Process a single file
+ * @brief Check whether a path is inside a directory that was already walked
  * 
- * This function processes a single file and generates documentation.
+ * @param walked The directories already walked
+ * @param walked_count The number of directories already walked
+ * @param path The path to check
+ * @return bool True if the path is inside one of the directories
+ */
+static bool is_inside_walked_directory(char **walked, size_t walked_count, const char *path) {
+    for (size_t i = 0; i < walked_count; i++) {
+        size_t len = strlen(walked[i]);
+        if (strncmp(path, walked[i], len) == 0 && path[len] == '/') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Regenerate the documentation affected by a set of changed paths
  * 
- * @param file_path The input file to process
- * @param display_path The display path for the file
+ * Changed scripts are documented again; changed directories (created, moved
+ * in, or rescanned after an event overflow) are walked for scripts, and paths
+ * inside a walked directory are not processed a second time. Deleted
+ * paths need no processing: the build manifest removes the documentation of
+ * scripts that no longer exist when the pipeline finishes.
+ * 
+ * @param paths The changed paths, sorted
+ * @param path_count The number of changed paths
+ * @param base_dir The watched directory
  * @param config The configuration
- * @param processed_files Pointer to store the number of processed files
- * @param skipped_files Pointer to store the number of skipped files
- * @param failed_files Pointer to store the number of failed files
- * @return bool True if processing was successful, false otherwise
  */
-static bool process_single_file(const char *file_path, char *display_path, const shellscribe_config_t *config, int *processed_files, int *skipped_files, int *failed_files) {
-    if (display_path == NULL) {
-        const char *base_name = strrchr(file_path, '/');
-        base_name = base_name ? base_name + 1 : file_path;
-        fprintf(stderr, "%-40s ", base_name);
-    } else {
-        fprintf(stderr, "%-40s ", display_path);
+static void process_changes(char **paths, size_t path_count, const char *base_dir, const shellscribe_config_t *config) {
+    file_pipeline_t pipeline;
+    if (!file_pipeline_start(&pipeline, base_dir, config)) {
+        return;
+    }
+    fprintf(stderr, "\nChanges detected in %s\n", base_dir);
+    size_t walked_count = 0;
+    for (size_t i = 0; i < path_count; i++) {
+        if (is_inside_walked_directory(paths, walked_count, paths[i])) {
+            continue;
+        }
+        struct stat file_stat;
+        if (stat(paths[i], &file_stat) != 0) {
+            continue;
+        }
+        if (S_ISDIR(file_stat.st_mode)) {
+            get_shell_scripts(paths[i], &pipeline, config);
+            char *walked = paths[walked_count];
+            paths[walked_count++] = paths[i];
+            paths[i] = walked;
+        } else if (S_ISREG(file_stat.st_mode)) {
+            const char *file_name = strrchr(paths[i], '/');
+            if (has_shell_script_extension(file_name ? file_name + 1 : paths[i])) {
+                file_pipeline_submit(&pipeline, paths[i]);
+            }
+        }
     }
-    char *skip_reason = NULL;
-    if (should_skip_file(file_path, config, &skip_reason)) {
-        handle_skipped_file(skip_reason, display_path, skipped_files);
+    file_pipeline_finish(&pipeline);
+}
+
+/**
+ * @brief Start a file processing pipeline
+ * 
+ * This function creates the worker pool that generates documentation for the
+ * files submitted to the pipeline, and loads the incremental build manifest of
+ * the documentation directory. At most FILES_IN_FLIGHT_PER_JOB files per
+ * worker thread are kept in memory at any time. Output directories created or
+ * found during the run are remembered by all worker threads.
+ * 
+ * @param pipeline The pipeline to initialize
+ * @param base_dir The base directory used to compute display paths
+ * @param config The configuration
+ * @return bool True if the pipeline was started, false otherwise
+ */
+static bool file_pipeline_start(file_pipeline_t *pipeline, const char *base_dir, const shellscribe_config_t *config) {
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->base_dir = base_dir;
+    pipeline->config = config;
+    pipeline->manifest = manifest_load(config->doc_path, config);
+    if (pipeline->manifest == NULL) {
+        fprintf(stderr, "Error: unable to load the build manifest\n");
         return false;
     }
-    if (!generate_documentation(file_path, display_path, config)) {
-        (*failed_files)++;
+    pipeline->known_dirs = string_set_create();
+    int jobs = (config->jobs > 0) ? config->jobs : worker_pool_default_jobs();
+    debug_message(config, "Processing files with %d worker threads\n", jobs);
+    pipeline->pool = worker_pool_create(jobs, (size_t)jobs * FILES_IN_FLIGHT_PER_JOB, process_file_task, report_file_task, pipeline);
+    if (pipeline->pool == NULL) {
+        fprintf(stderr, "Error: unable to start file processing\n");
+        manifest_free(pipeline->manifest);
+        pipeline->manifest = NULL;
+        string_set_free(pipeline->known_dirs);
+        pipeline->known_dirs = NULL;
         return false;
     }
-    fprintf(stderr, STATUS_OK "\n");
-    (*processed_files)++;
+
     return true;
 }
 
 /**
- * @brief Handle skipped file
+ * @brief Submit a file to a file processing pipeline
  * 
- * This function handles a skipped file by printing the reason and updating the count.
+ * This function queues a file for documentation generation. It blocks while
+ * the pipeline is full, printing the status lines of the completed files.
+ * With the sort_files option, the file is held back instead, and files are
+ * processed in path order once the pipeline is finished.
  * 
- * @param skip_reason The reason for skipping the file
- * @param display_path The display path for the file
- * @param skipped_files Pointer to store the number of skipped files
+ * @param pipeline The pipeline
+ * @param file_path The file to process
  */
-static void handle_skipped_file(char *skip_reason, char *display_path, int *skipped_files) {
-    if (strstr(skip_reason, "marked with @skip") != NULL) {
-        fprintf(stderr, STATUS_SKIPPED " (marked with %s)\n", SKIP_TAG);
-    } else {
-        fprintf(stderr, STATUS_SKIPPED " (%s)\n", skip_reason);
+static void file_pipeline_submit(file_pipeline_t *pipeline, const char *file_path) {
+    if (pipeline->config->sort_files) {
+        if (!file_pipeline_defer(pipeline, file_path)) {
+            fprintf(stderr, "Error: Failed to allocate memory for file path\n");
+            pipeline->total_files++;
+            pipeline->failed_files++;
+        }
+        return;
     }
-    if (skip_reason) {
-        void *reason_ptr = skip_reason;
-        shell_free(&reason_ptr);
+    file_pipeline_enqueue(pipeline, file_path);
+}
+
+/**
+ * @brief Queue a file in the worker pool of a file processing pipeline
+ * 
+ * @param pipeline The pipeline
+ * @param file_path The file to process
+ */
+static void file_pipeline_enqueue(file_pipeline_t *pipeline, const char *file_path) {
+    char *display_path = get_relative_path(file_path, pipeline->base_dir);
+    file_task_t *task = create_file_task(file_path, display_path);
+    shell_free((void **)&display_path);
+    pipeline->total_files++;
+    if (task == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for file path\n");
+        pipeline->failed_files++;
+        return;
     }
-    if (display_path) {
-        void *ptr = display_path;
-        shell_free(&ptr);
+    worker_pool_submit(pipeline->pool, task);
+}
+
+/**
+ * @brief Hold back a file until the file processing pipeline is finished
+ * 
+ * @param pipeline The pipeline
+ * @param file_path The file to process
+ * @return bool True on success, false on allocation failure
+ */
+static bool file_pipeline_defer(file_pipeline_t *pipeline, const char *file_path) {
+    if (pipeline->deferred_count == pipeline->deferred_capacity) {
+        size_t new_capacity = (pipeline->deferred_capacity == 0) ? 64 : pipeline->deferred_capacity * 2;
+        char **new_files = (char **)shell_realloc(pipeline->deferred_files, new_capacity * sizeof(char *));
+        if (new_files == NULL) {
+            return false;
+        }
+        pipeline->deferred_files = new_files;
+        pipeline->deferred_capacity = new_capacity;
+    }
+    char *copy = shell_strdup(file_path);
+    if (copy == NULL) {
+        return false;
     }
-    (*skipped_files)++;
+    pipeline->deferred_files[pipeline->deferred_count++] = copy;
+    return true;
 }
 
 /**
- * @brief Generate documentation for a file
+ * @brief Compare two file paths for qsort()
  * 
- * This function generates documentation for a file and writes it to the output path.
+ * @param a Pointer to the first path
+ * @param b Pointer to the second path
+ * @return int Result of strcmp()
+ */
+static int compare_file_paths(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/**
+ * @brief Finish a file processing pipeline
+ * 
+ * This function processes the deferred files in path order, waits for every
+ * submitted file, prints the remaining status lines, saves the build manifest
+ * (removing the documentation of deleted scripts), prints the final summary
+ * and releases the pipeline.
+ * 
+ * @param pipeline The pipeline
+ * @return int 0 on success, 1 on failure
+ */
+static int file_pipeline_finish(file_pipeline_t *pipeline) {
+    if (pipeline->deferred_count > 0) {
+        qsort(pipeline->deferred_files, pipeline->deferred_count, sizeof(char *), compare_file_paths);
+    }
+    for (size_t i = 0; i < pipeline->deferred_count; i++) {
+        file_pipeline_enqueue(pipeline, pipeline->deferred_files[i]);
+        shell_free((void **)&pipeline->deferred_files[i]);
+    }
+    shell_free((void **)&pipeline->deferred_files);
+    pipeline->deferred_count = 0;
+    pipeline->deferred_capacity = 0;
+    worker_pool_finish(pipeline->pool);
+    pipeline->pool = NULL;
+    int pruned_files = manifest_save(pipeline->manifest);
+    if (pruned_files < 0) {
+        fprintf(stderr, "Warning: unable to save the build manifest\n");
+    } else if (pruned_files > 0) {
+        fprintf(stderr, "Removed %d outdated documentation file(s)\n", pruned_files);
+    }
+    manifest_free(pipeline->manifest);
+    pipeline->manifest = NULL;
+    string_set_free(pipeline->known_dirs);
+    pipeline->known_dirs = NULL;
+    if (pipeline->total_files <= 0) {
+        return 0;
+    }
+    fprintf(stderr, "\nSummary: %d OK (%d unchanged), %d SKIPPED, %d FAILED (total: %d)\n", pipeline->processed_files, pipeline->unchanged_files, pipeline->skipped_files, pipeline->failed_files, pipeline->total_files);
+
+    return (pipeline->failed_files > 0) ? 1 : 0;
+}
+
+/**
+ * @brief Create a file task
  * 
  * @param file_path The input file to process
- * @param display_path The display path for the file
+ * @param display_path The path displayed in the status line (can be NULL)
+ * @return file_task_t* The new task, or NULL if memory allocation failed
+ */
+static file_task_t *create_file_task(const char *file_path, const char *display_path) {
+    file_task_t *task = (file_task_t *)shell_calloc(1, sizeof(file_task_t));
+    if (task == NULL) {
+        return NULL;
+    }
+    task->file_path = shell_strdup(file_path);
+    task->display_path = display_path ? shell_strdup(display_path) : NULL;
+    if (task->file_path == NULL || (display_path != NULL && task->display_path == NULL)) {
+        free_file_task(task);
+        return NULL;
+    }
+    task->status = FILE_STATUS_OK;
+
+    return task;
+}
+
+/**
+ * @brief Free a file task
+ * 
+ * @param task The task to free (can be NULL)
+ */
+static void free_file_task(file_task_t *task) {
+    if (task == NULL) {
+        return;
+    }
+    shell_free((void **)&task->file_path);
+    shell_free((void **)&task->display_path);
+    shell_free((void **)&task->output_path);
+    shell_free((void **)&task);
+}
+
+/**
+ * @brief Worker pool task processing one file of a pipeline
+ * 
+ * This function runs on a worker thread and only records the outcome of the
+ * processing; reporting is left to report_file_task().
+ * 
+ * @param item The file task
+ * @param user_data The file pipeline
+ */
+static void process_file_task(void *item, void *user_data) {
+    file_pipeline_t *pipeline = (file_pipeline_t *)user_data;
+    process_single_file((file_task_t *)item, pipeline->config, pipeline->manifest, pipeline->known_dirs);
+}
+
+/**
+ * @brief Worker pool completion callback reporting one file of a pipeline
+ * 
+ * This function runs on the submitting thread, in input order, prints the
+ * status line of the file, updates the pipeline counters and the build
+ * manifest, and frees the task.
+ * 
+ * @param item The file task
+ * @param user_data The file pipeline
+ */
+static void report_file_task(void *item, void *user_data) {
+    file_pipeline_t *pipeline = (file_pipeline_t *)user_data;
+    file_task_t *task = (file_task_t *)item;
+    report_file_status(task);
+    manifest_record(pipeline->manifest, task->file_path, task->output_path, &task->stamp);
+    switch (task->status) {
+        case FILE_STATUS_OK:
+            pipeline->processed_files++;
+            break;
+        case FILE_STATUS_UNCHANGED:
+            pipeline->processed_files++;
+            pipeline->unchanged_files++;
+            break;
+        case FILE_STATUS_SKIPPED:
+            pipeline->skipped_files++;
+            break;
+        case FILE_STATUS_FAILED:
+            pipeline->failed_files++;
+            break;
+    }
+    free_file_task(task);
+}
+
+/**
+ * @brief Record the outcome of a processed file
+ * 
+ * @param task The processed file
+ * @param status The outcome of the processing
+ * @param message The skip reason or error description (can be NULL)
+ * @return bool True if the file was processed successfully, false otherwise
+ */
+static bool set_file_status(file_task_t *task, file_status_t status, const char *message) {
+    task->status = status;
+    task->message = message;
+    return (status == FILE_STATUS_OK || status == FILE_STATUS_UNCHANGED);
+}
+
+/**
+ * @brief Process a single file
+ * 
+ * This function processes a single file and generates documentation. The file is
+ * read once; the binary check, the @skip check and the rendering all work on
+ * that copy. The header is probed first, so that binaries and scripts whose
+ * header is marked with @skip are not parsed at all. When a build manifest is
+ * given, the file is not parsed if its documentation is up to date: first by
+ * comparing its size and modification time, then, if only the modification
+ * time changed, its content hash. It does not print anything, so that it can
+ * safely run on a worker thread.
+ * 
+ * @param task The file to process, updated with the outcome of the processing
  * @param config The configuration
+ * @param manifest The build manifest (can be NULL to always generate documentation)
+ * @param known_dirs Output directories known to exist (can be NULL)
+ * @return bool True if processing was successful, false otherwise
+ */
+static bool process_single_file(file_task_t *task, const shellscribe_config_t *config, const manifest_t *manifest, string_set_t *known_dirs) {
+    char output_path[PATH_MAX];
+    const char *error = NULL;
+    if (!get_output_path(task, config, output_path, &error)) {
+        return set_file_status(task, FILE_STATUS_FAILED, error);
+    }
+    if (manifest != NULL) {
+        struct stat file_stat;
+        if (stat(task->file_path, &file_stat) != 0) {
+            return set_file_status(task, FILE_STATUS_FAILED, "error reading input file");
+        }
+        manifest_stamp_from_stat(&task->stamp, &file_stat);
+        if (manifest_is_current(manifest, task->file_path, output_path, &task->stamp)) {
+            task->output_path = shell_strdup(output_path);
+            return set_file_status(task, FILE_STATUS_UNCHANGED, NULL);
+        }
+    }
+    shellscribe_source_t source;
+    if (!load_shell_script(task->file_path, &source)) {
+        return set_file_status(task, FILE_STATUS_FAILED, "error reading input file");
+    }
+    shellscribe_probe_t probe;
+    if (!probe_shell_source(&source, SHELLSCRIBE_PROBE_DEFAULT_SIZE, &probe)) {
+        free_shell_script(&source);
+        return set_file_status(task, FILE_STATUS_FAILED, "error parsing documentation");
+    }
+    if (probe.is_binary) {
+        free_shell_script(&source);
+        return set_file_status(task, FILE_STATUS_SKIPPED, probe.is_elf ? SKIP_REASON_ELF : SKIP_REASON_BINARY);
+    }
+    if (manifest != NULL) {
+        task->stamp.hash = manifest_hash(source.data, source.length);
+        if (manifest_is_current(manifest, task->file_path, output_path, &task->stamp)) {
+            free_shell_script(&source);
+            task->output_path = shell_strdup(output_path);
+            return set_file_status(task, FILE_STATUS_UNCHANGED, NULL);
+        }
+    }
+    if (probe.is_skipped) {
+        free_shell_script(&source);
+        return set_file_status(task, FILE_STATUS_SKIPPED, SKIP_REASON_MARKED);
+    }
+    int block_count = 0;
+    shellscribe_docblock_t *docblocks = parse_shell_source(task->file_path, &source, &block_count, config);
+    free_shell_script(&source);
+    if (docblocks == NULL || block_count <= 0) {
+        return set_file_status(task, FILE_STATUS_FAILED, "error parsing documentation");
+    }
+    if (docblocks[0].is_skipped) {
+        free_docblocks(docblocks, block_count);
+        return set_file_status(task, FILE_STATUS_SKIPPED, SKIP_REASON_MARKED);
+    }
+    bool unchanged = false;
+    bool success = generate_documentation(output_path, docblocks, block_count, config, known_dirs, &unchanged, &error);
+    free_docblocks(docblocks, block_count);
+    if (!success) {
+        return set_file_status(task, FILE_STATUS_FAILED, error);
+    }
+    task->output_path = shell_strdup(output_path);
+    return set_file_status(task, unchanged ? FILE_STATUS_UNCHANGED : FILE_STATUS_OK, NULL);
+}
+
+/**
+ * @brief Report the status of a processed file
+ * 
+ * This function prints the status line of a processed file.
+ * 
+ * @param task The processed file
+ */
+static void report_file_status(const file_task_t *task) {
+    const char *name = task->display_path;
+    if (name == NULL) {
+        name = strrchr(task->file_path, '/');
+        name = name ? name + 1 : task->file_path;
+    }
+    fprintf(stderr, "%-40s ", name);
+    switch (task->status) {
+        case FILE_STATUS_OK:
+            fprintf(stderr, STATUS_OK "\n");
+            break;
+        case FILE_STATUS_UNCHANGED:
+            fprintf(stderr, STATUS_OK " (up to date)\n");
+            break;
+        case FILE_STATUS_SKIPPED:
+            if (task->message != NULL && strcmp(task->message, SKIP_REASON_MARKED) == 0) {
+                fprintf(stderr, STATUS_SKIPPED " (marked with %s)\n", SKIP_TAG);
+            } else {
+                fprintf(stderr, STATUS_SKIPPED " (%s)\n", task->message ? task->message : "unknown reason");
+            }
+            break;
+        case FILE_STATUS_FAILED:
+            fprintf(stderr, STATUS_FAILED " (%s)\n", task->message ? task->message : "unknown error");
+            break;
+    }
+}
+
+/**
+ * @brief Generate documentation for a file
+ * 
+ * This function renders the parsed documentation blocks of a file into memory
+ * and compares them with the existing documentation file. The file is only
+ * written when its content changes, so that its modification time is kept
+ * otherwise; it is written to a temporary file renamed into place, so that
+ * readers never see a partially written file.
+ * 
+ * @param output_path The documentation file to write
+ * @param docblocks The documentation blocks parsed from the file
+ * @param block_count The number of documentation blocks
+ * @param config The configuration
+ * @param known_dirs Output directories known to exist (can be NULL)
+ * @param unchanged Pointer to store whether the existing file was already identical
+ * @param error Pointer to store a description of the error on failure
  * @return bool True if generation was successful, false otherwise
  */
-static bool generate_documentation(const char *file_path, char *display_path, const shellscribe_config_t *config) {
-    char *relative_path = display_path ? shell_strdup(display_path) : get_relative_path(file_path, config->filename);
-    if (relative_path == NULL) {
-        fprintf(stderr, STATUS_FAILED " (error determining relative path)\n");
+static bool generate_documentation(const char *output_path, const shellscribe_docblock_t *docblocks, int block_count, const shellscribe_config_t *config, string_set_t *known_dirs, bool *unchanged, const char **error) {
+    char *data = NULL;
+    size_t length = 0;
+    FILE *output = open_memstream(&data, &length);
+    if (output == NULL) {
+        *error = "error generating documentation";
         return false;
     }
-    char output_path[PATH_MAX];
-    if (!prepare_output_path(relative_path, config, output_path)) {
-        shell_free((void **)&relative_path);
+    bool success = render_documentation(docblocks, block_count, output, config);
+    if (fclose(output) != 0 || !success) {
+        free(data);
+        *error = "error generating documentation";
         return false;
     }
-    shell_free((void **)&relative_path);
-    FILE *output = fopen(output_path, "w");
-    if (output == NULL) {
-        fprintf(stderr, STATUS_FAILED " (error opening output file)\n");
+    *unchanged = is_file_identical(output_path, data, length);
+    if (!*unchanged) {
+        if (!create_output_directory(output_path, known_dirs, error)) {
+            free(data);
+            return false;
+        }
+        if (!write_file_atomically(output_path, data, length)) {
+            free(data);
+            *error = "error writing output file";
+            return false;
+        }
+    }
+    free(data);
+
+    return true;
+}
+
+/**
+ * @brief Check whether a file already has the given content
+ * 
+ * Sizes are compared first, so that the file is only read when it may be identical.
+ * 
+ * @param path The file
+ * @param data The expected content
+ * @param length The length of the expected content
+ * @return bool True if the file exists and has exactly this content
+ */
+static bool is_file_identical(const char *path, const char *data, size_t length) {
+    struct stat file_stat;
+    if (stat(path, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || (size_t)file_stat.st_size != length) {
         return false;
     }
-    int block_count = 0;
-    shellscribe_docblock_t *docblocks = parse_shell_script(file_path, &block_count, config);
-    if (docblocks == NULL || block_count <= 0) {
-        fprintf(stderr, STATUS_FAILED " (error parsing documentation)\n");
-        fclose(output);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
         return false;
     }
-    bool success = render_documentation((const shellscribe_docblock_t *)docblocks, block_count, output, config);
-    free_docblocks(docblocks, block_count);
-    fclose(output);
-    if (!success) {
-        fprintf(stderr, STATUS_FAILED " (error generating documentation)\n");
+    char buffer[16 * 1024];
+    size_t offset = 0;
+    bool identical = true;
+    while (identical) {
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            identical = false;
+        } else if (count == 0) {
+            identical = (offset == length);
+            break;
+        } else if ((size_t)count > length - offset || memcmp(buffer, data + offset, (size_t)count) != 0) {
+            identical = false;
+        } else {
+            offset += (size_t)count;
+        }
+    }
+    close(fd);
+
+    return identical;
+}
+
+/**
+ * @brief Replace the content of a file atomically
+ * 
+ * The content is written to a temporary file in the same directory, which is
+ * then renamed over the file. Temporary names are unique per call, so that
+ * several threads can write files of the same directory.
+ * 
+ * @param path The file
+ * @param data The content
+ * @param length The length of the content
+ * @return bool True on success, false otherwise
+ */
+static bool write_file_atomically(const char *path, const char *data, size_t length) {
+    char temp_path[PATH_MAX];
+    if (!make_temp_path(path, temp_path, sizeof(temp_path))) {
+        return false;
+    }
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t count = write(fd, data + offset, length - offset);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += (size_t)count;
+    }
+    if (close(fd) != 0 || offset < length || rename(temp_path, path) != 0) {
+        unlink(temp_path);
         return false;
     }
 
@@ -614,44 +1312,68 @@ static bool generate_documentation(const char *file_path, char *display_path, co
 }
 
 /**
- * @brief Prepare the output path for the generated documentation
+ * @brief Get the output path of the documentation of a file
  * 
- * This function prepares the output path for the generated documentation.
+ * This function computes where the documentation of a file is written, from
+ * its path relative to the processed directory.
  * 
- * @param relative_path The relative path to process
+ * @param task The file to process
  * @param config The configuration
  * @param output_path The output path to store the result
- * @return bool True if preparation was successful, false otherwise
+ * @param error Pointer to store a description of the error on failure
+ * @return bool True if the output path was computed, false otherwise
  */
-static bool prepare_output_path(const char *relative_path, const shellscribe_config_t *config, char *output_path) {
-    char dir_path[PATH_MAX] = {0};
-    char *last_slash = strrchr(relative_path, '/');
-    if (last_slash) {
-        strncpy(dir_path, relative_path, last_slash - relative_path);
-        dir_path[last_slash - relative_path] = '\0';
-
-        char doc_path_path[PATH_MAX];
-        snprintf(doc_path_path, sizeof(doc_path_path), "%s/%s", config->doc_path, dir_path);
-        if (!create_directories_recursive(doc_path_path)) {
-            fprintf(stderr, STATUS_FAILED " (error creating output directory)\n");
-            return false;
-        }
+static bool get_output_path(const file_task_t *task, const shellscribe_config_t *config, char *output_path, const char **error) {
+    char *relative_path = task->display_path ? shell_strdup(task->display_path) : get_relative_path(task->file_path, config->filename);
+    if (relative_path == NULL) {
+        *error = "error determining relative path";
+        return false;
     }
+    build_output_path(relative_path, config, output_path);
+    shell_free((void **)&relative_path);
+
+    return true;
+}
+
+/**
+ * @brief Build the output path for the generated documentation
+ * 
+ * The documentation of dir/script.sh is written to <doc_path>/dir/script.md.
+ * 
+ * @param relative_path The relative path to process
+ * @param config The configuration
+ * @param output_path The output path to store the result
+ */
+static void build_output_path(const char *relative_path, const shellscribe_config_t *config, char *output_path) {
+    const char *last_slash = strrchr(relative_path, '/');
     const char *output_base_name = last_slash ? last_slash + 1 : relative_path;
-    char *ext = strrchr(output_base_name, '.');
+    const char *ext = strrchr(output_base_name, '.');
+    int name_len = ext ? (int)(ext - output_base_name) : (int)strlen(output_base_name);
     if (last_slash) {
-        if (ext) {
-            int name_len = ext - output_base_name;
-            snprintf(output_path, PATH_MAX, "%s/%s/%.*s.md", config->doc_path, dir_path, name_len, output_base_name);
-        } else {
-            snprintf(output_path, PATH_MAX, "%s/%s/%s.md", config->doc_path, dir_path, output_base_name);
-        }
+        int dir_len = (int)(last_slash - relative_path);
+        snprintf(output_path, PATH_MAX, "%s/%.*s/%.*s.md", config->doc_path, dir_len, relative_path, name_len, output_base_name);
     } else {
-        if (ext) {
-            int name_len = ext - output_base_name;
-            snprintf(output_path, PATH_MAX, "%s/%.*s.md", config->doc_path, name_len, output_base_name);
-        } else {
-            snprintf(output_path, PATH_MAX, "%s/%s.md", config->doc_path, output_base_name);
+        snprintf(output_path, PATH_MAX, "%s/%.*s.md", config->doc_path, name_len, output_base_name);
+    }
+}
+
+/**
+ * @brief Create the directory of an output file
+ * 
+ * @param output_path The output file
+ * @param known_dirs Directories known to exist (can be NULL)
+ * @param error Pointer to store a description of the error on failure
+ * @return bool True if the directory exists or was created, false otherwise
+ */
+static bool create_output_directory(const char *output_path, string_set_t *known_dirs, const char **error) {
+    char dir_path[PATH_MAX];
+    snprintf(dir_path, sizeof(dir_path), "%s", output_path);
+    char *last_slash = strrchr(dir_path, '/');
+    if (last_slash != NULL) {
+        *last_slash = '\0';
+        if (!create_directories_recursive(dir_path, known_dirs)) {
+            *error = "error creating output directory";
+            return false;
         }
     }
 
@@ -670,15 +1392,116 @@ static bool prepare_output_path(const char *relative_path, const shellscribe_con
 static int process_file(const char *input_file, const shellscribe_config_t *config) {
     const char *base_name = strrchr(input_file, '/');
     base_name = base_name ? base_name + 1 : input_file;
-    fprintf(stderr, "%-40s ", base_name);
-    char *skip_reason = NULL;
-    if (should_skip_file(input_file, config, &skip_reason)) {
-        handle_skipped_file(skip_reason, NULL, NULL);
-        return 0;
-    }
-    if (!generate_documentation(input_file, NULL, config)) {
+    file_task_t *task = create_file_task(input_file, base_name);
+    if (task == NULL) {
+        fprintf(stderr, "Error: unable to allocate memory for file processing\n");
         return 1;
     }
+    process_single_file(task, config, NULL, NULL);
+    report_file_status(task);
+    int result = (task->status == FILE_STATUS_FAILED) ? 1 : 0;
+    free_file_task(task);
 
-    return 0;
+    return result;
+}
+
+/**
+ * @brief List a shell script with its brief
+ * 
+ * This function probes the header of a script and prints its path, followed
+ * by a tab and its file-level brief when it has one. Binaries and scripts
+ * whose header is marked with @skip are left out. With the sort option, the
+ * line is held back until the walk completes.
+ * 
+ * @param path The path of the shell script
+ * @param user_data The script list
+ */
+static void list_shell_script(const char *path, void *user_data) {
+    script_list_t *list = (script_list_t *)user_data;
+    shellscribe_probe_t probe;
+    if (!probe_shell_script(path, SHELLSCRIBE_PROBE_DEFAULT_SIZE, &probe)) {
+        fprintf(stderr, "Error: unable to read file %s\n", path);
+        list->failed++;
+        return;
+    }
+    if (probe.is_binary || probe.is_skipped) {
+        free_shell_probe(&probe);
+        return;
+    }
+    char *display_path = (list->base_dir != NULL) ? get_relative_path(path, list->base_dir) : NULL;
+    string_builder_t builder;
+    string_builder_init(&builder, NULL);
+    bool success = string_builder_append(&builder, display_path ? display_path : path);
+    if (success && probe.brief != NULL) {
+        success = string_builder_append(&builder, "\t") && string_builder_append(&builder, probe.brief);
+    }
+    char *line = success ? string_builder_finish(&builder) : NULL;
+    string_builder_free(&builder);
+    shell_free((void **)&display_path);
+    free_shell_probe(&probe);
+    if (line == NULL) {
+        fprintf(stderr, "Error: unable to list file %s\n", path);
+        list->failed++;
+        return;
+    }
+    if (!list->sort) {
+        printf("%s\n", line);
+        shell_free((void **)&line);
+        return;
+    }
+    if (list->count == list->capacity) {
+        size_t new_capacity = (list->capacity > 0) ? list->capacity * 2 : 64;
+        char **new_lines = (char **)shell_realloc(list->lines, new_capacity * sizeof(char *));
+        if (new_lines == NULL) {
+            printf("%s\n", line);
+            shell_free((void **)&line);
+            return;
+        }
+        list->lines = new_lines;
+        list->capacity = new_capacity;
+    }
+    list->lines[list->count++] = line;
+}
+
+/**
+ * @brief List the shell scripts of a directory or a single script
+ * 
+ * This function prints the inventory of the scripts with their briefs on the
+ * standard output. Only the header of each script is read, so that listing a
+ * whole tree does not cost parsing it.
+ * 
+ * @param input_path The directory or the script to list
+ * @param is_dir Whether the input path is a directory
+ * @param config The configuration
+ * @return int 0 on success, 1 on failure
+ */
+static int list_scripts(const char *input_path, bool is_dir, const shellscribe_config_t *config) {
+    script_list_t list = {
+        .base_dir = is_dir ? input_path : NULL,
+        .sort = config->sort_files
+    };
+    if (!is_dir) {
+        list_shell_script(input_path, &list);
+    } else {
+        dir_walker_options_t options = {
+            .traverse_symlinks = config->traverse_symlinks,
+            .match = has_shell_script_extension,
+            .visit = list_shell_script,
+            .user_data = &list
+        };
+        if (dir_walker_walk(input_path, &options) <= 0) {
+            fprintf(stderr, "Error: No shell scripts found in directory\n");
+            return 1;
+        }
+    }
+    if (list.count > 0) {
+        qsort(list.lines, list.count, sizeof(char *), compare_file_paths);
+    }
+    for (size_t i = 0; i < list.count; i++) {
+        printf("%s\n", list.lines[i]);
+        shell_free((void **)&list.lines[i]);
+    }
+    shell_free((void **)&list.lines);
+
+    return (list.failed > 0) ? 1 : 0;
 }
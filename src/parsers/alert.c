@@ -9,7 +9,9 @@
  */
 
 #include "parsers/alert.h"
+#include "parsers/state.h"
 #include "utils/string.h"
+#include "utils/intern.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -52,8 +54,9 @@ bool is_alert_tag(const char *tag) {
  * @brief Get the standardized alert type code based on the tag name
  *
  * Maps the various alert tag names to their corresponding standardized
- * type codes. This normalization ensures consistent rendering regardless
- * of which synonym was used in the source documentation.
+ * type codes, as defined by the tag table of the parser. This normalization
+ * ensures consistent rendering regardless of which synonym was used in the
+ * source documentation.
  *
  * @param tag The alert tag name to convert to a type code
  *
@@ -62,33 +65,19 @@ bool is_alert_tag(const char *tag) {
  *
  * @note Some tags are mapped to the same type code:
  *       - "hint" is mapped to "TIP"
+ *       - "error" and "alert" are mapped to "NOTE"
  *       - Any unrecognized tag is mapped to "NOTE"
  * @note The returned string is a static constant and should not be freed.
+ *
+ * @see get_tag_spec
  */
 const char *get_alert_type(const char *tag) {
     if (tag == NULL) {
         return "NOTE";
     }
+    const char *alert_type = get_tag_spec(tag_lookup(tag, strlen(tag)))->alert_type;
     
-    if (strcmp(tag, "note") == 0) {
-        return "NOTE";
-    } else if (strcmp(tag, "tip") == 0) {
-        return "TIP";
-    } else if (strcmp(tag, "important") == 0) {
-        return "IMPORTANT";
-    } else if (strcmp(tag, "warning") == 0) {
-        return "WARNING";
-    } else if (strcmp(tag, "caution") == 0) {
-        return "CAUTION";
-    } else if (strcmp(tag, "info") == 0) {
-        return "INFO";
-    } else if (strcmp(tag, "danger") == 0) {
-        return "DANGER";
-    } else if (strcmp(tag, "hint") == 0) {
-        return "TIP";
-    }
-    
-    return "NOTE";
+    return (alert_type != NULL) ? alert_type : "NOTE";
 }
 
 /**
@@ -105,8 +94,8 @@ const char *get_alert_type(const char *tag) {
  * @return bool true if the alert was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  *
- * @note Memory is allocated for the alert type and content, which will be
- *       freed when the docblock is freed.
+ * @note The alert type is interned, and the content allocated in the arena
+ *       of the docblock.
  * @note If memory allocation fails, the function returns false and no alert
  *       is added to the docblock.
  *
@@ -114,18 +103,39 @@ const char *get_alert_type(const char *tag) {
  * @see is_alert_tag
  */
 bool process_alert_tag(shellscribe_docblock_t *docblock, const char *tag, const char *content) {
-    if (docblock == NULL || tag == NULL || content == NULL) {
+    if (tag == NULL) {
+        return false;
+    }
+    
+    return add_alert_to_docblock(docblock, get_alert_type(tag), content);
+}
+
+/**
+ * @brief Add an alert of a given type to a documentation block
+ *
+ * @param docblock The documentation block to add the alert to
+ * @param alert_type The standardized type code of the alert (e.g., "NOTE", "TIP")
+ * @param content The content/message of the alert
+ *
+ * @return bool true if the alert was successfully added to the docblock,
+ *              false if an error occurred or if required parameters are NULL
+ *
+ * @note The alert type is interned, and the content allocated in the arena
+ *       of the docblock.
+ */
+bool add_alert_to_docblock(shellscribe_docblock_t *docblock, const char *alert_type, const char *content) {
+    if (docblock == NULL || alert_type == NULL || content == NULL) {
+        return false;
+    }
+    shellscribe_alert_t *alert = shellscribe_alert_vector_push(&docblock->alerts, docblock->arena);
+    if (alert == NULL) {
         return false;
     }
-    const char *alert_type = get_alert_type(tag);
-    shellscribe_alert_t *new_alerts = realloc(docblock->alerts, (docblock->alert_count + 1) * sizeof(shellscribe_alert_t));
-    if (new_alerts == NULL) {
+    alert->type = intern_string(alert_type);
+    if (alert->type == NULL) {
         return false;
     }
-    docblock->alerts = new_alerts;
-    docblock->alerts[docblock->alert_count].type = string_duplicate(alert_type);
-    docblock->alerts[docblock->alert_count].content = string_duplicate(content);
-    docblock->alert_count++;
+    alert->content = arena_strdup(docblock->arena, content);
     
     return true;
 } 
@@ -51,14 +51,12 @@ bool is_alias_tag(const char *tag) {
  *
  * @note Only one alias can be stored per documentation block. If multiple
  *       alias tags are processed for the same block, only the last one is kept.
- * @note Memory is allocated for the alias string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the alias string is allocated in the arena of the docblock.
  */
 bool process_alias_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL || *content == '\0') {
         return false;
     }
-    free(docblock->alias);
-    docblock->alias = string_duplicate(content);
+    docblock->alias = arena_strdup(docblock->arena, content);
     return (docblock->alias != NULL);
 } 
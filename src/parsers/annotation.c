@@ -12,14 +12,13 @@
 #include "parsers/annotation.h"
 #include "parsers/types.h"
 #include "utils/string.h"
+#include "utils/intern.h"
 #include "utils/debug.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-#define TAG_PREFIX "# @"
-
 /**
  * @brief Check if a line is a comment
  *
@@ -40,144 +39,6 @@ static bool is_comment_line(const char *line) {
     return (line[0] == '#');
 }
 
-/**
- * @brief Check if a line is a tag line
- * 
- * Determines whether a given line contains a documentation tag.
- * Supports two formats for tags:
- * 1. Standard format: "# @tagname content"
- * 2. Alternative format: "# @tagname: content"
- *
- * @param line The line to check for a tag
- * 
- * @return bool true if the line contains a tag, false otherwise
- */
-static bool is_tag_line(const char *line) {
-    while (isspace((unsigned char)*line)) {
-        line++;
-    }
-    if (strncmp(line, TAG_PREFIX, strlen(TAG_PREFIX)) == 0)
-        return true;
-    const char *at_sign = strstr(line, "@");
-    if (at_sign != NULL && at_sign > line && *(at_sign-1) == '#') {
-        const char *colon = strchr(at_sign, ':');
-        if (colon != NULL)
-            return true;
-    }
-    return false;
-}
-
-/**
- * @brief Extract tag name from a line
- *
- * Parses a line containing a documentation tag and extracts the tag name.
- * Supports both standard format ("# @tagname") and alternative format 
- * ("# @tagname:").
- *
- * @param line The line containing the tag
- *
- * @return char* Newly allocated string containing just the tag name,
- *               or NULL if the line does not contain a tag or if memory allocation fails.
- *               The caller is responsible for freeing this memory.
- */
-static char *extract_tag_name(const char *line) {
-    while (isspace((unsigned char)*line)) {
-        line++;
-    }
-    if (strncmp(line, TAG_PREFIX, strlen(TAG_PREFIX)) == 0) {
-        line += strlen(TAG_PREFIX);
-        const char *end = line;
-        while (*end && !isspace((unsigned char)*end) && *end != ':') {
-            end++;
-        }
-        size_t len = end - line;
-        char *tag = (char *)malloc(len + 1);
-        if (tag == NULL) {
-            return NULL;
-        }
-        strncpy(tag, line, len);
-        tag[len] = '\0';
-        
-        return tag;
-    } 
-    else {
-        const char *at_sign = strstr(line, "@");
-        if (at_sign != NULL) {
-            const char *tag_start = at_sign + 1;
-            const char *end = tag_start;
-            while (*end && !isspace((unsigned char)*end) && *end != ':') {
-                end++;
-            }
-            size_t len = end - tag_start;
-            char *tag = (char *)malloc(len + 1);
-            if (tag == NULL) {
-                return NULL;
-            }
-            strncpy(tag, tag_start, len);
-            tag[len] = '\0';
-            return tag;
-        }
-    }
-    return NULL;
-}
-
-/**
- * @brief Extract tag content from a line
- * 
- * Parses a line containing a documentation tag and extracts the content
- * (everything after the tag name and any whitespace or colon).
- * Supports both standard format ("# @tagname content") and alternative
- * format ("# @tagname: content").
- * 
- * @param line The line containing the tag and its content
- * 
- * @return char* Newly allocated string containing just the tag content,
- *               or NULL if the line does not contain a tag or if memory allocation fails.
- *               The caller is responsible for freeing this memory.
- */
-static char *extract_tag_content(const char *line) {
-    while (isspace((unsigned char)*line)) {
-        line++;
-    }
-    if (strncmp(line, TAG_PREFIX, strlen(TAG_PREFIX)) == 0) {
-        line += strlen(TAG_PREFIX);
-        while (*line && !isspace((unsigned char)*line)) {
-            line++;
-        }
-        while (isspace((unsigned char)*line)) {
-            line++;
-        }
-        return string_duplicate(line);
-    } else {
-        const char *at_sign = strstr(line, "@");
-        if (at_sign != NULL) {
-            const char *colon = strchr(at_sign, ':');
-            if (colon != NULL) {
-                const char *content_start = colon + 1;
-                while (isspace((unsigned char)*content_start)) {
-                    content_start++;
-                }
-                return string_duplicate(content_start);
-            } else {
-                const char *tag_start = at_sign + 1;
-                const char *space = tag_start;
-                while (*space && !isspace((unsigned char)*space)) {
-                    space++;
-                }
-                if (*space) {
-                    const char *content_start = space;
-                    while (isspace((unsigned char)*content_start)) {
-                        content_start++;
-                    }
-                    return string_duplicate(content_start);
-                }
-            }
-        }
-    }
-    
-    return NULL;
-}
-
 /**
  * @brief Check if a line contains a special annotation
  * 
@@ -236,21 +97,21 @@ bool process_special_annotation(const char *line, void *data) {
  * @return bool true if the alert was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the alert type and content, which will be
- *       freed when the docblock is freed.
+ * @note The alert type is interned, and the content allocated in the arena of the docblock.
  */
 static bool process_alert_tag_internal(shellscribe_docblock_t *docblock, const char *type, const char *content) {
     if (docblock == NULL || type == NULL || content == NULL) {
         return false;
     }
-    shellscribe_alert_t *new_alerts = realloc(docblock->alerts, (docblock->alert_count + 1) * sizeof(shellscribe_alert_t));
-    if (new_alerts == NULL) {
+    shellscribe_alert_t *alert = shellscribe_alert_vector_push(&docblock->alerts, docblock->arena);
+    if (alert == NULL) {
+        return false;
+    }
+    alert->type = intern_string(type);
+    if (alert->type == NULL) {
         return false;
     }
-    docblock->alerts = new_alerts;
-    docblock->alerts[docblock->alert_count].type = string_duplicate(type);
-    docblock->alerts[docblock->alert_count].content = string_duplicate(content);
-    docblock->alert_count++;
+    alert->content = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -267,20 +128,17 @@ static bool process_alert_tag_internal(shellscribe_docblock_t *docblock, const c
  * @return bool true if the warning was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the warning string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the warning string is allocated in the arena of the docblock.
  */
 bool process_warning_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_warnings = realloc(docblock->warnings, (docblock->warning_count + 1) * sizeof(char *));
-    if (new_warnings == NULL) {
+    const char **warning = shellscribe_string_vector_push(&docblock->warnings, docblock->arena);
+    if (warning == NULL) {
         return false;
     }
-    docblock->warnings = new_warnings;
-    docblock->warnings[docblock->warning_count] = string_duplicate(content);
-    docblock->warning_count++;
+    *warning = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -297,21 +155,17 @@ bool process_warning_tag(shellscribe_docblock_t *docblock, const char *content)
  * @return bool true if the dependency was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the dependency string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the dependency string is allocated in the arena of the docblock.
  */
 bool process_dependency_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_dependencies = realloc(docblock->dependencies, (docblock->dependency_count + 1) * sizeof(char *));
-    if (new_dependencies == NULL) {
+    const char **dependency = shellscribe_string_vector_push(&docblock->dependencies, docblock->arena);
+    if (dependency == NULL) {
         return false;
     }
-    
-    docblock->dependencies = new_dependencies;
-    docblock->dependencies[docblock->dependency_count] = string_duplicate(content);
-    docblock->dependency_count++;
+    *dependency = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -328,21 +182,17 @@ bool process_dependency_tag(shellscribe_docblock_t *docblock, const char *conten
  * @return bool true if the internal call was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the internal call string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the internal call string is allocated in the arena of the docblock.
  */
 bool process_internal_call_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_internal_calls = realloc(docblock->internal_calls, (docblock->internal_call_count + 1) * sizeof(char *));
-    if (new_internal_calls == NULL) {
+    const char **internal_call = shellscribe_string_vector_push(&docblock->internal_calls, docblock->arena);
+    if (internal_call == NULL) {
         return false;
     }
-    
-    docblock->internal_calls = new_internal_calls;
-    docblock->internal_calls[docblock->internal_call_count] = string_duplicate(content);
-    docblock->internal_call_count++;
+    *internal_call = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -361,8 +211,8 @@ bool process_internal_call_tag(shellscribe_docblock_t *docblock, const char *con
  * 
  * @note The content format should be "NAME description" where NAME is the
  *       environment variable name and everything after it is the description
- * @note Memory is allocated for the environment variable information, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the environment variable information is allocated in the
+ *       arena of the docblock.
  */
 bool process_environment_var_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
@@ -376,28 +226,21 @@ bool process_environment_var_tag(shellscribe_docblock_t *docblock, const char *c
     if (name_end == content) {
         return false;
     }
-    char *name = (char *)malloc(name_end - content + 1);
+    char *name = arena_strndup(docblock->arena, content, name_end - content);
     if (name == NULL) {
         return false;
     }
-    
-    strncpy(name, content, name_end - content);
-    name[name_end - content] = '\0';
     const char *description = name_end;
     while (*description && isspace((unsigned char)*description)) {
         description++;
     }
-    shellscribe_env_var_t *new_env_vars = realloc(docblock->env_vars, (docblock->env_var_count + 1) * sizeof(shellscribe_env_var_t));
-    if (new_env_vars == NULL) {
-        free(name);
+    shellscribe_env_var_t *env_var = shellscribe_env_var_vector_push(&docblock->env_vars, docblock->arena);
+    if (env_var == NULL) {
         return false;
     }
-    
-    docblock->env_vars = new_env_vars;
-    docblock->env_vars[docblock->env_var_count].name = name;
-    docblock->env_vars[docblock->env_var_count].description = string_duplicate(description);
-    docblock->env_vars[docblock->env_var_count].default_value = NULL;
-    docblock->env_var_count++;
+    env_var->name = name;
+    env_var->description = arena_strdup(docblock->arena, description);
+    env_var->default_value = NULL;
     
     return true;
 }
@@ -415,21 +258,21 @@ bool process_environment_var_tag(shellscribe_docblock_t *docblock, const char *c
  * @return bool true if the requirement was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the requirement string, which will be freed
- *       when the docblock is freed.
+ * @note The requirement string is interned, so that equal requirements share one copy.
  */
 bool process_requires_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_requires = realloc(docblock->requires, (docblock->requires_count + 1) * sizeof(char *));
-    if (new_requires == NULL) {
+    const char *target = intern_string(content);
+    if (target == NULL) {
         return false;
     }
-    
-    docblock->requires = new_requires;
-    docblock->requires[docblock->requires_count] = string_duplicate(content);
-    docblock->requires_count++;
+    const char **requirement = shellscribe_string_vector_push(&docblock->requires, docblock->arena);
+    if (requirement == NULL) {
+        return false;
+    }
+    *requirement = target;
     
     return true;
 }
@@ -446,21 +289,17 @@ bool process_requires_tag(shellscribe_docblock_t *docblock, const char *content)
  * @return bool true if the used-by information was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the used-by string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the used-by string is allocated in the arena of the docblock.
  */
 bool process_used_by_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_used_by = realloc(docblock->used_by, (docblock->used_by_count + 1) * sizeof(char *));
-    if (new_used_by == NULL) {
+    const char **user = shellscribe_string_vector_push(&docblock->used_by, docblock->arena);
+    if (user == NULL) {
         return false;
     }
-    
-    docblock->used_by = new_used_by;
-    docblock->used_by[docblock->used_by_count] = string_duplicate(content);
-    docblock->used_by_count++;
+    *user = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -477,21 +316,17 @@ bool process_used_by_tag(shellscribe_docblock_t *docblock, const char *content)
  * @return bool true if the external call was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the external call string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the external call string is allocated in the arena of the docblock.
  */
 bool process_calls_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_calls = realloc(docblock->calls, (docblock->calls_count + 1) * sizeof(char *));
-    if (new_calls == NULL) {
+    const char **call = shellscribe_string_vector_push(&docblock->calls, docblock->arena);
+    if (call == NULL) {
         return false;
     }
-    
-    docblock->calls = new_calls;
-    docblock->calls[docblock->calls_count] = string_duplicate(content);
-    docblock->calls_count++;
+    *call = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -508,21 +343,17 @@ bool process_calls_tag(shellscribe_docblock_t *docblock, const char *content) {
  * @return bool true if the provides information was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  * 
- * @note Memory is allocated for the provides string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the provides string is allocated in the arena of the docblock.
  */
 bool process_provides_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    char **new_provides = realloc(docblock->provides, (docblock->provides_count + 1) * sizeof(char *));
-    if (new_provides == NULL) {
+    const char **provided = shellscribe_string_vector_push(&docblock->provides, docblock->arena);
+    if (provided == NULL) {
         return false;
     }
-    
-    docblock->provides = new_provides;
-    docblock->provides[docblock->provides_count] = string_duplicate(content);
-    docblock->provides_count++;
+    *provided = arena_strdup(docblock->arena, content);
     
     return true;
 } 
@@ -10,6 +10,7 @@
 
 #include "parsers/argument.h"
 #include "utils/string.h"
+#include "utils/intern.h"
 #include "utils/debug.h"
 #include <stdlib.h>
 #include <string.h>
@@ -59,10 +60,8 @@ bool is_argument_tag(const char *tag) {
  *              false if an error occurred or if required parameters are NULL
  *
  * @note The argument name is required, but type can be omitted.
- * @note Memory is allocated for each component of the argument, which will be
- *       freed when the docblock is freed.
- * @note If memory allocation fails at any point, any already-allocated memory
- *       for this argument is freed to prevent leaks.
+ * @note Memory for the name and description of the argument is allocated in
+ *       the arena of the docblock, and its type is interned.
  */
 bool process_argument_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
@@ -70,16 +69,14 @@ bool process_argument_tag(shellscribe_docblock_t *docblock, const char *content)
     }
     const char *arg_str = content;
     char *arg_name = NULL;
-    char *arg_type = NULL;
+    const char *arg_type = NULL;
     char *arg_desc = NULL;
     while (isspace((unsigned char)*arg_str)) arg_str++;
     const char *name_end = arg_str;
     while (*name_end && !isspace((unsigned char)*name_end)) name_end++;
     if (name_end > arg_str) {
-        arg_name = (char *)malloc(name_end - arg_str + 1);
+        arg_name = arena_strndup(docblock->arena, arg_str, name_end - arg_str);
         if (arg_name == NULL) return false;
-        strncpy(arg_name, arg_str, name_end - arg_str);
-        arg_name[name_end - arg_str] = '\0';
         arg_str = name_end;
     } else {
         return false;
@@ -88,29 +85,21 @@ bool process_argument_tag(shellscribe_docblock_t *docblock, const char *content)
     const char *type_end = arg_str;
     while (*type_end && !isspace((unsigned char)*type_end)) type_end++;
     if (type_end > arg_str) {
-        arg_type = (char *)malloc(type_end - arg_str + 1);
+        arg_type = intern_string_length(arg_str, type_end - arg_str);
         if (arg_type == NULL) {
-            free(arg_name);
             return false;
         }
-        strncpy(arg_type, arg_str, type_end - arg_str);
-        arg_type[type_end - arg_str] = '\0';
         arg_str = type_end;
     }
     while (isspace((unsigned char)*arg_str)) arg_str++;
-    arg_desc = string_duplicate(arg_str);
-    shellscribe_argument_t *new_args = realloc(docblock->arguments, (docblock->arg_count + 1) * sizeof(shellscribe_argument_t));
-    if (new_args == NULL) {
-        free(arg_name);
-        free(arg_type);
-        free(arg_desc);
+    arg_desc = arena_strdup(docblock->arena, arg_str);
+    shellscribe_argument_t *argument = shellscribe_argument_vector_push(&docblock->arguments, docblock->arena);
+    if (argument == NULL) {
         return false;
     }
-    docblock->arguments = new_args;
-    docblock->arguments[docblock->arg_count].name = arg_name;
-    docblock->arguments[docblock->arg_count].type = arg_type;
-    docblock->arguments[docblock->arg_count].description = arg_desc;
-    docblock->arg_count++;
+    argument->name = arg_name;
+    argument->type = arg_type;
+    argument->description = arg_desc;
     
     return true;
 }
@@ -136,10 +125,8 @@ bool process_argument_tag(shellscribe_docblock_t *docblock, const char *content)
  *              false if an error occurred or if required parameters are NULL
  *
  * @note The parameter name is required.
- * @note Memory is allocated for each component of the parameter, which will be
- *       freed when the docblock is freed.
- * @note If memory allocation fails at any point, any already-allocated memory
- *       for this parameter is freed to prevent leaks.
+ * @note Memory for each component of the parameter is allocated in the arena
+ *       of the docblock.
  * @note This function is similar to process_argument_tag but with a simpler format
  *       that doesn't include a type field.
  * 
@@ -154,25 +141,20 @@ bool process_parameter_tag(shellscribe_docblock_t *docblock, const char *content
         name_end++;
     }
     if (name_end > content) {
-        char *param_name = (char *)malloc(name_end - content + 1);
+        char *param_name = arena_strndup(docblock->arena, content, name_end - content);
         if (param_name == NULL) {
             return false;
         }
-        strncpy(param_name, content, name_end - content);
-        param_name[name_end - content] = '\0';
         const char *desc_start = name_end;
         while (*desc_start && isspace((unsigned char)*desc_start)) {
             desc_start++;
         }
-        void *new_params = realloc(docblock->params, (docblock->param_count + 1) * sizeof(*docblock->params));
-        if (new_params == NULL) {
-            free(param_name);
+        shellscribe_param_t *param = shellscribe_param_vector_push(&docblock->params, docblock->arena);
+        if (param == NULL) {
             return false;
         }
-        docblock->params = new_params;
-        docblock->params[docblock->param_count].name = param_name;
-        docblock->params[docblock->param_count].description = string_duplicate(desc_start);
-        docblock->param_count++;
+        param->name = param_name;
+        param->description = arena_strdup(docblock->arena, desc_start);
         
         return true;
     }
@@ -60,8 +60,7 @@ bool is_deprecation_tag(const char *tag) {
  *       that version is extracted and stored as the deprecation version.
  * @note If no version is specified or the content is empty, the function will
  *       still be marked as deprecated, but without version information.
- * @note Memory is allocated for the version string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the version string is allocated in the arena of the docblock.
  * 
  * @see process_replacement_tag
  * @see process_eol_tag
@@ -78,11 +77,9 @@ bool process_deprecated_tag(shellscribe_docblock_t *docblock, const char *conten
             while (isspace(*from)) {
                 from++;
             }
-            free(docblock->deprecation.version);
-            docblock->deprecation.version = string_duplicate(from);
+            docblock->deprecation.version = arena_strdup(docblock->arena, from);
         } else {
-            free(docblock->deprecation.version);
-            docblock->deprecation.version = string_duplicate(content);
+            docblock->deprecation.version = arena_strdup(docblock->arena, content);
         }
     }
     
@@ -104,10 +101,8 @@ bool process_deprecated_tag(shellscribe_docblock_t *docblock, const char *conten
  *              added to the docblock, false if an error occurred or if required
  *              parameters are NULL or empty
  *
- * @note Memory is allocated for the replacement string, which will be freed
- *       when the docblock is freed.
- * @note If the docblock already had a replacement, the previous value is freed
- *       before the new value is assigned.
+ * @note Memory for the replacement string is allocated in the arena of the docblock.
+ * @note If the docblock already had a replacement, the previous value is replaced.
  * 
  * @see process_deprecated_tag
  */
@@ -115,8 +110,7 @@ bool process_replacement_tag(shellscribe_docblock_t *docblock, const char *conte
     if (docblock == NULL || content == NULL || *content == '\0') {
         return false;
     }
-    free(docblock->deprecation.replacement);
-    docblock->deprecation.replacement = string_duplicate(content);
+    docblock->deprecation.replacement = arena_strdup(docblock->arena, content);
     
     return true;
 }
@@ -135,10 +129,8 @@ bool process_replacement_tag(shellscribe_docblock_t *docblock, const char *conte
  *              added to the docblock, false if an error occurred or if required
  *              parameters are NULL or empty
  *
- * @note Memory is allocated for the EOL string, which will be freed
- *       when the docblock is freed.
- * @note If the docblock already had EOL information, the previous value is freed
- *       before the new value is assigned.
+ * @note Memory for the EOL string is allocated in the arena of the docblock.
+ * @note If the docblock already had EOL information, the previous value is replaced.
  * 
  * @see process_deprecated_tag
  */
@@ -146,8 +138,7 @@ bool process_eol_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL || *content == '\0') {
         return false;
     }
-    free(docblock->deprecation.eol);
-    docblock->deprecation.eol = string_duplicate(content);
+    docblock->deprecation.eol = arena_strdup(docblock->arena, content);
     
     return true;
 } 
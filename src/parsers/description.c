@@ -53,8 +53,7 @@ bool is_description_tag(const char *tag) {
  *              to the docblock, false if an error occurred or if required
  *              parameters are NULL
  *
- * @note Memory is allocated for the description string, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the description string is allocated in the arena of the docblock
  * @note If the docblock has a function_name set, the description is added to
  *       function_description; otherwise, it's added to the general description field.
  * @note Multiple description tags for the same element are concatenated with newlines.
@@ -63,31 +62,22 @@ bool process_description_tag(shellscribe_docblock_t *docblock, const char *conte
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    if (docblock->function_name == NULL) {
-        if (docblock->description == NULL) {
-            docblock->description = string_duplicate(content);
-        } else {
-            char *new_desc = string_concat(docblock->description, "\n");
-            free(docblock->description);
-            char *temp = new_desc;
-            new_desc = string_concat(temp, content);
-            free(temp);
-            
-            docblock->description = new_desc;
-        }
-    } else {
-        if (docblock->function_description == NULL) {
-            docblock->function_description = string_duplicate(content);
-        } else {
-            char *new_desc = string_concat(docblock->function_description, "\n");
-            free(docblock->function_description);
-            char *temp = new_desc;
-            new_desc = string_concat(temp, content);
-            free(temp);
-            
-            docblock->function_description = new_desc;
+    char **description = (docblock->function_name == NULL) ? &docblock->description : &docblock->function_description;
+    string_builder_t builder;
+    string_builder_init(&builder, docblock->arena);
+    size_t length = strlen(content);
+    if (*description != NULL) {
+        size_t description_length = strlen(*description);
+        if (!string_builder_reserve(&builder, description_length + 1 + length)) {
+            return false;
         }
+        string_builder_append_length(&builder, *description, description_length);
+        string_builder_append_length(&builder, "\n", 1);
+    }
+    if (!string_builder_append_length(&builder, content, length)) {
+        return false;
     }
+    *description = string_builder_finish(&builder);
     
     return true;
 }
@@ -106,8 +96,7 @@ bool process_description_tag(shellscribe_docblock_t *docblock, const char *conte
  *
  * @note If the docblock has a section and that section doesn't have a description set,
  *       this function will copy the main description to the section description.
- * @note Memory is allocated for the section description, which will be freed
- *       when the docblock is freed.
+ * @note Memory for the section description is allocated in the arena of the docblock
  */
 bool finalize_description(shellscribe_docblock_t *docblock) {
     if (docblock == NULL) {
@@ -116,7 +105,7 @@ bool finalize_description(shellscribe_docblock_t *docblock) {
     
     if (docblock->section != NULL && docblock->section->description == NULL) {
         if (docblock->description != NULL) {
-            docblock->section->description = string_duplicate(docblock->description);
+            docblock->section->description = arena_strdup(docblock->arena, docblock->description);
         }
     }
     
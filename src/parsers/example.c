@@ -18,15 +18,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
 // External function declarations
-extern bool is_comment_line(const char *line);
-extern bool is_tag_line(const char *line);
 extern bool is_special_annotation(const char *line);
 
-#define MAX_LINE_LENGTH 4096
-
 /**
  * @brief Check if a tag is an example tag
  * 
@@ -50,14 +45,15 @@ bool is_example_tag(const char *tag) {
 /**
  * @brief Extracts example content from documentation comments
  * 
- * Reads subsequent lines from a file and collects example content from comment
- * lines that follow the initial example tag. This function handles multi-line
+ * Consumes the lines following the example tag from the parser state and
+ * collects example content from them. This function handles multi-line
  * examples that are spread across consecutive comment lines.
  *
- * The function stops collecting when it encounters a line that is not a comment,
- * is a tag line, or contains a special annotation.
+ * The function stops collecting when the next line is not a comment, is a tag
+ * line, or contains a special annotation. That line is only peeked at, so it
+ * is left for the main parsing loop.
  *
- * @param file File handle to read subsequent lines from
+ * @param state The current parser state, positioned on the line of the example tag
  * @param initial_content The content from the first line of the example
  * @param config Configuration settings for parsing
  * 
@@ -69,46 +65,39 @@ bool is_example_tag(const char *tag) {
  * @note Example content collection stops at the first non-comment line, tag line,
  *       or special annotation line encountered
  * @note Memory is allocated for the example content, which must be freed by the caller
+ * @note The content is accumulated in a string builder, so that a long example
+ *       is collected in time linear in its length
  */
-char *extract_example_content(FILE *file, const char *initial_content, const shellscribe_config_t *config) {
-    if (file == NULL || initial_content == NULL || config == NULL) {
+char *extract_example_content(parser_state_t *state, const char *initial_content, const shellscribe_config_t *config) {
+    if (state == NULL || initial_content == NULL || config == NULL) {
         return NULL;
     }
-    long pos = ftell(file);
-    char *example_content = string_duplicate(initial_content);
-    if (example_content == NULL) {
+    string_builder_t builder;
+    string_builder_init(&builder, NULL);
+    if (!string_builder_append(&builder, initial_content)) {
         return NULL;
     }
     
     debug_message(config, "Extracting example starting with: '%s'\n", initial_content);
-    char line[MAX_LINE_LENGTH];
-    while (fgets(line, sizeof(line), file) != NULL) {
-        size_t len = strlen(line);
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-            len--;
-        }
-        if (is_comment_line(line) && !is_tag_line(line) && !is_special_annotation(line)) {
-            const char *comment_start = strchr(line, '#');
-            if (comment_start == NULL) continue;
-            comment_start++;
-            char *new_content = string_concat(example_content, "\n");
-            free(example_content);
-            char *temp = new_content;
-            new_content = string_concat(temp, comment_start);
-            free(temp);
-            
-            example_content = new_content;
-            
-            debug_message(config, "  Added example line: '%s'\n", comment_start);
-        } else {
-            debug_message(config, "  End of example at line: '%s'\n", line);
-            fseek(file, pos, SEEK_SET);
+    line_span_t span;
+    const line_class_t *next;
+    while ((next = state_peek_class(state, &span)) != NULL) {
+        if (!line_kind_is_comment(next->kind) || next->kind == LINE_TAG || is_special_annotation(span.start)) {
+            debug_message(config, "  End of example at line: '%s'\n", span.start);
             break;
         }
-
-        pos = ftell(file);
+        state_next_line(state);
+        size_t comment_offset = state->line_class.indent + 1;
+        const char *comment_start = state->line + comment_offset;
+        if (!string_builder_append_length(&builder, "\n", 1)
+            || !string_builder_append_length(&builder, comment_start, state->line_length - comment_offset)) {
+            string_builder_free(&builder);
+            return NULL;
+        }
+        
+        debug_message(config, "  Added example line: '%s'\n", comment_start);
     }
+    char *example_content = string_builder_finish(&builder);
     
     debug_message(config, "Extracted example content: '%s'\n", example_content);
     return example_content;
@@ -129,8 +118,7 @@ char *extract_example_content(FILE *file, const char *initial_content, const she
  *
  * @note If the docblock already has example content, the new content is appended
  *       with two newlines as a separator
- * @note Memory is allocated for the example content, which will be freed
- *       when the docblock is freed
+ * @note Memory for the example content is allocated in the arena of the docblock
  * @note Multiple examples in a single docblock will be rendered based on the
  *       configured example display style (sequential or tabbed)
  */
@@ -138,18 +126,21 @@ bool add_example_to_docblock(shellscribe_docblock_t *docblock, const char *examp
     if (docblock == NULL || example_content == NULL) {
         return false;
     }
+    string_builder_t builder;
+    string_builder_init(&builder, docblock->arena);
+    size_t length = strlen(example_content);
     if (docblock->example != NULL) {
-        char *new_example = string_concat(docblock->example, "\n\n");
-        free(docblock->example);
-        
-        char *temp = new_example;
-        new_example = string_concat(temp, example_content);
-        free(temp);
-        
-        docblock->example = new_example;
-    } else {
-        docblock->example = string_duplicate(example_content);
+        size_t example_length = strlen(docblock->example);
+        if (!string_builder_reserve(&builder, example_length + 2 + length)) {
+            return false;
+        }
+        string_builder_append_length(&builder, docblock->example, example_length);
+        string_builder_append_length(&builder, "\n\n", 2);
+    }
+    if (!string_builder_append_length(&builder, example_content, length)) {
+        return false;
     }
+    docblock->example = string_builder_finish(&builder);
     
     return true;
 }
@@ -158,19 +149,16 @@ bool add_example_to_docblock(shellscribe_docblock_t *docblock, const char *examp
  * @brief Process an example tag within a parser state
  * 
  * Processes an example tag and collects all the example content from subsequent
- * comment lines. This function uses the parser state to track the current position
- * in the file and collects content until a non-comment line, tag line, or special
- * annotation is encountered.
+ * comment lines. This function consumes lines from the cursor of the parser
+ * state until a non-comment line, tag line, or special annotation is next.
  *
- * @param state The current parser state, containing file handle and line buffer
+ * @param state The current parser state, containing the line cursor
  * @param content The initial content from the example tag line
  * 
  * @return char* Newly allocated string containing the complete example content,
  *               or NULL on error. The caller is responsible for freeing this memory.
  *
- * @note The function restores the file position if it reaches the end of the example
- * @note This function is similar to extract_example_content but uses the parser state
- *       for tracking position
+ * @note The line ending the example is left unconsumed
  * @note Memory is allocated for the example content, which must be freed by the caller
  * 
  * @see extract_example_content
@@ -179,35 +167,6 @@ char *process_example_tag(parser_state_t *state, const char *content) {
     if (state == NULL || content == NULL) {
         return NULL;
     }
-    long pos = ftell(state->file);
-    char line[MAX_LINE_LENGTH];
-    char *example_content = string_duplicate(content);
     
-    while (fgets(line, sizeof(line), state->file) != NULL) {
-        size_t len = strlen(line);
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-            len--;
-        }
-        
-        if (is_comment_line(line) && !is_tag_line(line) && !is_special_annotation(line)) {
-            const char *comment_start = strchr(line, '#');
-            if (comment_start == NULL) continue;
-            comment_start++;
-            char *new_content = string_concat(example_content, "\n");
-            free(example_content);
-            char *temp = new_content;
-            new_content = string_concat(temp, comment_start);
-            free(temp);
-            
-            example_content = new_content;
-        } else {
-            fseek(state->file, pos, SEEK_SET);
-            break;
-        }
-        
-        pos = ftell(state->file);
-    }
-    
-    return example_content;
-} 
+    return extract_example_content(state, content, state->config);
+}
@@ -46,6 +46,7 @@ bool is_exitcode_tag(const char *tag) {
  * "CODE description" where CODE is the numeric exit code and everything
  * after the first space is considered the description.
  *
+ * @param arena The arena allocating the extracted strings
  * @param content The content of the exitcode tag to parse
  * @param code Pointer to a string pointer that will be set to the extracted code
  * @param description Pointer to a string pointer that will be set to the extracted description
@@ -53,12 +54,11 @@ bool is_exitcode_tag(const char *tag) {
  * @return bool true if parsing was successful and the code was extracted,
  *              false if an error occurred or if required parameters are NULL
  *
- * @note Memory is allocated for both the code and description, which must be freed
- *       by the caller when no longer needed
+ * @note Memory for both the code and description is allocated in the arena
  * @note If no space is found in the content, the entire content is treated as
  *       the code and the description is set to an empty string
  */
-bool parse_exitcode_content(const char *content, char **code, char **description) {
+bool parse_exitcode_content(arena_t *arena, const char *content, char **code, char **description) {
     if (content == NULL || code == NULL || description == NULL) {
         return false;
     }
@@ -75,24 +75,21 @@ bool parse_exitcode_content(const char *content, char **code, char **description
     const char *code_end = strchr(content, ' ');
     
     if (code_end == NULL) {
-        *code = shell_strdup(content);
-        *description = shell_strdup("");
+        *code = arena_strdup(arena, content);
+        *description = arena_strdup(arena, "");
         return true;
     }
     size_t code_len = code_end - code_start;
-    *code = shell_malloc(code_len + 1);
+    *code = arena_strndup(arena, code_start, code_len);
     if (*code == NULL) {
         return false;
     }
-    
-    strncpy(*code, code_start, code_len);
-    (*code)[code_len] = '\0';
     const char *desc_start = code_end + 1;
     while (isspace(*desc_start)) {
         desc_start++;
     }
     
-    *description = shell_strdup(desc_start);
+    *description = arena_strdup(arena, desc_start);
     
     return true;
 }
@@ -110,8 +107,7 @@ bool parse_exitcode_content(const char *content, char **code, char **description
  *              false if an error occurred or if required parameters are NULL
  *
  * @note This function uses parse_exitcode_content to extract the code and description
- * @note Memory is allocated for the exitcode information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the exitcode information is allocated in the arena of the docblock
  * 
  * @see parse_exitcode_content
  */
@@ -122,22 +118,15 @@ bool process_exitcode_tag(shellscribe_docblock_t *docblock, const char *content)
     
     char *code = NULL;
     char *description = NULL;
-    if (!parse_exitcode_content(content, &code, &description)) {
+    if (!parse_exitcode_content(docblock->arena, content, &code, &description)) {
         return false;
     }
-    shellscribe_exitcode_t *new_exitcodes = shell_realloc(docblock->exitcodes, (docblock->exitcode_count + 1) * sizeof(shellscribe_exitcode_t));
-    if (new_exitcodes == NULL) {
-        void *code_ptr = code;
-        shell_free(&code_ptr);
-        void *desc_ptr = description;
-        shell_free(&desc_ptr);
+    shellscribe_exitcode_t *exitcode = shellscribe_exitcode_vector_push(&docblock->exitcodes, docblock->arena);
+    if (exitcode == NULL) {
         return false;
     }
-    
-    docblock->exitcodes = new_exitcodes;
-    docblock->exitcodes[docblock->exitcode_count].code = code;
-    docblock->exitcodes[docblock->exitcode_count].description = description;
-    docblock->exitcode_count++;
+    exitcode->code = code;
+    exitcode->description = description;
     
     return true;
 }
@@ -157,8 +146,7 @@ bool process_exitcode_tag(shellscribe_docblock_t *docblock, const char *content)
  *              false if an error occurred or if required parameters are NULL
  *
  * @note This function logs debug messages if debugging is enabled in the configuration
- * @note Memory is allocated for the exitcode information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the exitcode information is allocated in the arena of the docblock
  * 
  * @see process_exitcode_tag
  */
@@ -175,28 +163,20 @@ bool parse_exit_code_tag(shellscribe_docblock_t *docblock, const char *content,
     
     size_t code_len = code_end - content;
     if (code_len > 0) {
-        char *code = shell_malloc(code_len + 1);
+        char *code = arena_strndup(docblock->arena, content, code_len);
         if (code == NULL) {
             return false;
         }
-        
-        strncpy(code, content, code_len);
-        code[code_len] = '\0';
         const char *description = code_end;
         while (*description && isspace((unsigned char)*description)) {
             description++;
         }
-        shellscribe_exitcode_t *new_exitcodes = shell_realloc(docblock->exitcodes,(docblock->exitcode_count + 1) * sizeof(shellscribe_exitcode_t));
-        if (new_exitcodes == NULL) {
-            void *code_ptr = code;
-            shell_free(&code_ptr);
+        shellscribe_exitcode_t *exitcode = shellscribe_exitcode_vector_push(&docblock->exitcodes, docblock->arena);
+        if (exitcode == NULL) {
             return false;
         }
-        
-        docblock->exitcodes = new_exitcodes;
-        docblock->exitcodes[docblock->exitcode_count].code = code;
-        docblock->exitcodes[docblock->exitcode_count].description = shell_strdup(description);
-        docblock->exitcode_count++;
+        exitcode->code = code;
+        exitcode->description = arena_strdup(docblock->arena, description);
         debug_message(config, "Added exit code: code='%s', desc='%s'\n", code, description);
         
         return true;
@@ -136,9 +136,8 @@ char *extract_function_name(const char *line) {
  *              the docblock was updated, false if an error occurred or if
  *              required parameters are NULL
  * 
- * @note Any existing function name in the docblock will be freed and replaced
- * @note Memory is allocated for the function name, which will be freed when
- *       the docblock is freed
+ * @note Any existing function name in the docblock is replaced
+ * @note Memory for the function name is allocated in the arena of the docblock
  * 
  * @see extract_function_name
  */
@@ -150,9 +149,9 @@ bool parse_function_declaration(shellscribe_docblock_t *docblock, const char *li
     if (function_name == NULL) {
         return false;
     }
-    free(docblock->function_name);
-    docblock->function_name = function_name;
+    docblock->function_name = arena_strdup(docblock->arena, function_name);
+    free(function_name);
     
-    return true;
+    return (docblock->function_name != NULL);
 } 
 
@@ -51,17 +51,14 @@ bool is_io_tag(const char *tag) {
  *              added to the docblock, false if an error occurred or if
  *              required parameters are NULL
  *
- * @note Any existing stdin documentation in the docblock will be freed
- *       before the new content is assigned
- * @note Memory is allocated for the stdin documentation, which will be freed
- *       when the docblock is freed
+ * @note Any existing stdin documentation in the docblock is replaced
+ * @note Memory for the stdin documentation is allocated in the arena of the docblock.
  */
 bool process_stdin_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    free(docblock->stdin_doc);
-    docblock->stdin_doc = string_duplicate(content);
+    docblock->stdin_doc = arena_strdup(docblock->arena, content);
     
     return (docblock->stdin_doc != NULL);
 }
@@ -79,17 +76,14 @@ bool process_stdin_tag(shellscribe_docblock_t *docblock, const char *content) {
  *              added to the docblock, false if an error occurred or if
  *              required parameters are NULL
  *
- * @note Any existing stdout documentation in the docblock will be freed
- *       before the new content is assigned
- * @note Memory is allocated for the stdout documentation, which will be freed
- *       when the docblock is freed
+ * @note Any existing stdout documentation in the docblock is replaced
+ * @note Memory for the stdout documentation is allocated in the arena of the docblock.
  */
 bool process_stdout_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    free(docblock->stdout_doc);
-    docblock->stdout_doc = string_duplicate(content);
+    docblock->stdout_doc = arena_strdup(docblock->arena, content);
     
     return (docblock->stdout_doc != NULL);
 }
@@ -108,17 +102,14 @@ bool process_stdout_tag(shellscribe_docblock_t *docblock, const char *content) {
  *              added to the docblock, false if an error occurred or if
  *              required parameters are NULL
  *
- * @note Any existing stderr documentation in the docblock will be freed
- *       before the new content is assigned
- * @note Memory is allocated for the stderr documentation, which will be freed
- *       when the docblock is freed
+ * @note Any existing stderr documentation in the docblock is replaced
+ * @note Memory for the stderr documentation is allocated in the arena of the docblock.
  */
 bool process_stderr_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    free(docblock->stderr_doc);
-    docblock->stderr_doc = string_duplicate(content);
+    docblock->stderr_doc = arena_strdup(docblock->arena, content);
     
     return (docblock->stderr_doc != NULL);
 } 
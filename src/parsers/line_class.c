@@ -0,0 +1,170 @@
+/**
+ * @file line_class.c
+ * @brief Implementation of line classification
+ *
+ * A line is classified from its first non-whitespace character: a '#' makes
+ * it one of the comment kinds, which are told apart by the characters right
+ * after it, and anything else is code, unless it has the shape of a function
+ * declaration. Every character is looked at once at most, except for the
+ * name of a tag, which is matched against the known tags.
+ */
+
+#include "parsers/line_class.h"
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * @brief Keyword opening a shellcheck directive (matched case-insensitively)
+ */
+#define SHELLCHECK_KEYWORD "shellcheck"
+
+/**
+ * @brief Check whether code starts a function declaration
+ *
+ * Two forms are recognized: the function keyword followed by whitespace, and
+ * a name made of letters, digits and underscores immediately followed by
+ * parentheses and an opening brace, with only whitespace in between.
+ *
+ * @param line The line
+ * @param code The first non-whitespace character of the line
+ * @param cls Filled with the offset and the length of the function name
+ *
+ * @return bool true if the line declares a function, false otherwise
+ *
+ * @note With the function keyword, the name runs up to the first whitespace or
+ *       parenthesis and may be empty
+ */
+static bool classify_function(const char *line, const char *code, line_class_t *cls) {
+    const char *name = code;
+    const char *name_end;
+    if (strncmp(code, "function", 8) == 0 && isspace((unsigned char)code[8])) {
+        name = code + 8;
+        while (isspace((unsigned char)*name)) {
+            name++;
+        }
+        name_end = name;
+        while (*name_end && !isspace((unsigned char)*name_end) && *name_end != '(') {
+            name_end++;
+        }
+    } else {
+        name_end = code;
+        while (isalnum((unsigned char)*name_end) || *name_end == '_') {
+            name_end++;
+        }
+        if (name_end == code || *name_end != '(') {
+            return false;
+        }
+        const char *brace = strchr(name_end, ')');
+        if (brace == NULL) {
+            return false;
+        }
+        brace++;
+        while (isspace((unsigned char)*brace)) {
+            brace++;
+        }
+        if (*brace != '{') {
+            return false;
+        }
+    }
+    cls->name = (size_t)(name - line);
+    cls->name_length = (size_t)(name_end - name);
+
+    return true;
+}
+
+/**
+ * @brief Classify a line
+ *
+ * Besides the kind of the line, the classification records the offset of its
+ * first non-whitespace character and, for comment kinds, the offset of the
+ * text following the '#' and any whitespace: the directive of a shellcheck
+ * line, the continuation of a multi-line tag, or the interpreter of a shebang.
+ * A tag line is lexed on the way, and the name of a declared function located.
+ *
+ * @param line The line to classify (NUL-terminated)
+ * @param length The length of the line
+ * @param first Whether the line is the first line of the file
+ * @param cls Filled with the classification of the line
+ *
+ * @return line_kind_t The kind of the line (LINE_BLANK if a parameter is NULL)
+ *
+ * @note A shebang is only recognized at the very start of the first line; an
+ *       indented "#!", or one on a later line, is a plain comment whose text
+ *       starts with the '!'
+ */
+line_kind_t classify_line(const char *line, size_t length, bool first, line_class_t *cls) {
+    if (line == NULL || cls == NULL) {
+        return LINE_BLANK;
+    }
+    size_t indent = 0;
+    while (isspace((unsigned char)line[indent])) {
+        indent++;
+    }
+    
+    return classify_line_at(line, length, indent, first, cls);
+}
+
+/**
+ * @brief Classify a line whose first non-blank character is already known
+ *
+ * The line scanner locates the first non-blank character of every line while
+ * it splits the file, so the parser state classifies lines from there instead
+ * of skipping their leading whitespace again.
+ *
+ * @param line The line to classify (NUL-terminated)
+ * @param length The length of the line
+ * @param indent The offset of the first non-blank character (length if the line is blank)
+ * @param first Whether the line is the first line of the file
+ * @param cls Filled with the classification of the line
+ *
+ * @return line_kind_t The kind of the line (LINE_BLANK if a parameter is NULL)
+ *
+ * @see classify_line
+ */
+line_kind_t classify_line_at(const char *line, size_t length, size_t indent, bool first, line_class_t *cls) {
+    if (line == NULL || cls == NULL) {
+        return LINE_BLANK;
+    }
+    const char *p = line + indent;
+    cls->indent = indent;
+    cls->text = cls->indent;
+    cls->name = 0;
+    cls->name_length = 0;
+    if (*p == '\0') {
+        cls->kind = LINE_BLANK;
+    } else if (*p == '#') {
+        bool shebang = first && p == line && p[1] == '!';
+        const char *text = shebang ? p + 2 : p + 1;
+        while (isspace((unsigned char)*text)) {
+            text++;
+        }
+        cls->text = (size_t)(text - line);
+        if (shebang) {
+            cls->kind = LINE_SHEBANG;
+        } else if (p[1] == ' ' && p[2] == '@' && lex_tag_line(p, length - cls->indent, &cls->tag)) {
+            cls->kind = LINE_TAG;
+        } else if (strncasecmp(text, SHELLCHECK_KEYWORD, strlen(SHELLCHECK_KEYWORD)) == 0) {
+            cls->kind = LINE_SHELLCHECK;
+        } else {
+            cls->kind = LINE_COMMENT;
+        }
+    } else if (classify_function(line, p, cls)) {
+        cls->kind = LINE_FUNCTION;
+    } else {
+        cls->kind = LINE_CODE;
+    }
+
+    return cls->kind;
+}
+
+/**
+ * @brief Check whether a kind of line is a comment
+ *
+ * @param kind The kind of line
+ *
+ * @return bool true for comments, tags, shellcheck directives and shebangs
+ */
+bool line_kind_is_comment(line_kind_t kind) {
+    return kind >= LINE_COMMENT;
+}
@@ -10,7 +10,9 @@
  */
 
 #include "parsers/metadata.h"
+#include "parsers/state.h"
 #include "utils/string.h"
+#include "utils/intern.h"
 #include "utils/debug.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,25 +33,15 @@
  * @note This function is case-sensitive, so tags must exactly match one of the
  *       recognized forms
  * @note Recognized file-level tags include: file, version, author, license, copyright,
- *       since, description, package, module, link, repo, see, env, and skip
+ *       since, description, package, module, link, repo, see, env, and skip, as
+ *       flagged in the tag table of the parser
  */
 bool is_file_level_tag(const char *tag) {
     if (tag == NULL) {
         return false;
     }
-    const char *file_tags[] = {
-        "file", "version", "author", "license", "copyright",
-        "since", "description", "package", "module",
-        "link", "repo", "see", "env", "skip",
-        NULL
-    };
-    for (int i = 0; file_tags[i] != NULL; i++) {
-        if (strcmp(tag, file_tags[i]) == 0) {
-            return true;
-        }
-    }
     
-    return false;
+    return get_tag_spec(tag_lookup(tag, strlen(tag)))->file_level;
 }
 
 /**
@@ -93,10 +85,9 @@ bool is_file_level_description(const char *tag, int line_number) {
  * @return bool true if the metadata was successfully processed and added to the docblock,
  *              false if an error occurred or if required parameters are NULL
  *
- * @note Any existing value for the corresponding metadata field will be freed
- *       before the new value is assigned
- * @note Memory is allocated for the metadata value, which will be freed
- *       when the docblock is freed
+ * @note Any existing value for the corresponding metadata field is replaced
+ * @note Memory for the metadata value is allocated in the arena of the docblock,
+ *       except for the author, which is interned
  * @note The 'skip' tag is handled specially, setting a flag rather than storing content
  */
 bool process_file_metadata_tag(shellscribe_docblock_t *docblock, const char *tag, const char *content) {
@@ -110,7 +101,6 @@ bool process_file_metadata_tag(shellscribe_docblock_t *docblock, const char *tag
     } tag_mappings[] = {
         {"file", &docblock->file_name},
         {"version", &docblock->version},
-        {"author", &docblock->author},
         {"since", &docblock->author_contact},
         {"description", &docblock->description},
         {"brief", &docblock->brief},
@@ -119,10 +109,13 @@ bool process_file_metadata_tag(shellscribe_docblock_t *docblock, const char *tag
         {NULL, NULL}
     };
 
+    if (strcmp(tag, "author") == 0) {
+        docblock->author = intern_string(content);
+        return docblock->author != NULL;
+    }
     for (int i = 0; tag_mappings[i].tag_name != NULL; i++) {
         if (strcmp(tag, tag_mappings[i].tag_name) == 0) {
-            free(*tag_mappings[i].docblock_field);
-            *tag_mappings[i].docblock_field = string_duplicate(content);
+            *tag_mappings[i].docblock_field = arena_strdup(docblock->arena, content);
             return true;
         }
     }
@@ -149,31 +142,30 @@ bool process_file_metadata_tag(shellscribe_docblock_t *docblock, const char *tag
  *              false if an error occurred or if required parameters are NULL
  *
  * @note The tag name is converted to uppercase to standardize alert types
- * @note Memory is allocated for the alert type and content, which will be freed
- *       when the docblock is freed
+ * @note The alert type is interned, and the content allocated in the arena of
+ *       the docblock
  * @note This is primarily an internal function used by other tag processors
  */
 static bool metadata_process_alert_tag(shellscribe_docblock_t *docblock, const char *tag, const char *content) {
     if (docblock == NULL || tag == NULL || content == NULL) {
         return false;
     }
-    char *alert_type = string_duplicate(tag);
+    char *alert_type = arena_strdup(docblock->arena, tag);
     if (alert_type == NULL) {
         return false;
     }
     for (char *p = alert_type; *p; p++) {
         *p = toupper(*p);
     }
-    shellscribe_alert_t *new_alerts = realloc(docblock->alerts, (docblock->alert_count + 1) * sizeof(shellscribe_alert_t));
-    if (new_alerts == NULL) {
-        free(alert_type);
+    shellscribe_alert_t *alert = shellscribe_alert_vector_push(&docblock->alerts, docblock->arena);
+    if (alert == NULL) {
         return false;
     }
-    
-    docblock->alerts = new_alerts;
-    docblock->alerts[docblock->alert_count].type = alert_type;
-    docblock->alerts[docblock->alert_count].content = string_duplicate(content);
-    docblock->alert_count++;
+    alert->type = intern_string(alert_type);
+    if (alert->type == NULL) {
+        return false;
+    }
+    alert->content = arena_strdup(docblock->arena, content);
     
     return true;
 } 
@@ -50,6 +50,7 @@ bool is_option_tag(const char *tag) {
  * 3. "-o=<arg> description" - option with inline argument
  * 4. "-o <arg> description" - option with separate argument
  *
+ * @param arena The arena allocating the extracted strings
  * @param content The content of the option tag to parse
  * @param option Pointer to a string pointer that will store the extracted option
  * @param description Pointer to a string pointer that will store the extracted description
@@ -58,12 +59,12 @@ bool is_option_tag(const char *tag) {
  * @return bool true if parsing was successful and the option was extracted,
  *              false if an error occurred or if required parameters are NULL
  *
- * @note Memory is allocated for the option, description, and arg_spec (if present),
- *       which must be freed by the caller when no longer needed
+ * @note Memory for the option, description, and arg_spec (if present) is allocated
+ *       in the arena
  * @note If the option does not have an argument specification, arg_spec will be set to NULL
  * @note Argument specifications are typically enclosed in angle brackets (e.g., <file>)
  */
-bool parse_option_content(const char *content, char **option, char **description, char **arg_spec) {
+bool parse_option_content(arena_t *arena, const char *content, char **option, char **description, char **arg_spec) {
     if (content == NULL || option == NULL || description == NULL || arg_spec == NULL) {
         return false;
     }
@@ -87,36 +88,29 @@ bool parse_option_content(const char *content, char **option, char **description
             opt_end--;
         }
         size_t opt_len = opt_end - opt_start;
-        *option = malloc(opt_len + 1);
+        *option = arena_strndup(arena, opt_start, opt_len);
         if (*option == NULL) {
             return false;
         }
-        strncpy(*option, opt_start, opt_len);
-        (*option)[opt_len] = '\0';
         desc_start = pipe + 1;
         while (isspace(*desc_start)) {
             desc_start++;
         }
         const char *second_space = strchr(desc_start, ' ');
         if (second_space != NULL) {
-            *description = string_duplicate(second_space + 1);
+            *description = arena_strdup(arena, second_space + 1);
         } else {
-            *description = string_duplicate("");
+            *description = arena_strdup(arena, "");
         }
         const char *arg_open = strchr(*option, '<');
         if (arg_open != NULL) {
             const char *arg_close = strchr(arg_open, '>');
             if (arg_close != NULL) {
                 size_t arg_len = arg_close - arg_open - 1;
-                *arg_spec = malloc(arg_len + 1);
+                *arg_spec = arena_strndup(arena, arg_open + 1, arg_len);
                 if (*arg_spec == NULL) {
-                    free(*option);
-                    free(*description);
                     return false;
                 }
-                
-                strncpy(*arg_spec, arg_open + 1, arg_len);
-                (*arg_spec)[arg_len] = '\0';
                 has_arg = true;
             }
         }
@@ -127,15 +121,10 @@ bool parse_option_content(const char *content, char **option, char **description
                 const char *arg_close = strchr(arg_open, '>');
                 if (arg_close != NULL) {
                     size_t arg_len = arg_close - arg_open - 1;
-                    *arg_spec = malloc(arg_len + 1);
+                    *arg_spec = arena_strndup(arena, arg_open + 1, arg_len);
                     if (*arg_spec == NULL) {
-                        free(*option);
-                        free(*description);
                         return false;
                     }
-                    
-                    strncpy(*arg_spec, arg_open + 1, arg_len);
-                    (*arg_spec)[arg_len] = '\0';
                 }
             }
         }
@@ -145,17 +134,14 @@ bool parse_option_content(const char *content, char **option, char **description
             opt_end = space;
             desc_start = space + 1;
             size_t opt_len = opt_end - opt_start;
-            *option = malloc(opt_len + 1);
+            *option = arena_strndup(arena, opt_start, opt_len);
             if (*option == NULL) {
                 return false;
             }
-            
-            strncpy(*option, opt_start, opt_len);
-            (*option)[opt_len] = '\0';
-            *description = string_duplicate(desc_start);
+            *description = arena_strdup(arena, desc_start);
         } else {
-            *option = string_duplicate(content);
-            *description = string_duplicate("");
+            *option = arena_strdup(arena, content);
+            *description = arena_strdup(arena, "");
         }
         const char *arg_open = NULL;
         const char *arg_close = NULL;
@@ -173,14 +159,10 @@ bool parse_option_content(const char *content, char **option, char **description
         }
         if (arg_open != NULL && arg_close != NULL) {
             size_t arg_len = arg_close - arg_open - 1;
-            *arg_spec = malloc(arg_len + 1);
+            *arg_spec = arena_strndup(arena, arg_open + 1, arg_len);
             if (*arg_spec == NULL) {
-                free(*option);
-                free(*description);
                 return false;
             }
-            strncpy(*arg_spec, arg_open + 1, arg_len);
-            (*arg_spec)[arg_len] = '\0';
         }
     }
     
@@ -201,8 +183,7 @@ bool parse_option_content(const char *content, char **option, char **description
  *              false if an error occurred or if required parameters are NULL
  *
  * @note This function uses parse_option_content to extract the option components
- * @note Memory is allocated for the option information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the option information is allocated in the arena of the docblock
  * @note Only options starting with a dash (-) are recognized; others are rejected
  * @note Short options start with a single dash (e.g., -v) while long options
  *       start with two dashes (e.g., --verbose)
@@ -216,7 +197,7 @@ bool process_option_tag(shellscribe_docblock_t *docblock, const char *content) {
     char *option = NULL;
     char *description = NULL;
     char *arg_spec = NULL;
-    if (!parse_option_content(content, &option, &description, &arg_spec)) {
+    if (!parse_option_content(docblock->arena, content, &option, &description, &arg_spec)) {
         return false;
     }
     char *short_opt = NULL;
@@ -227,25 +208,16 @@ bool process_option_tag(shellscribe_docblock_t *docblock, const char *content) {
     } else if (option[0] == '-' && option[1] == '-') {
         long_opt = option;
     } else {
-        free(option);
-        free(description);
-        free(arg_spec);
         return false;
     }
-    shellscribe_option_t *new_options = realloc(docblock->options, (docblock->option_count + 1) * sizeof(shellscribe_option_t));
-    if (new_options == NULL) {
-        free(option);
-        free(description);
-        free(arg_spec);
+    shellscribe_option_t *entry = shellscribe_option_vector_push(&docblock->options, docblock->arena);
+    if (entry == NULL) {
         return false;
     }
-    
-    docblock->options = new_options;
-    docblock->options[docblock->option_count].short_opt = short_opt;
-    docblock->options[docblock->option_count].long_opt = long_opt;
-    docblock->options[docblock->option_count].arg_spec = arg_spec;
-    docblock->options[docblock->option_count].description = description;
-    docblock->option_count++;
+    entry->short_opt = short_opt;
+    entry->long_opt = long_opt;
+    entry->arg_spec = arg_spec;
+    entry->description = description;
         
     return true;
 } 
@@ -38,32 +38,6 @@
 #include <string.h>
 #include <ctype.h>
 
-/**
- * @brief Maximum number of documentation blocks to parse in a file
- */
-#define MAX_DOC_BLOCKS 100
-
-/**
- * @brief Maximum length of a line in a shell script
- */
-#define MAX_LINE_LENGTH 4096
-
-/**
- * @brief Prefix that identifies a documentation tag in comments
- */
-#define TAG_PREFIX "# @"
-
-static bool process_tag_internal(parser_state_t *state, const char *tag, const char *content);
-static char *collect_continued_comment_content(parser_state_t *state, const char *initial_content);
-extern bool is_comment_line(const char *line);
-extern bool is_tag_line(const char *line);
-extern char *extract_tag_name(const char *line);
-extern char *extract_tag_content(const char *line);
-static bool process_tag_internal(parser_state_t *state, const char *tag, const char *content);
-extern bool is_function_declaration(const char *line);
-extern char *extract_function_name(const char *line);
-static char *collect_continued_comment_content(parser_state_t *state, const char *initial_content);
-extern bool is_special_annotation(const char *line);
 extern bool extract_shebang(const char *line, shellscribe_docblock_t *docblock);
 extern bool process_warning_tag(shellscribe_docblock_t *docblock, const char *content);
 extern bool process_dependency_tag(shellscribe_docblock_t *docblock, const char *content);
@@ -75,6 +49,8 @@ extern bool process_provides_tag(shellscribe_docblock_t *docblock, const char *c
 bool is_file_level_tag(const char *tag);
 bool is_file_level_description(const char *tag, int line_number);
 bool process_file_metadata_tag(shellscribe_docblock_t *block, const char *tag, const char *content);
+static int parse_with_state(parser_state_t *state, const char *file_path, const shellscribe_config_t *config,
+    shellscribe_docblock_list_t *docblocks);
 
 /**
  * @brief Extract and process the interpreter shebang line from a shell script
@@ -85,8 +61,11 @@ bool process_file_metadata_tag(shellscribe_docblock_t *block, const char *tag, c
  * @param line The line to examine for a shebang
  * @param docblock The documentation block to store the interpreter in
  * 
- * @return bool true if a valid shebang was found and processed,
- *              false if the line doesn't contain a shebang or is invalid
+ * @return bool true if a shebang was found and processed,
+ *              false if the line doesn't contain a shebang
+ *
+ * @note A bare "#!" records an empty interpreter, so that the file still gets
+ *       its interpreter line and About section
  */
 bool extract_shebang(const char *line, shellscribe_docblock_t *docblock) {
     if (line == NULL || docblock == NULL) {
@@ -97,12 +76,9 @@ bool extract_shebang(const char *line, shellscribe_docblock_t *docblock) {
         while (*interpreter == ' ' || *interpreter == '\t') {
             interpreter++;
         }
+        docblock->interpreter = arena_strdup(docblock->arena, interpreter);
         
-        if (*interpreter) {
-            free(docblock->interpreter);
-            docblock->interpreter = string_duplicate(interpreter);
-            return true;
-        }
+        return (docblock->interpreter != NULL);
     }
     
     return false;
@@ -117,278 +93,145 @@ bool extract_shebang(const char *line, shellscribe_docblock_t *docblock) {
  * 
  * @param file_path Path to the shell script file to parse
  * @param config Configuration settings controlling parsing behavior
- * @param docblocks Pre-allocated array to store the extracted documentation blocks
- * @param max_blocks Maximum number of blocks that can be stored in the docblocks array
+ * @param docblocks List receiving the extracted documentation blocks (empty, with an arena, on entry)
  * 
  * @return int The number of documentation blocks found and processed,
  *             or 0 if an error occurred
  * 
  * @note The first block (index 0) always represents the file-level documentation
+ * @note On failure, the list may still hold blocks that the caller must free
  * @see init_docblock
  * @see cleanup_parser_state
  */
 int parse_shell_file(const char *file_path, const shellscribe_config_t *config,
-    shellscribe_docblock_t *docblocks, int max_blocks) {
-    if (file_path == NULL || config == NULL || docblocks == NULL || max_blocks <= 0) {
+    shellscribe_docblock_list_t *docblocks) {
+    if (file_path == NULL || config == NULL || docblocks == NULL) {
         return 0;
     }
-    for (int i = 0; i < max_blocks; i++) {
-        init_docblock(&docblocks[i]);
-    }
-    docblocks[0].file_name = string_duplicate(file_path);
     parser_state_t state;
     if (!init_parser_state(&state, file_path, config)) {
         debug_message(config, "Failed to initialize parser state\n");
         return 0;
     }
-    int block_count = 1;
-    state.current_block = &docblocks[0];
-    char metadata_line[MAX_LINE_LENGTH];
-    rewind(state.file);
-    while (fgets(metadata_line, sizeof(metadata_line), state.file)) {
-        if (strncmp(metadata_line, "#!", 2) == 0) {
-            extract_shebang(metadata_line, &docblocks[0]);
-            continue;
-        }
-        size_t line_len = strlen(metadata_line);
-        if (line_len > 0 && metadata_line[line_len - 1] == '\n') {
-            metadata_line[line_len - 1] = '\0';
-        }
-        if (strncmp(metadata_line, "# @", 3) == 0) {
-            char *tag = extract_tag_name(metadata_line);
-            char *content = extract_tag_content(metadata_line);
-            if (tag && content) {
-                debug_message(config, "Found metadata tag: %s = %s\n", tag, content);
-                if (is_file_level_tag(tag)) {
-                    process_file_metadata_tag(&docblocks[0], tag, content);
-                }
-                
-                free(tag);
-                free(content);
-            }
-        } else if (!is_comment_line(metadata_line)) {
-            break;
-        }
-    }
-    rewind(state.file);
-    state.line_number = 0;
-    while (fgets(state.line, sizeof(state.line), state.file) && block_count < max_blocks) {
-        state.line_number++;
-        size_t len = strlen(state.line);
-        if (len > 0 && state.line[len - 1] == '\n') {
-            state.line[len - 1] = '\0';
-        }
-        debug_message(config, "Line %d: %s\n", state.line_number, state.line);
-        if (is_comment_line(state.line)) {
-            if (is_shellcheck_directive(state.line)) {
-                if (state.current_block != NULL && state.current_block != &docblocks[0]) {
-                    process_shellcheck_line(state.current_block, state.line);
-                }
-            }
-            if (is_tag_line(state.line)) {
-                char *tag = extract_tag_name(state.line);
-                char *content = extract_tag_content(state.line);
-                if (tag && content) {
-                    if (strcmp(tag, "function") == 0) {
-                        state.current_block = &docblocks[block_count++];
-                        init_docblock(state.current_block);
-                    }
-                    state_process_tag(&state, tag, content);
-                    free(tag);
-                    free(content);
-                }
-            } else if (is_function_declaration(state.line)) {
-                debug_message(config, "Found function declaration: %s\n", state.line);
-                char *func_name = extract_function_name(state.line);
-                if (func_name != NULL) {
-                    if (!state.in_docblock || state.current_block == NULL || state.current_block == &docblocks[0]) {
-                        state.current_block = &docblocks[block_count++];
-                        init_docblock(state.current_block);
-                    }
-                    if (state.current_block->function_name == NULL) {
-                        state.current_block->function_name = func_name;
-                    } else {
-                        if (strcmp(state.current_block->function_name, func_name) != 0) {
-                            debug_message(config, "Warning: Function declaration name mismatch. Expected %s, found %s.\n", state.current_block->function_name, func_name);
-                        }
-                        free(func_name);
-                    }
-                    debug_message(config, "Function declaration for %s at line %d\n", state.current_block->function_name, state.line_number);
-                    state.in_docblock = false;
-                }
-            }
-        } else {
-            state.in_docblock = false;
-        }
-    }
-    cleanup_parser_state(&state);
     
-    return block_count;
+    return parse_with_state(&state, file_path, config, docblocks);
 }
 
-extern void free_docblock(shellscribe_docblock_t *docblock);
-extern void free_docblocks(shellscribe_docblock_t *docblocks, int count);
-
 /**
- * @brief Check if a line is a comment line
+ * @brief Parse an in-memory shell script and extract documentation blocks
  * 
- * This function checks if a line is a comment line.
+ * Same as parse_shell_file(), but the contents of the script are taken from a
+ * buffer that the caller already loaded, so the file is not opened again. The
+ * buffer is split into lines in place: its newlines are replaced by NUL
+ * characters, and buffer[length] must be writable.
  * 
- * @param line The line to check
+ * @param file_path Path of the shell script, recorded as the file name of the first block
+ * @param buffer Contents of the shell script
+ * @param length Length of the contents in bytes
+ * @param config Configuration settings controlling parsing behavior
+ * @param docblocks List receiving the extracted documentation blocks (empty, with an arena, on entry)
+ * 
+ * @return int The number of documentation blocks found and processed,
+ *             or 0 if an error occurred
  * 
- * @return bool true if the line is a comment, false otherwise
+ * @see parse_shell_file
  */
-static char *parser_collect_continued_comment_content(parser_state_t *state, const char *initial_content) {
-    long pos = ftell(state->file);
-    size_t line_size = sizeof(state->line);
-    char *accumulated_content = string_duplicate(initial_content);
-    debug_message(state->config, "Collecting continued content starting with: '%s'\n", initial_content);
-    char line[MAX_LINE_LENGTH];
-    while (fgets(line, sizeof(line), state->file) != NULL) {
-        size_t len = strlen(line);
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-        }
-        if (is_comment_line(line) && !is_tag_line(line) && !is_special_annotation(line)) {
-            const char *comment_start = strchr(line, '#');
-            if (comment_start == NULL) {
-                continue;
-            }
-            comment_start++;
-            while (*comment_start && isspace(*comment_start)) {
-                comment_start++;
-            }
-            char *new_content = string_concat(accumulated_content, "\n");
-            void *ptr = accumulated_content;
-            shell_free(&ptr);
-            char *temp = new_content;
-            new_content = string_concat(temp, comment_start);
-            ptr = temp;
-            shell_free(&ptr);
-            
-            accumulated_content = new_content;
-        } else {
-            debug_message(state->config, "End of continuation detected: '%s'\n", line);
-            fseek(state->file, pos, SEEK_SET);
-            break;
-        }
-        pos = ftell(state->file);
+int parse_shell_buffer(const char *file_path, char *buffer, size_t length,
+    const shellscribe_config_t *config, shellscribe_docblock_list_t *docblocks) {
+    if (file_path == NULL || buffer == NULL || config == NULL || docblocks == NULL) {
+        return 0;
+    }
+    parser_state_t state;
+    if (!init_parser_state_from_buffer(&state, buffer, length, config)) {
+        debug_message(config, "Failed to initialize parser state\n");
+        return 0;
     }
     
-    debug_message(state->config, "Collected content: '%s'\n", accumulated_content);
-    return accumulated_content;
+    return parse_with_state(&state, file_path, config, docblocks);
 }
 
 /**
- * @brief Collect continued comment content
+ * @brief Start a new documentation block and make it the current one
  * 
- * This function collects all lines of a continued comment and returns the concatenated content.
+ * @param state Parser state
+ * @param docblocks List of documentation blocks to append the block to
  * 
- * @param state The parser state
- * @param initial_content The initial content to start with
+ * @return bool true if the block was started, false on allocation failure
  * 
- * @return char* The collected content
+ * @note Since the list may move its blocks when it grows, the pointers held by
+ *       the parser state are taken again from the list
  */
-char *collect_continued_comment_content(parser_state_t *state, const char *initial_content) {
-    return parser_collect_continued_comment_content(state, initial_content);
-}
-
-/**
- * @brief Wrapper functions to match the tag_handler_t signature
- */
-
-/**
- * @brief Wrapper for process_file_metadata_tag to match the tag_handler_t signature
- * 
- * @param docblock The documentation block
- * @param content The content of the tag
- * @return bool Result of the process_file_metadata_tag function
- */
-static bool process_file_tag_wrapper(shellscribe_docblock_t *docblock, const char *content) {
-    return process_file_metadata_tag(docblock, "file", content);
-}
-
-/**
- * @brief Wrapper for process_file_metadata_tag (name tag) to match the tag_handler_t signature
- * 
- * @param docblock The documentation block
- * @param content The content of the tag
- * @return bool Result of the process_file_metadata_tag function
- */
-static bool process_name_tag_wrapper(shellscribe_docblock_t *docblock, const char *content) {
-    return process_file_metadata_tag(docblock, "name", content);
-}
-
-/**
- * @brief Wrapper for process_example_tag to match the tag_handler_t signature
- * 
- * @param docblock The documentation block
- * @param content The content of the tag
- * @return bool Result of the add_example_to_docblock function
- */
-static bool process_example_tag_wrapper(shellscribe_docblock_t *docblock, const char *content) {
-    return false;
+static bool start_docblock(parser_state_t *state, shellscribe_docblock_list_t *docblocks) {
+    shellscribe_docblock_t *docblock = append_docblock(docblocks);
+    if (docblock == NULL) {
+        return false;
+    }
+    state->current_block = docblock;
+    state->file_block = &docblocks->blocks[0];
+    
+    return true;
 }
 
 /**
- * @brief Process a tag internally
+ * @brief Extract documentation blocks using an initialized parser state
  * 
- * This function delegates the processing of a tag to the appropriate handler
- * based on the tag type. It also handles file-level tags and function-level tags.
+ * Runs the metadata pass and the main parsing loop over the lines held by the
+ * parser state, then releases the state.
  * 
- * @param state The parser state
- * @param tag The tag to process
- * @param content The content associated with the tag
+ * @param state Initialized parser state
+ * @param file_path Path of the shell script, recorded as the file name of the first block
+ * @param config Configuration settings controlling parsing behavior
+ * @param docblocks List receiving the extracted documentation blocks (empty, with an arena, on entry)
  * 
- * @return bool true if the tag was processed successfully, false otherwise
+ * @return int The number of documentation blocks found and processed,
+ *             or 0 if memory allocation failed
  */
-static bool process_tag_internal(parser_state_t *state, const char *tag, const char *content) {
-    if (state == NULL || tag == NULL || content == NULL || state->current_block == NULL) {
-        return false;
-    }
-    typedef bool (*tag_handler_t)(shellscribe_docblock_t *, const char *);
-    typedef struct {
-        const char *tag;
-        tag_handler_t handler;
-    } tag_handler_entry_t;
-    static const tag_handler_entry_t tag_handlers[] = {
-        {"brief", process_description_tag},
-        {"file", process_file_tag_wrapper},
-        {"name", process_name_tag_wrapper},
-        {"arg", process_argument_tag},
-        {"noargs", NULL},
-        {"stdin", process_stdin_tag},
-        {"stdout", process_stdout_tag},
-        {"stderr", process_stderr_tag},
-        {"deprecated", process_deprecated_tag},
-        {"replacement", process_replacement_tag},
-        {"eol", process_eol_tag},
-        {"example", process_example_tag_wrapper},
-        {"dependency", process_dependency_tag},
-        {"requires", process_requires_tag},
-        {"used-by", process_used_by_tag},
-        {"calls", process_calls_tag},
-        {"provides", process_provides_tag},
-        {NULL, NULL}
-    };
-    if (strcmp(tag, "example") == 0) {
-        char *example_content = process_example_tag(state, content);
-        if (example_content != NULL) {
-            bool result = add_example_to_docblock(state->current_block, example_content);
-            free(example_content);
-            return result;
-        }
-        return false;
+static int parse_with_state(parser_state_t *state, const char *file_path, const shellscribe_config_t *config,
+    shellscribe_docblock_list_t *docblocks) {
+    if (!start_docblock(state, docblocks)) {
+        cleanup_parser_state(state);
+        return 0;
     }
-    for (const tag_handler_entry_t *entry = tag_handlers; entry->tag != NULL; ++entry) {
-        if (strcmp(tag, entry->tag) == 0) {
-            if (entry->handler) {
-                return entry->handler(state->current_block, content);
+    state->file_block->file_name = arena_strdup(state->file_block->arena, file_path);
+    state->in_header = true;
+    bool success = true;
+    while (success && state_next_line(state)) {
+        debug_message(config, "Line %d: %s\n", state->line_number, state->line);
+        switch (state->line_class.kind) {
+            case LINE_SHELLCHECK:
+                if (state->current_block != NULL && state->current_block != state->file_block) {
+                    add_shellcheck_directive(state->current_block, state->line + state->line_class.text);
+                }
+                break;
+            case LINE_TAG: {
+                tag_t tag = state->line_class.tag;
+                if (tag.id == TAG_FUNCTION) {
+                    success = start_docblock(state, docblocks);
+                }
+                if (success) {
+                    state_process_tag(state, &tag);
+                }
+                break;
             }
-            return true;
+            case LINE_COMMENT:
+            case LINE_SHEBANG:
+                break;
+            default:
+                // Blank lines, code and function declarations end the documentation block
+                state->in_docblock = false;
+                state_skip_code_lines(state);
+                break;
         }
     }
-
-    debug_message(state->config, "Unknown tag: @%s\n", tag);
-    return false;
+    cleanup_parser_state(state);
+    if (!success) {
+        debug_message(config, "Failed to allocate a documentation block\n");
+        return 0;
+    }
+    
+    return docblocks->count;
 }
+
+extern void free_docblock(shellscribe_docblock_t *docblock);
+extern void free_docblocks(shellscribe_docblock_t *docblocks, int count);
+
@@ -45,6 +45,7 @@ bool is_see_tag(const char *tag) {
  * 1. Simple format: "function_name" - for internal references
  * 2. Markdown link format: "[Display Name](URL)" - for external references
  *
+ * @param arena The arena allocating the extracted strings
  * @param content The content of the see tag to parse
  * @param name Pointer to a string pointer that will store the extracted name
  * @param url Pointer to a string pointer that will store the extracted URL
@@ -53,14 +54,13 @@ bool is_see_tag(const char *tag) {
  * @return bool true if parsing was successful and the reference was extracted,
  *              false if an error occurred or if required parameters are NULL
  *
- * @note Memory is allocated for the name and url (if present), which must be freed
- *       by the caller when no longer needed
+ * @note Memory for the name and url (if present) is allocated in the arena
  * @note If the reference is internal (simple format), url will be set to NULL and
  *       is_internal will be set to true
  * @note If the reference is external (Markdown link format), both name and url
  *       will be populated and is_internal will be set to false
  */
-bool parse_see_content(const char *content, char **name, char **url, bool *is_internal) {
+bool parse_see_content(arena_t *arena, const char *content, char **name, char **url, bool *is_internal) {
     if (content == NULL || name == NULL || url == NULL || is_internal == NULL) {
         return false;
     }
@@ -82,24 +82,19 @@ bool parse_see_content(const char *content, char **name, char **url, bool *is_in
         open_paren != NULL && close_paren != NULL &&
         open_bracket < close_bracket && close_bracket < open_paren && open_paren < close_paren) {
         size_t name_len = close_bracket - open_bracket - 1;
-        *name = malloc(name_len + 1);
+        *name = arena_strndup(arena, open_bracket + 1, name_len);
         if (*name == NULL) {
             return false;
         }
-        strncpy(*name, open_bracket + 1, name_len);
-        (*name)[name_len] = '\0';
         size_t url_len = close_paren - open_paren - 1;
-        *url = malloc(url_len + 1);
+        *url = arena_strndup(arena, open_paren + 1, url_len);
         if (*url == NULL) {
-            free(*name);
             *name = NULL;
             return false;
         }
-        strncpy(*url, open_paren + 1, url_len);
-        (*url)[url_len] = '\0';
         *is_internal = false;
     } else {
-        *name = string_duplicate(content);
+        *name = arena_strdup(arena, content);
         *url = NULL;
         *is_internal = true;
     }
@@ -122,8 +117,7 @@ bool parse_see_content(const char *content, char **name, char **url, bool *is_in
  *              false if an error occurred or if required parameters are NULL
  *
  * @note This function uses parse_see_content to extract the reference components
- * @note Memory is allocated for the reference information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the reference information is allocated in the arena of the docblock
  * @note References are stored in the see_also array of the docblock structure
  * 
  * @see parse_see_content
@@ -136,20 +130,16 @@ bool process_see_tag(shellscribe_docblock_t *docblock, const char *content) {
     char *name = NULL;
     char *url = NULL;
     bool is_internal = true;
-    if (!parse_see_content(content, &name, &url, &is_internal)) {
+    if (!parse_see_content(docblock->arena, content, &name, &url, &is_internal)) {
         return false;
     }
-    shellscribe_see_also_t *new_see_also = realloc(docblock->see_also, (docblock->see_also_count + 1) * sizeof(shellscribe_see_also_t));
-    if (new_see_also == NULL) {
-        free(name);
-        free(url);
+    shellscribe_see_also_t *reference = shellscribe_see_also_vector_push(&docblock->see_also, docblock->arena);
+    if (reference == NULL) {
         return false;
     }
-    docblock->see_also = new_see_also;
-    docblock->see_also[docblock->see_also_count].name = name;
-    docblock->see_also[docblock->see_also_count].url = url;
-    docblock->see_also[docblock->see_also_count].is_internal = is_internal;
-    docblock->see_also_count++;
+    reference->name = name;
+    reference->url = url;
+    reference->is_internal = is_internal;
     
     return true;
 } 
@@ -56,17 +56,15 @@ bool is_return_tag(const char *tag) {
  *              added to the docblock, false if an error occurred or if
  *              required parameters are NULL
  *
- * @note Any existing return value documentation in the docblock will be freed
- *       before the new content is assigned
- * @note Memory is allocated for the return value documentation, which will be freed
- *       when the docblock is freed
+ * @note Any existing return value documentation in the docblock is replaced
+ * @note Memory for the return value documentation is allocated in the
+ *       arena of the docblock.
  */
 bool process_return_tag(shellscribe_docblock_t *docblock, const char *content) {
     if (docblock == NULL || content == NULL) {
         return false;
     }
-    free(docblock->return_desc);
-    docblock->return_desc = string_duplicate(content);
+    docblock->return_desc = arena_strdup(docblock->arena, content);
     
     return (docblock->return_desc != NULL);
 }
@@ -108,8 +106,7 @@ bool process_returns_tag(shellscribe_docblock_t *docblock, const char *content)
  *
  * @note The expected format is "CODE description" where CODE is the numeric exit code
  *       and everything after the first space is considered the description
- * @note Memory is allocated for the exit code information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the exit code information is allocated in the arena of the docblock.
  * @note This function logs debug messages if debugging is enabled in the configuration
  * @note Exit codes are stored in the returns array of the docblock structure
  */
@@ -124,27 +121,20 @@ bool parse_exit_code(shellscribe_docblock_t *docblock, const char *content, cons
         value_end++;
     }
     if (value_end > content) {
-        char *value = (char *)shell_malloc(value_end - content + 1);
+        char *value = arena_strndup(docblock->arena, content, value_end - content);
         if (value == NULL) {
             return false;
         }
-        strncpy(value, content, value_end - content);
-        value[value_end - content] = '\0';
         const char *description = value_end;
         while (*description && isspace((unsigned char)*description)) {
             description++;
         }
-        void *new_returns = shell_realloc(docblock->returns, (docblock->return_count + 1) * sizeof(shellscribe_return_t));
-        if (new_returns == NULL) {
-            void *value_ptr = value;
-            shell_free(&value_ptr);
+        shellscribe_return_t *return_value = shellscribe_return_vector_push(&docblock->returns, docblock->arena);
+        if (return_value == NULL) {
             return false;
         }
-        
-        docblock->returns = new_returns;
-        ((shellscribe_return_t*)docblock->returns)[docblock->return_count].value = value;
-        ((shellscribe_return_t*)docblock->returns)[docblock->return_count].description = string_duplicate(description);
-        docblock->return_count++;
+        return_value->value = value;
+        return_value->description = arena_strdup(docblock->arena, description);
         debug_message(config, "Added exit code: value='%s', desc='%s'\n", value, description);
         
         return true;
@@ -57,8 +57,7 @@ bool is_section_tag(const char *tag) {
  *       (without spaces) and everything after the first space is the description
  * @note If the section content doesn't contain a space, the whole content is used
  *       as the section name with an empty description
- * @note Memory is allocated for the section information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the section information is allocated in the arena of the docblock
  * @note Multiple section tags can be used in a single docblock to create multiple
  *       sections within the documentation
  */
@@ -74,31 +73,20 @@ bool process_section_tag(shellscribe_docblock_t *docblock, const char *content)
         return false;
     }
     size_t name_len = name_end - content;
-    char *name = (char *)shell_malloc(name_len + 1);
+    char *name = arena_strndup(docblock->arena, content, name_len);
     if (name == NULL) {
         return false;
     }
-    strncpy(name, content, name_len);
-    name[name_len] = '\0';
     const char *description = (*name_end) ? name_end + 1 : "";
     if (docblock->section == NULL) {
-        docblock->section = shell_malloc(sizeof(shellscribe_section_t));
+        docblock->section = arena_alloc(docblock->arena, sizeof(shellscribe_section_t));
         if (docblock->section == NULL) {
-            void *name_ptr = name;
-            shell_free(&name_ptr);
             return false;
         }
-    } else {
-        void *old_name = docblock->section->name;
-        void *old_description = docblock->section->description;
-        shell_free(&old_name);
-        shell_free(&old_description);
     }
     docblock->section->name = name;
-    docblock->section->description = string_duplicate(description);
+    docblock->section->description = arena_strdup(docblock->arena, description);
     if (docblock->section->description == NULL) {
-        void *name_ptr = name;
-        shell_free(&name_ptr);
         return false;
     }
     
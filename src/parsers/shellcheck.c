@@ -7,18 +7,29 @@
  * comments that control the behavior of the shellcheck static analysis tool
  * when examining shell scripts. This parser identifies and extracts these
  * directives so they can be included in the generated output.
+ *
+ * A directive is scanned once, without intermediate copies: each code it
+ * disables or enables becomes an entry of its own, recorded both as an
+ * interned string and as a number (2034 for SC2034). Any other directive
+ * (source=, shell=, ...) is recorded whole, as a single entry.
  */
 
 #define _GNU_SOURCE
 
 #include "parsers/types.h"
 #include "utils/string.h"
+#include "utils/intern.h"
 #include "utils/debug.h"
-#include "utils/memory.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <ctype.h>
-#include <regex.h>
+
+/**
+ * @brief Keyword opening a shellcheck directive (matched case-insensitively)
+ */
+#define SHELLCHECK_KEYWORD "shellcheck"
 
 /**
  * @brief Check if a line contains a shellcheck directive
@@ -49,7 +60,7 @@ bool is_shellcheck_directive(const char *line) {
     while (*line && isspace(*line)) {
         line++;
     }
-    return (strncasecmp(line, "shellcheck", 10) == 0);
+    return (strncasecmp(line, SHELLCHECK_KEYWORD, strlen(SHELLCHECK_KEYWORD)) == 0);
 }
 
 /**
@@ -86,58 +97,130 @@ char *extract_shellcheck_directive(const char *line) {
 }
 
 /**
- * @brief Parse a shellcheck directive to extract code and reason
- * 
- * This function parses a shellcheck directive like "shellcheck disable=SC2034 # Reason"
- * to extract the code (SC2034) and the reason (if provided after a # or comment).
+ * @brief Largest numeric shellcheck code
+ */
+#define SHELLCHECK_MAX_CODE 99999
+
+/**
+ * @brief A shellcheck directive being scanned
+ */
+typedef struct {
+    shellscribe_docblock_t *docblock;   // Block receiving the entries
+    const char *reason_start;           // Reason of the directive in the scanned text
+    size_t reason_length;               // Length of the reason (0 if none)
+    char *reason;                       // Copy of the reason, made for the first entry and shared by the others
+} shellcheck_scan_t;
+
+/**
+ * @brief Parse a numeric shellcheck code
  *
- * @param directive The full shellcheck directive to parse
- * @param code Pointer to store the extracted code
- * @param reason Pointer to store the extracted reason
+ * @param code The code, with or without its "SC" prefix (e.g., "SC2034" or "2034")
+ * @param length The length of the code
  *
- * @return bool true if parsing was successful, false otherwise
+ * @return int The number of the code (2034 for SC2034), 0 if the code is not numeric
+ */
+static int parse_shellcheck_code(const char *code, size_t length) {
+    if (length > 2 && toupper((unsigned char)code[0]) == 'S' && toupper((unsigned char)code[1]) == 'C') {
+        code += 2;
+        length -= 2;
+    }
+    if (length == 0) {
+        return 0;
+    }
+    int number = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (!isdigit((unsigned char)code[i]) || number > SHELLCHECK_MAX_CODE / 10) {
+            return 0;
+        }
+        number = number * 10 + (code[i] - '0');
+    }
+    
+    return (number <= SHELLCHECK_MAX_CODE) ? number : 0;
+}
+
+/**
+ * @brief Add an entry of a scanned directive to its documentation block
+ *
+ * @param scan The directive being scanned
+ * @param code The interned code of the entry
+ * @param code_number The number of the code, 0 if it is not numeric
  *
- * @note Both code and reason will be newly allocated strings that must be freed by the caller
- * @note If no reason is provided, *reason will be NULL
+ * @return bool true if the entry was added, false on allocation failure
  */
-bool parse_shellcheck_directive(const char *directive, char **code, char **reason) {
-    if (directive == NULL || code == NULL || reason == NULL) {
+static bool add_shellcheck_entry(shellcheck_scan_t *scan, const char *code, int code_number) {
+    if (code == NULL) {
         return false;
     }
-    
-    *code = NULL;
-    *reason = NULL;
-    const char *sc_start = NULL;
-    const char *disable_pattern = strstr(directive, "disable=");
-    const char *enable_pattern = strstr(directive, "enable=");
-    if (disable_pattern) {
-        sc_start = disable_pattern + 8;
-    } else if (enable_pattern) {
-        sc_start = enable_pattern + 7;
-    }
-    if (!sc_start) {
-        *code = string_duplicate(directive);
-        return true;
-    }    const char *code_end = sc_start;
-    while (*code_end && !isspace(*code_end) && *code_end != '#') {
-        code_end++;
-    }
-    size_t code_len = code_end - sc_start;
-    *code = (char *)shell_malloc(code_len + 1);
-    if (*code == NULL) {
+    if (scan->reason == NULL && scan->reason_length > 0) {
+        scan->reason = arena_strndup(scan->docblock->arena, scan->reason_start, scan->reason_length);
+        if (scan->reason == NULL) {
+            return false;
+        }
+    }
+    shellscribe_shellcheck_t *entry = shellscribe_shellcheck_vector_push(&scan->docblock->shellcheck_directives, scan->docblock->arena);
+    if (entry == NULL) {
         return false;
     }
-    strncpy(*code, sc_start, code_len);
-    (*code)[code_len] = '\0';
-    const char *reason_start = strchr(code_end, '#');
-    if (reason_start) {
-        reason_start++;
-        while (*reason_start && isspace(*reason_start)) {
-            reason_start++;
+    entry->code = code;
+    entry->code_number = code_number;
+    entry->reason = scan->reason;
+    
+    return true;
+}
+
+/**
+ * @brief Check if a "key=value" setting lists codes
+ *
+ * @param setting The setting
+ * @param equals The '=' of the setting
+ *
+ * @return bool true if the key is disable or enable (matched
+ *              case-insensitively, like the shellcheck keyword)
+ */
+static bool is_shellcheck_list(const char *setting, const char *equals) {
+    size_t key_length = (size_t)(equals - setting);
+    
+    return (key_length == 7 && strncasecmp(setting, "disable", 7) == 0) ||
+           (key_length == 6 && strncasecmp(setting, "enable", 6) == 0);
+}
+
+/**
+ * @brief Add the entries of a disable or enable setting of a scanned directive
+ *
+ * The value is a list of codes separated by commas, each non-empty one of
+ * which gets its own entry: numeric codes are recorded in their canonical
+ * "SC" form along with their number, and named checks (e.g., "all" or
+ * "require-variable-braces") as written.
+ *
+ * @param scan The directive being scanned
+ * @param equals The '=' of the setting
+ * @param end The end of the setting
+ *
+ * @return bool true if the entries were added, false on allocation failure
+ */
+static bool scan_shellcheck_list(shellcheck_scan_t *scan, const char *equals, const char *end) {
+    const char *item = equals + 1;
+    while (item < end) {
+        const char *item_end = item;
+        while (item_end < end && *item_end != ',') {
+            item_end++;
         }
-        if (*reason_start) {
-            *reason = string_duplicate(reason_start);
+        size_t length = (size_t)(item_end - item);
+        if (length > 0) {
+            int code_number = parse_shellcheck_code(item, length);
+            const char *code;
+            if (code_number > 0) {
+                char canonical[16];
+                int canonical_length = snprintf(canonical, sizeof(canonical), "SC%d", code_number);
+                code = intern_string_length(canonical, (size_t)canonical_length);
+            } else {
+                code = intern_string_length(item, length);
+            }
+            if (!add_shellcheck_entry(scan, code, code_number)) {
+                return false;
+            }
         }
+        item = item_end + 1;
     }
     
     return true;
@@ -146,9 +229,12 @@ bool parse_shellcheck_directive(const char *directive, char **code, char **reaso
 /**
  * @brief Add a shellcheck directive to a documentation block
  *
- * Adds a shellcheck directive to the specified documentation block by
- * adding it to the directives array. The directive is parsed to extract
- * the code and reason.
+ * Scans a directive like "shellcheck disable=SC2034,SC2086 # Reason" in a
+ * single pass: the disable and enable settings before the first '#' are
+ * split into one entry per code, and the text after it is the reason shared
+ * by all of them. A directive without any such setting (e.g., "shellcheck
+ * source=/dev/null") is recorded as a single entry whose code is the whole
+ * directive.
  *
  * @param docblock The documentation block to add the directive to
  * @param directive The shellcheck directive to add
@@ -156,38 +242,62 @@ bool parse_shellcheck_directive(const char *directive, char **code, char **reaso
  * @return bool true if the directive was successfully added,
  *              false if memory allocation failed or parameters are NULL
  *
- * @note This function allocates memory for the directive details, which will be freed
- *       when the docblock is freed
- * @note The directive is parsed to extract the code (e.g., SC2034) and reason
+ * @note The codes are interned, and the reason is allocated once in the
+ *       arena of the docblock, whatever the number of entries it is shared by
  */
 bool add_shellcheck_directive(shellscribe_docblock_t *docblock, const char *directive) {
     if (docblock == NULL || directive == NULL) {
         return false;
     }
-    shellscribe_shellcheck_t *new_directives = shell_realloc(docblock->shellcheck_directives, 
-                               (docblock->shellcheck_count + 1) * sizeof(shellscribe_shellcheck_t));
-    if (new_directives == NULL) {
-        return false;
+    shellcheck_scan_t scan = {
+        .docblock = docblock,
+        .reason_start = NULL,
+        .reason_length = 0,
+        .reason = NULL
+    };
+    const char *end = strchr(directive, '#');
+    if (end != NULL) {
+        const char *reason = end + 1;
+        while (isspace((unsigned char)*reason)) {
+            reason++;
+        }
+        const char *reason_end = reason + strlen(reason);
+        while (reason_end > reason && isspace((unsigned char)reason_end[-1])) {
+            reason_end--;
+        }
+        scan.reason_start = reason;
+        scan.reason_length = (size_t)(reason_end - reason);
+    } else {
+        end = directive + strlen(directive);
     }
-    docblock->shellcheck_directives = new_directives;
-    shellscribe_shellcheck_t *new_entry = &docblock->shellcheck_directives[docblock->shellcheck_count];
-    memset(new_entry, 0, sizeof(shellscribe_shellcheck_t));
-    char *code = NULL;
-    char *reason = NULL;
-    if (!parse_shellcheck_directive(directive, &code, &reason)) {
-        return false;
+    const char *p = directive;
+    if (strncasecmp(p, SHELLCHECK_KEYWORD, strlen(SHELLCHECK_KEYWORD)) == 0) {
+        p += strlen(SHELLCHECK_KEYWORD);
     }
-    new_entry->directive = string_duplicate(directive);
-    new_entry->code = code;
-    new_entry->reason = reason;
-    if (new_entry->directive == NULL) {
-        void *code_ptr = code;
-        void *reason_ptr = reason;
-        shell_free(&code_ptr);
-        shell_free(&reason_ptr);
-        return false;
+    int lists = 0;
+    while (p < end) {
+        while (p < end && isspace((unsigned char)*p)) {
+            p++;
+        }
+        const char *setting = p;
+        const char *equals = NULL;
+        while (p < end && !isspace((unsigned char)*p)) {
+            if (*p == '=' && equals == NULL) {
+                equals = p;
+            }
+            p++;
+        }
+        if (equals != NULL && equals > setting && is_shellcheck_list(setting, equals)) {
+            if (!scan_shellcheck_list(&scan, equals, p)) {
+                return false;
+            }
+            lists++;
+        }
+    }
+    if (lists == 0) {
+        scan.reason_length = 0;
+        return add_shellcheck_entry(&scan, intern_string(directive), 0);
     }
-    docblock->shellcheck_count++;
     
     return true;
 }
@@ -195,8 +305,9 @@ bool add_shellcheck_directive(shellscribe_docblock_t *docblock, const char *dire
 /**
  * @brief Process a line containing a shellcheck directive
  *
- * Processes a line of text that contains a shellcheck directive by extracting
- * the directive and adding it to the documentation block.
+ * Processes a line of text that contains a shellcheck directive by skipping
+ * the comment symbol in front of the directive and adding it to the
+ * documentation block.
  *
  * @param docblock The documentation block to add the directive to
  * @param line The line of text containing a shellcheck directive
@@ -204,13 +315,9 @@ bool add_shellcheck_directive(shellscribe_docblock_t *docblock, const char *dire
  * @return bool true if the directive was successfully processed and added,
  *              false if an error occurred or if parameters are NULL
  *
- * @note This function first extracts the shellcheck directive using
- *       extract_shellcheck_directive(), then adds it to the docblock using
- *       add_shellcheck_directive()
  * @note The line must be a valid shellcheck directive (should be verified
  *       first with is_shellcheck_directive())
  * @see is_shellcheck_directive()
- * @see extract_shellcheck_directive()
  * @see add_shellcheck_directive()
  */
 bool process_shellcheck_line(shellscribe_docblock_t *docblock, const char *line) {
@@ -220,13 +327,13 @@ bool process_shellcheck_line(shellscribe_docblock_t *docblock, const char *line)
     if (!is_shellcheck_directive(line)) {
         return false;
     }
-    char *directive = extract_shellcheck_directive(line);
-    if (directive == NULL) {
-        return false;
+    while (isspace((unsigned char)*line)) {
+        line++;
+    }
+    line++;
+    while (isspace((unsigned char)*line)) {
+        line++;
     }
-    bool result = add_shellcheck_directive(docblock, directive);
-    void *directive_ptr = directive;
-    shell_free(&directive_ptr);
     
-    return result;
-} 
+    return add_shellcheck_directive(docblock, line);
+}
@@ -20,29 +20,29 @@
 #include "parsers/alert.h"
 #include "utils/string.h"
 #include "utils/debug.h"
+#include "utils/memory.h"
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
 // External functions declared in other files
-extern bool is_comment_line(const char *line);
+extern bool extract_shebang(const char *line, shellscribe_docblock_t *docblock);
 
 /**
  * @brief Initialize the parser state
  * 
- * This function initializes the parser state structure and opens the file for reading.
- * It sets up the initial state for parsing a file, opening the specified file and
- * associating it with the parser state.
+ * This function initializes the parser state structure and reads the file.
+ * It sets up the initial state for parsing a file, loading the whole file at
+ * once and splitting it into lines.
  *
  * @param state The parser state structure to initialize
  * @param file_path Path to the file to be parsed
  * @param config Configuration settings for the parser
  *
  * @return bool true if initialization was successful, false otherwise
- *              (e.g., if the file could not be opened or parameters are NULL)
+ *              (e.g., if the file could not be read or parameters are NULL)
  *
  * @note This function must be called before using any other parser state functions
- * @note The opened file will need to be closed using cleanup_parser_state()
+ * @note The contents of the file will need to be released using cleanup_parser_state()
  */
 bool init_parser_state(parser_state_t *state, const char *file_path, const shellscribe_config_t *config) {
     if (state == NULL || file_path == NULL || config == NULL) {
@@ -50,8 +50,7 @@ bool init_parser_state(parser_state_t *state, const char *file_path, const shell
     }
     memset(state, 0, sizeof(parser_state_t));
     state->config = config;
-    state->file = fopen(file_path, "r");
-    if (state->file == NULL) {
+    if (!line_scanner_load(&state->scanner, file_path)) {
         debug_message(config, "Failed to open file: %s\n", file_path);
         return false;
     }
@@ -59,33 +58,225 @@ bool init_parser_state(parser_state_t *state, const char *file_path, const shell
     return true;
 }
 
+/**
+ * @brief Initialize the parser state over an in-memory copy of a file
+ * 
+ * This function initializes the parser state structure so that lines are read
+ * from a buffer that already holds the contents of the file, instead of opening
+ * the file again. The buffer is split into lines in place, so that lines are
+ * never copied.
+ *
+ * @param state The parser state structure to initialize
+ * @param buffer Contents of the file to parse; newlines are replaced by NUL
+ *               characters and buffer[length] must be writable
+ * @param length Length of the contents in bytes
+ * @param config Configuration settings for the parser
+ *
+ * @return bool true if initialization was successful, false otherwise
+ *
+ * @note The buffer must stay valid until cleanup_parser_state() is called
+ */
+bool init_parser_state_from_buffer(parser_state_t *state, char *buffer, size_t length, const shellscribe_config_t *config) {
+    if (state == NULL || buffer == NULL || config == NULL) {
+        return false;
+    }
+    memset(state, 0, sizeof(parser_state_t));
+    state->config = config;
+    if (!line_scanner_init(&state->scanner, buffer, length)) {
+        debug_message(config, "Failed to split in-memory file buffer into lines\n");
+        return false;
+    }
+    
+    return true;
+}
+
 /**
  * @brief Clean up resources used by the parser state
  * 
- * This function closes the file associated with the parser state and frees any 
- * allocated memory. It should be called when parsing is complete or when an error 
+ * This function releases the lines of the file associated with the parser
+ * state. It should be called when parsing is complete or when an error 
  * occurs during parsing.
  *
  * @param state The parser state structure to clean up
  *
- * @note This function checks if the state or file pointer is NULL before attempting
- *       to close the file
+ * @note This function checks if the state is NULL before releasing its resources
  * @note This function does not free the state structure itself, only resources
  *       owned by it
  */
 void cleanup_parser_state(parser_state_t *state) {
-    if (state != NULL && state->file != NULL) {
-        fclose(state->file);
-        state->file = NULL;
+    if (state != NULL) {
+        line_scanner_free(&state->scanner);
+        state->line = NULL;
+        state->line_length = 0;
+    }
+}
+
+/**
+ * @brief Look at a line after the current one without consuming it
+ * 
+ * Collectors of multi-line tags use this function to check whether the next
+ * line continues the tag before consuming it, so that the line ending the tag
+ * is left for the main parsing loop without any backtracking.
+ *
+ * @param state The current parser state
+ * @param ahead The number of lines to look past (0 for the line following the current one)
+ * @param line Filled with the line
+ *
+ * @return bool true if the line exists, false past the end of the file
+ */
+bool state_peek_line(const parser_state_t *state, size_t ahead, line_span_t *line) {
+    if (state == NULL || line == NULL) {
+        return false;
+    }
+    
+    return line_scanner_peek(&state->scanner, ahead, line);
+}
+
+/**
+ * @brief Classify the line following the current one without consuming it
+ * 
+ * Collectors of multi-line tags decide from the kind of the next line whether
+ * it continues the tag. The classification is kept, so that consuming the
+ * line right after does not classify it a second time.
+ *
+ * @param state The current parser state
+ * @param line Filled with the line
+ *
+ * @return const line_class_t* The classification of the line, NULL past the end of the file
+ */
+const line_class_t *state_peek_class(parser_state_t *state, line_span_t *line) {
+    if (state == NULL || line == NULL || !line_scanner_peek(&state->scanner, 0, line)) {
+        return NULL;
+    }
+    if (!state->next_classified) {
+        classify_line_at(line->start, line->length, line->indent,
+                         line_scanner_tell(&state->scanner) == 0, &state->next_class);
+        state->next_classified = true;
+    }
+    
+    return &state->next_class;
+}
+
+/**
+ * @brief Record the file-level metadata of a header line
+ * 
+ * The header of a script is made of the comment lines at its top. Its shebang
+ * always goes to the file-level block, and so does a "#!" comment starting a
+ * later header line. Its file-level tags are processed by
+ * state_process_tag() while the file-level block is current; when a @function
+ * tag inside the header has already opened another block, they still go to the
+ * file-level block as well, unless a tag of the same name was processed there
+ * before the switch (which then takes precedence).
+ *
+ * @param state The current parser state, whose current line was just consumed
+ *
+ * @note The header ends at the first line that is not a comment
+ */
+static void state_scan_header_line(parser_state_t *state) {
+    const line_class_t *cls = &state->line_class;
+    if (cls->kind == LINE_SHEBANG || (cls->kind == LINE_COMMENT && cls->indent == 0 && state->line[1] == '!')) {
+        extract_shebang(state->line, state->file_block);
+        return;
+    }
+    if (cls->kind == LINE_TAG && cls->indent == 0) {
+        const tag_t *tag = &cls->tag;
+        if (state->current_block == state->file_block) {
+            return;
+        }
+        if (get_tag_spec(tag->id)->file_level && (state->file_tags_seen & (UINT64_C(1) << tag->id)) == 0) {
+            debug_message(state->config, "Found metadata tag: %s = %s\n", tag_id_name(tag->id), tag->content);
+            process_file_metadata_tag(state->file_block, tag_id_name(tag->id), tag->content);
+        }
+    } else if (!line_kind_is_comment(cls->kind)) {
+        state->in_header = false;
+    }
+}
+
+/**
+ * @brief Consume the next line, making it the current line
+ * 
+ * This function advances the shared line cursor of the parser state, used by
+ * the main parsing loop and by the collectors of multi-line tags alike, and
+ * keeps the current line, its classification and its number up to date. A
+ * line is classified once, when it is consumed or first peeked at, and every
+ * parser stage then works from that classification. While the header of the
+ * file is being consumed, its file-level metadata is recorded on the way, so
+ * that the file is parsed in a single pass.
+ *
+ * @param state The current parser state
+ *
+ * @return bool true if a line was consumed, false at the end of the file
+ */
+bool state_next_line(parser_state_t *state) {
+    if (state == NULL) {
+        return false;
+    }
+    line_span_t span;
+    if (!line_scanner_next(&state->scanner, &span)) {
+        return false;
+    }
+    state->line = span.start;
+    state->line_length = span.length;
+    state->line_number = (int)line_scanner_tell(&state->scanner);
+    if (state->next_classified) {
+        state->line_class = state->next_class;
+        state->next_classified = false;
+    } else {
+        classify_line_at(span.start, span.length, span.indent, state->line_number == 1, &state->line_class);
+    }
+    if (state->in_header && state->file_block != NULL) {
+        state_scan_header_line(state);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Consume the run of code lines following the current one
+ * 
+ * Once a line has ended the documentation block, the code lines that follow
+ * it have no effect on parsing. They are told apart from the flags that the
+ * line scanner computed while splitting the file, so they are skipped without
+ * being classified or even read. Lines that may declare a function, because
+ * they hold a parenthesis or start with the function keyword, stop the run so
+ * that they are classified like any other line.
+ *
+ * @param state The current parser state, whose current line is not a comment
+ *
+ * @return size_t The number of lines skipped
+ *
+ * @note Must not be called while the header is being scanned, since skipped
+ *       lines are not seen by state_next_line()
+ */
+size_t state_skip_code_lines(parser_state_t *state) {
+    if (state == NULL || state->in_header) {
+        return 0;
+    }
+    const line_scanner_t *scanner = &state->scanner;
+    size_t position = line_scanner_tell(scanner);
+    size_t end = position;
+    while (end < scanner->line_count) {
+        const line_span_t *span = &scanner->lines[end];
+        if ((span->flags & (LINE_SPAN_COMMENT | LINE_SPAN_PAREN)) != 0
+            || strncmp(span->start + span->indent, "function", 8) == 0) {
+            break;
+        }
+        end++;
     }
+    if (end > position) {
+        line_scanner_seek(&state->scanner, end);
+        state->next_classified = false;
+    }
+    
+    return end - position;
 }
 
 /**
  * @brief Collect content that continues across multiple lines
  * 
  * This function collects all lines of a continued comment block and returns the
- * concatenated content. It reads subsequent lines from the file until it encounters
- * a line that is not a continuation of the current comment or tag.
+ * concatenated content. It consumes subsequent lines as long as they continue
+ * the current comment or tag.
  *
  * @param state The current parser state
  * @param initial_content The initial content of the comment or tag
@@ -94,156 +285,351 @@ void cleanup_parser_state(parser_state_t *state) {
  *               all continuation lines, or NULL if an error occurred
  *
  * @note The returned string must be freed by the caller
- * @note This function preserves the file position if it encounters a line that is
- *       not part of the continued content
+ * @note The content is accumulated in a string builder, so that collecting
+ *       it takes time linear in its length
+ * @note The line ending the continued content is only peeked at, so it is
+ *       left for the caller
  * @note Continuation lines must be comment lines without tags or special annotations
  * @note This function adds newlines between the content from different lines
  */
 char *state_collect_continued_content(parser_state_t *state, const char *initial_content) {
-    if (state == NULL || initial_content == NULL || state->file == NULL) {
+    if (state == NULL || initial_content == NULL) {
+        return NULL;
+    }
+    string_builder_t builder;
+    string_builder_init(&builder, NULL);
+    if (!string_builder_append(&builder, initial_content)) {
         return NULL;
     }
-    long pos = ftell(state->file);
-    char *accumulated_content = string_duplicate(initial_content);
     debug_message(state->config, "Collecting continued content starting with: '%s'\n", initial_content);
-    char line[MAX_LINE_LENGTH];
-    while (fgets(line, sizeof(line), state->file) != NULL) {
-        size_t len = strlen(line);
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-        }
-        if (is_comment_line(line) && !is_tag_line(line) && !is_special_annotation(line)) {
-            const char *comment_start = strchr(line, '#');
-            if (comment_start == NULL) {
-                continue;
-            }
-            comment_start++;
-            while (*comment_start && isspace(*comment_start)) {
-                comment_start++;
-            }
-            debug_message(state->config, "Found continuation line: '%s'\n", comment_start);
-            char *new_content = string_concat(accumulated_content, "\n");
-            free(accumulated_content);
-            char *temp = new_content;
-            new_content = string_concat(temp, comment_start);
-            free(temp);
-            
-            accumulated_content = new_content;
-        } else {
-            debug_message(state->config, "End of continuation detected: '%s'\n", line);
-            fseek(state->file, pos, SEEK_SET);
+    line_span_t span;
+    const line_class_t *next;
+    while ((next = state_peek_class(state, &span)) != NULL) {
+        if (!line_kind_is_comment(next->kind) || next->kind == LINE_TAG || is_special_annotation(span.start)) {
+            debug_message(state->config, "End of continuation detected: '%s'\n", span.start);
             break;
         }
-        pos = ftell(state->file);
+        state_next_line(state);
+        const char *comment_start = state->line + state->line_class.text;
+        debug_message(state->config, "Found continuation line: '%s'\n", comment_start);
+        if (!string_builder_append_length(&builder, "\n", 1)
+            || !string_builder_append_length(&builder, comment_start, state->line_length - state->line_class.text)) {
+            string_builder_free(&builder);
+            return NULL;
+        }
     }
-    
+    char *accumulated_content = string_builder_finish(&builder);
     debug_message(state->config, "Collected content: '%s'\n", accumulated_content);
     return accumulated_content;
 }
 
+/**
+ * @brief Store file-level metadata in the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_file_metadata_tag()
+ */
+static bool handle_file_metadata_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    return process_file_metadata_tag(state->current_block, tag_id_name(id), content);
+}
+
+/**
+ * @brief Record the documented function of the current block
+ *
+ * A trailing "()" is removed from the name, and the lines that follow belong
+ * to the documentation of the function until its declaration.
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Always true
+ */
+static bool handle_function_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    char* parentheses = strstr(content, "()");
+    if (parentheses != NULL && parentheses[2] == '\0') {
+        state->current_block->function_name = arena_strndup(state->current_block->arena, content, parentheses - content);
+    } else {
+        state->current_block->function_name = arena_strdup(state->current_block->arena, content);
+    }
+    state->in_docblock = true;
+    return true;
+}
+
+/**
+ * @brief Record the brief of the file or of the function of the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Always true
+ */
+static bool handle_brief_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    if (state->current_block->function_name == NULL) {
+        state->current_block->brief = arena_strdup(state->current_block->arena, content);
+    } else {
+        state->current_block->function_brief = arena_strdup(state->current_block->arena, content);
+    }
+    return true;
+}
+
+/**
+ * @brief Add an argument (@arg or @argument) to the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_argument_tag()
+ */
+static bool handle_argument_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    return process_argument_tag(state->current_block, content);
+}
+
+/**
+ * @brief Add a parameter to the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_parameter_tag()
+ */
+static bool handle_param_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    return process_parameter_tag(state->current_block, content);
+}
+
+/**
+ * @brief Record the return value of the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_return_tag()
+ */
+static bool handle_return_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    return process_return_tag(state->current_block, content);
+}
+
+/**
+ * @brief Add a return value (@returns) to the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_returns_tag()
+ */
+static bool handle_returns_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    return process_returns_tag(state->current_block, content);
+}
+
+/**
+ * @brief Add an exit code to the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_exitcode_tag()
+ */
+static bool handle_exitcode_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    return process_exitcode_tag(state->current_block, content);
+}
+
+/**
+ * @brief Add an example, read from the following lines, to the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of process_example_using_state()
+ */
+static bool handle_example_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    return process_example_using_state(state, content);
+}
+
+/**
+ * @brief Record the standard output of the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag, collected across continuation lines
+ *
+ * @return bool Always true
+ */
+static bool handle_stdout_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    state->current_block->stdout_doc = arena_strdup(state->current_block->arena, content);
+    return true;
+}
+
+/**
+ * @brief Record the standard error of the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Always true
+ */
+static bool handle_stderr_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    state->current_block->stderr_doc = arena_strdup(state->current_block->arena, content);
+    return true;
+}
+
+/**
+ * @brief Mark the current block as internal
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag (ignored)
+ *
+ * @return bool Always true
+ */
+static bool handle_internal_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    (void)id;
+    (void)content;
+    state->current_block->is_internal = true;
+    return true;
+}
+
+/**
+ * @brief Add an alert of the type given by the tag table to the current block
+ *
+ * @param state The current parser state
+ * @param id The identifier of the tag
+ * @param content The content of the tag
+ *
+ * @return bool Result of add_alert_to_docblock()
+ */
+static bool handle_alert_tag(parser_state_t *state, tag_id_t id, const char *content) {
+    return add_alert_to_docblock(state->current_block, get_tag_spec(id)->alert_type, content);
+}
+
+/**
+ * @brief Dispatch information of the known tags, indexed by identifier
+ *
+ * This table is the only place describing how a tag is processed: the main
+ * parsing loop, the header scan and the alert parser all consult it.
+ *
+ * @note Every file-level tag goes to process_file_metadata_tag(), which
+ *       ignores the ones it has no field for; in particular, @description is
+ *       file-level metadata and is therefore not continued
+ */
+static const tag_spec_t tag_specs[TAG_ID_COUNT] = {
+    [TAG_UNKNOWN] = {NULL, false, false, NULL},
+    [TAG_FILE] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_VERSION] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_AUTHOR] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_LICENSE] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_COPYRIGHT] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_SINCE] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_DESCRIPTION] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_PACKAGE] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_MODULE] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_LINK] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_REPO] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_SEE] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_ENV] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_SKIP] = {handle_file_metadata_tag, true, false, NULL},
+    [TAG_FUNCTION] = {handle_function_tag, false, false, NULL},
+    [TAG_BRIEF] = {handle_brief_tag, false, false, NULL},
+    [TAG_ARG] = {handle_argument_tag, false, false, NULL},
+    [TAG_ARGUMENT] = {handle_argument_tag, false, false, NULL},
+    [TAG_PARAM] = {handle_param_tag, false, false, NULL},
+    [TAG_RETURN] = {handle_return_tag, false, false, NULL},
+    [TAG_RETURNS] = {handle_returns_tag, false, false, NULL},
+    [TAG_EXITCODE] = {handle_exitcode_tag, false, false, NULL},
+    [TAG_EXAMPLE] = {handle_example_tag, false, false, NULL},
+    [TAG_STDOUT] = {handle_stdout_tag, false, true, NULL},
+    [TAG_STDERR] = {handle_stderr_tag, false, false, NULL},
+    [TAG_INTERNAL] = {handle_internal_tag, false, false, NULL},
+    [TAG_NOTE] = {handle_alert_tag, false, false, "NOTE"},
+    [TAG_WARNING] = {handle_alert_tag, false, false, "WARNING"},
+    [TAG_ERROR] = {handle_alert_tag, false, false, "NOTE"},
+    [TAG_TIP] = {handle_alert_tag, false, false, "TIP"},
+    [TAG_IMPORTANT] = {handle_alert_tag, false, false, "IMPORTANT"},
+    [TAG_INFO] = {handle_alert_tag, false, false, "INFO"},
+    [TAG_DANGER] = {handle_alert_tag, false, false, "DANGER"},
+    [TAG_HINT] = {handle_alert_tag, false, false, "TIP"},
+    [TAG_CAUTION] = {handle_alert_tag, false, false, "CAUTION"},
+    [TAG_ALERT] = {handle_alert_tag, false, false, "NOTE"}
+};
+
+/**
+ * @brief Get the dispatch information of a tag
+ *
+ * @param id The identifier of the tag
+ *
+ * @return const tag_spec_t* The dispatch information of the tag; for
+ *         TAG_UNKNOWN or an invalid identifier, an entry without handler
+ */
+const tag_spec_t *get_tag_spec(tag_id_t id) {
+    if ((unsigned int)id >= TAG_ID_COUNT) {
+        id = TAG_UNKNOWN;
+    }
+    return &tag_specs[id];
+}
+
 /**
  * @brief Process a tag in the current parser state
  * 
  * This function processes a documentation tag and its content, updating the current
- * documentation block accordingly. It handles various tag types, including metadata
- * tags, function tags, parameter tags, return tags, and more.
+ * documentation block accordingly. The tag was resolved to its identifier when its
+ * line was lexed, so dispatching only indexes the tag table: the handler of the tag
+ * is called with its content, first collected across the following comment lines
+ * for continued tags.
  *
  * @param state The current parser state
- * @param tag The tag name (without the '@' prefix)
- * @param content The content associated with the tag
+ * @param tag The lexed tag
  *
  * @return bool true if the tag was successfully processed, false otherwise
  *              (e.g., if the tag is unknown or parameters are NULL)
  *
- * @note This function delegates the processing of specific tag types to specialized
- *       functions
- * @note For certain tags (e.g., description), this function collects content that
- *       continues across multiple lines
+ * @note File-level tags processed while the file-level block is current are
+ *       recorded, so that the header scan does not override them
  * @note The current_block in the state must be initialized before calling this function
  */
-bool state_process_tag(parser_state_t *state, const char *tag, const char *content) {
-    if (state == NULL || tag == NULL || content == NULL || state->current_block == NULL) {
+bool state_process_tag(parser_state_t *state, const tag_t *tag) {
+    if (state == NULL || tag == NULL || tag->content == NULL || state->current_block == NULL) {
         return false;
     }
-    debug_message(state->config, "Processing tag: @%s with content: %s\n", tag, content);
-    if (is_file_level_tag(tag)) {
-        return process_file_metadata_tag(state->current_block, tag, content);
-    }
-    if (strcmp(tag, "function") == 0) {
-        free(state->current_block->function_name);
-        char* parentheses = strstr(content, "()");
-        if (parentheses != NULL && parentheses[2] == '\0') {
-            char* cleaned_name = strndup(content, parentheses - content);
-            state->current_block->function_name = cleaned_name;
-        } else {
-            state->current_block->function_name = string_duplicate(content);
-        }
-        state->in_docblock = true;
-        return true;
-    }
-    if (strcmp(tag, "brief") == 0) {
-        if (state->current_block->function_name == NULL) {
-            free(state->current_block->brief);
-            state->current_block->brief = string_duplicate(content);
-        } else {
-            free(state->current_block->function_brief);
-            state->current_block->function_brief = string_duplicate(content);
-        }
-        return true;
-    }
-    if (strcmp(tag, "description") == 0) {
-        char *accumulated_content = state_collect_continued_content(state, content);
-        if (state->current_block->function_name == NULL) {
-            free(state->current_block->description);
-            state->current_block->description = accumulated_content;
-        } else {
-            free(state->current_block->function_description);
-            state->current_block->function_description = accumulated_content;
-        }
-        return true;
-    }
-    if (strcmp(tag, "arg") == 0 || strcmp(tag, "argument") == 0) {
-        return process_argument_tag(state->current_block, content);
-    }
-    if (strcmp(tag, "param") == 0) {
-        return process_parameter_tag(state->current_block, content);
-    }
-    if (strcmp(tag, "return") == 0) {
-        return process_return_tag(state->current_block, content);
-    }
-    if (strcmp(tag, "returns") == 0) {
-        return process_returns_tag(state->current_block, content);
-    }
-    if (strcmp(tag, "exitcode") == 0) {
-        return process_exitcode_tag(state->current_block, content);
-    }
-    if (strcmp(tag, "example") == 0) {
-        return process_example_using_state(state, content);
-    }
-    if (strcmp(tag, "stdout") == 0) {
-        char *accumulated_content = state_collect_continued_content(state, content);
-        free(state->current_block->stdout_doc);
-        state->current_block->stdout_doc = accumulated_content;
-        return true;
+    debug_message(state->config, "Processing tag: @%.*s with content: %s\n", (int)tag->name_length, tag->name, tag->content);
+    const tag_spec_t *spec = get_tag_spec(tag->id);
+    if (spec->handler == NULL) {
+        debug_message(state->config, "Unknown tag: @%.*s\n", (int)tag->name_length, tag->name);
+        return false;
     }
-    if (strcmp(tag, "stderr") == 0) {
-        free(state->current_block->stderr_doc);
-        state->current_block->stderr_doc = string_duplicate(content);
-        return true;
+    if (spec->file_level && state->current_block == state->file_block) {
+        state->file_tags_seen |= UINT64_C(1) << tag->id;
     }
-    if (strcmp(tag, "internal") == 0) {
-        state->current_block->is_internal = true;
-        return true;
+    if (!spec->continued) {
+        return spec->handler(state, tag->id, tag->content);
     }
-    if (strcmp(tag, "note") == 0 || strcmp(tag, "warning") == 0 || 
-        strcmp(tag, "error") == 0 || strcmp(tag, "tip") == 0 || 
-        strcmp(tag, "important") == 0 || strcmp(tag, "info") == 0 || 
-        strcmp(tag, "danger") == 0 || strcmp(tag, "hint") == 0 ||
-        strcmp(tag, "caution") == 0 || strcmp(tag, "alert") == 0) {
-        return process_alert_tag(state->current_block, tag, content);
+    char *accumulated_content = state_collect_continued_content(state, tag->content);
+    if (accumulated_content == NULL) {
+        return false;
     }
-    debug_message(state->config, "Unknown tag: @%s\n", tag);
-    return false;
+    bool result = spec->handler(state, tag->id, accumulated_content);
+    shell_free((void **)&accumulated_content);
+    
+    return result;
 }
 
 /**
@@ -273,7 +659,7 @@ bool process_example_using_state(parser_state_t *state, const char *content) {
         return false;
     }
     bool result = add_example_to_docblock(state->current_block, example_content);
-    free(example_content);
+    shell_free((void **)&example_content);
     
     return result;
 } 
@@ -10,6 +10,7 @@
  */
 
 #include "parsers/tag.h"
+#include "parsers/state.h"
 #include "utils/string.h"
 #include "utils/debug.h"
 #include <stdio.h>
@@ -20,6 +21,49 @@
 // Constants
 #define TAG_PREFIX "# @"
 
+/**
+ * @brief Names of the known tags, indexed by identifier
+ */
+static const char *const tag_names[TAG_ID_COUNT] = {
+    [TAG_UNKNOWN] = NULL,
+    [TAG_FILE] = "file",
+    [TAG_VERSION] = "version",
+    [TAG_AUTHOR] = "author",
+    [TAG_LICENSE] = "license",
+    [TAG_COPYRIGHT] = "copyright",
+    [TAG_SINCE] = "since",
+    [TAG_DESCRIPTION] = "description",
+    [TAG_PACKAGE] = "package",
+    [TAG_MODULE] = "module",
+    [TAG_LINK] = "link",
+    [TAG_REPO] = "repo",
+    [TAG_SEE] = "see",
+    [TAG_ENV] = "env",
+    [TAG_SKIP] = "skip",
+    [TAG_FUNCTION] = "function",
+    [TAG_BRIEF] = "brief",
+    [TAG_ARG] = "arg",
+    [TAG_ARGUMENT] = "argument",
+    [TAG_PARAM] = "param",
+    [TAG_RETURN] = "return",
+    [TAG_RETURNS] = "returns",
+    [TAG_EXITCODE] = "exitcode",
+    [TAG_EXAMPLE] = "example",
+    [TAG_STDOUT] = "stdout",
+    [TAG_STDERR] = "stderr",
+    [TAG_INTERNAL] = "internal",
+    [TAG_NOTE] = "note",
+    [TAG_WARNING] = "warning",
+    [TAG_ERROR] = "error",
+    [TAG_TIP] = "tip",
+    [TAG_IMPORTANT] = "important",
+    [TAG_INFO] = "info",
+    [TAG_DANGER] = "danger",
+    [TAG_HINT] = "hint",
+    [TAG_CAUTION] = "caution",
+    [TAG_ALERT] = "alert"
+};
+
 /**
  * @brief Check if a line is a tag line
  * 
@@ -40,129 +84,50 @@ static bool static_is_tag_line(const char *line) {
     return (strncmp(line, TAG_PREFIX, strlen(TAG_PREFIX)) == 0);
 }
 
-/**
- * @brief Extract the tag name from a line
- * 
- * Parses a line containing a documentation tag and extracts the tag name
- * (the text immediately following the # @ prefix, up to the first whitespace).
- * 
- * @param line The line containing the tag
- * 
- * @return char* Newly allocated string containing just the tag name,
- *               or NULL if the line does not contain a tag or if memory allocation fails.
- *               The caller is responsible for freeing this memory.
- */
-static char *static_extract_tag_name(const char *line) {
-    if (!static_is_tag_line(line)) {
-        return NULL;
-    }
-    const char *tag_start = line + strlen(TAG_PREFIX);
-    const char *tag_end = tag_start;
-    while (*tag_end && !isspace(*tag_end)) {
-        tag_end++;
-    }
-    size_t tag_length = tag_end - tag_start;
-    char *tag_name = malloc(tag_length + 1);
-    if (tag_name == NULL) {
-        return NULL;
-    }
-    strncpy(tag_name, tag_start, tag_length);
-    tag_name[tag_length] = '\0';
-    
-    return tag_name;
-}
-
-/**
- * @brief Extract the content associated with a tag
- * 
- * Parses a line containing a documentation tag and extracts the content
- * (everything after the tag name and any whitespace).
- * 
- * @param line The line containing the tag and its content
- * 
- * @return char* Newly allocated string containing just the tag content,
- *               or NULL if the line does not contain a tag or if memory allocation fails.
- *               The caller is responsible for freeing this memory.
- */
-static char *static_extract_tag_content(const char *line) {
-    if (!static_is_tag_line(line)) {
-        return NULL;
-    }
-    const char *content_start = line + strlen(TAG_PREFIX);
-    while (*content_start && !isspace(*content_start)) {
-        content_start++;
-    }
-    while (isspace(*content_start)) {
-        content_start++;
-    }
-
-    return string_duplicate(content_start);
-}
-
 /**
  * @brief Collect content from continued comment lines
  * 
- * Reads subsequent lines from a file and collects content from comment lines
- * that form a continued block of documentation. This is used to handle multi-line
- * documentation comments that are spread across several lines.
+ * Consumes the lines following the current one from the parser state and
+ * collects content from comment lines that form a continued block of
+ * documentation. This is used to handle multi-line documentation comments
+ * that are spread across several lines.
  * 
- * @param file File handle to read subsequent lines from
- * @param buffer Buffer to store each line during processing
- * @param buffer_size Size of the buffer
+ * @param state Parser state positioned on the first line of the comment
  * @param initial_content The content from the first line of the comment
  * 
  * @return char* Newly allocated string containing the concatenated content
  *               of all comment lines in the block, or NULL on error.
  *               The caller is responsible for freeing this memory.
  * 
- * @note This function will restore the file position if it encounters a line
- *       that is not part of the continued comment block.
+ * @note The line following the continued comment block is only peeked at,
+ *       so it is left unconsumed.
  * @note Lines are separated by newlines in the returned string.
  */
-char *collect_continued_comment_content(FILE *file, char *buffer, size_t buffer_size, const char *initial_content) {
-    if (file == NULL || buffer == NULL || buffer_size == 0 || initial_content == NULL) {
+char *collect_continued_comment_content(parser_state_t *state, const char *initial_content) {
+    if (state == NULL || initial_content == NULL) {
         return NULL;
     }
-    char *accumulated_content = string_duplicate(initial_content);
-    if (accumulated_content == NULL) {
+    string_builder_t builder;
+    string_builder_init(&builder, NULL);
+    if (!string_builder_append(&builder, initial_content)) {
         return NULL;
     }
-    long file_pos = ftell(file);
-    if (file_pos < 0) {
-        free(accumulated_content);
-        return NULL;
-    }
-    while (fgets(buffer, buffer_size, file) != NULL) {
-        size_t len = strlen(buffer);
-        if (len > 0 && buffer[len - 1] == '\n') {
-            buffer[len - 1] = '\0';
-            len--;
-        }
-        char *line = buffer;
-        while (isspace(*line)) {
-            line++;
-        }
-        if (strncmp(line, "#", 1) == 0 && strncmp(line, TAG_PREFIX, strlen(TAG_PREFIX)) != 0) {
-            line++;
-            while (isspace(*line)) {
-                line++;
-            }
-            char *new_content = NULL;
-            if (asprintf(&new_content, "%s\n%s", accumulated_content, line) != -1) {
-                free(accumulated_content);
-                accumulated_content = new_content;
-            }
-        } else {
-            fseek(file, file_pos, SEEK_SET);
+    line_span_t span;
+    const line_class_t *next;
+    while ((next = state_peek_class(state, &span)) != NULL) {
+        if (!line_kind_is_comment(next->kind) || next->kind == LINE_TAG) {
             break;
         }
-        file_pos = ftell(file);
-        if (file_pos < 0) {
-            break;
+        state_next_line(state);
+        const char *line = state->line + state->line_class.text;
+        if (!string_builder_append_length(&builder, "\n", 1)
+            || !string_builder_append_length(&builder, line, state->line_length - state->line_class.text)) {
+            string_builder_free(&builder);
+            return NULL;
         }
     }
     
-    return accumulated_content;
+    return string_builder_finish(&builder);
 }
 
 /**
@@ -214,9 +179,9 @@ bool process_tag(shellscribe_docblock_t *docblock, const char *tag, const char *
  * @brief Collect continued content from a file
  * 
  * This is a wrapper around collect_continued_comment_content that provides a
- * simpler interface with a predefined buffer.
+ * simpler interface.
  * 
- * @param file File handle to read subsequent lines from
+ * @param state Parser state positioned on the first line of the comment
  * @param initial_content The content from the first line of the comment
  * @param config Configuration settings for parsing
  * 
@@ -226,13 +191,12 @@ bool process_tag(shellscribe_docblock_t *docblock, const char *tag, const char *
  * 
  * @see collect_continued_comment_content
  */
-char *collect_continued_content(FILE *file, const char *initial_content, const shellscribe_config_t *config) {
-    if (file == NULL || initial_content == NULL || config == NULL) {
+char *collect_continued_content(parser_state_t *state, const char *initial_content, const shellscribe_config_t *config) {
+    if (state == NULL || initial_content == NULL || config == NULL) {
         return NULL;
     }
-    char buffer[1024];
     
-    return collect_continued_comment_content(file, buffer, sizeof(buffer), initial_content);
+    return collect_continued_comment_content(state, initial_content);
 }
 
 /**
@@ -252,75 +216,167 @@ bool is_tag_line(const char *line) {
 }
 
 /**
- * @brief Extract tag name from a line
+ * @brief Split a tag line into the name and the content of its tag
  * 
- * Parses a line containing a documentation tag and extracts the tag name.
- * This implementation is more robust than static_extract_tag_name and
- * handles different formats of tag lines.
+ * Classifies a line once and, when it holds a tag, returns where the tag name
+ * and the tag content lie in the line, so that callers can dispatch on the
+ * name and hand the content to a handler without copying either of them.
+ * The name runs from the character following the # @ prefix up to the first
+ * whitespace or colon; the content follows the name, an optional colon and
+ * any whitespace, up to the end of the line.
  * 
- * @param line The line containing the tag
+ * @param line The line to lex (NUL-terminated)
+ * @param length The length of the line
+ * @param tag Filled with views into the line
  * 
- * @return char* Newly allocated string containing just the tag name,
- *               or NULL if the line does not contain a tag or if memory allocation fails.
- *               The caller is responsible for freeing this memory.
+ * @return bool true if the line contains a tag, false otherwise or if a parameter is NULL
  * 
- * @note This function specifically looks for the @ symbol to identify tags
- * @note Tag names are extracted up to the first whitespace or colon
+ * @note Handlers receive the content as a NUL-terminated view into the line:
+ *       they must copy it when they store it
  */
-char *extract_tag_name(const char *line) {
-    if (line == NULL) {
-        return NULL;
+bool lex_tag_line(const char *line, size_t length, tag_t *tag) {
+    if (line == NULL || tag == NULL) {
+        return false;
     }
-    const char *tag_start = strstr(line, "@");
-    if (tag_start == NULL) {
-        return NULL;
+    const char *tag_start = line;
+    while (isspace((unsigned char)*tag_start)) {
+        tag_start++;
     }
-    tag_start++;
-    const char *tag_end = tag_start;
-    while (*tag_end && !isspace((unsigned char)*tag_end) && *tag_end != ':') {
-        tag_end++;
+    if (strncmp(tag_start, TAG_PREFIX, strlen(TAG_PREFIX)) != 0) {
+        return false;
     }
-    size_t tag_len = tag_end - tag_start;
-    char *tag_name = malloc(tag_len + 1);
-    if (tag_name == NULL) {
-        return NULL;
+    const char *name = tag_start + strlen(TAG_PREFIX);
+    const char *name_end = name;
+    while (*name_end && !isspace((unsigned char)*name_end) && *name_end != ':') {
+        name_end++;
     }
-    strncpy(tag_name, tag_start, tag_len);
-    tag_name[tag_len] = '\0';
+    const char *content = name_end;
+    if (*content == ':') {
+        content++;
+    }
+    while (isspace((unsigned char)*content)) {
+        content++;
+    }
+    tag->name = name;
+    tag->name_length = (size_t)(name_end - name);
+    tag->id = tag_lookup(tag->name, tag->name_length);
+    tag->content = content;
+    tag->content_length = (size_t)(line + length - content);
     
-    return tag_name;
+    return true;
 }
 
 /**
- * @brief Extract tag content from a line
+ * @brief Resolve a tag name to its identifier
  * 
- * Parses a line containing a documentation tag and extracts the content
- * (everything after the tag name and any whitespace).
+ * Known tags are told apart by their length and their first character, which
+ * together select a single candidate (only stdout and stderr need a second
+ * character); one comparison then confirms the match. Resolving a name thus
+ * costs the same whatever the number of known tags.
  * 
- * @param line The line containing the tag and its content
+ * @param name The tag name (without @ prefix), not necessarily NUL-terminated
+ * @param length The length of the tag name
  * 
- * @return char* Newly allocated string containing just the tag content,
- *               or NULL if the line does not contain a tag or if memory allocation fails.
+ * @return tag_id_t The identifier of the tag, TAG_UNKNOWN if it is not a known
+ *                  tag or if name is NULL
+ * 
+ * @note A tag added to tag_names must also be added to the switch below
  */
-char *extract_tag_content(const char *line) {
-    if (line == NULL) {
-        return NULL;
-    }
-    const char *tag_start = strstr(line, "@");
-    if (tag_start == NULL) {
-        return NULL;
+tag_id_t tag_lookup(const char *name, size_t length) {
+    if (name == NULL || length == 0) {
+        return TAG_UNKNOWN;
     }
-    const char *content_start = tag_start + 1;
-    while (*content_start && !isspace((unsigned char)*content_start) && *content_start != ':') {
-        content_start++;
+    tag_id_t id = TAG_UNKNOWN;
+    switch (length) {
+        case 3:
+            switch (name[0]) {
+                case 'a': id = TAG_ARG; break;
+                case 'e': id = TAG_ENV; break;
+                case 's': id = TAG_SEE; break;
+                case 't': id = TAG_TIP; break;
+            }
+            break;
+        case 4:
+            switch (name[0]) {
+                case 'f': id = TAG_FILE; break;
+                case 'h': id = TAG_HINT; break;
+                case 'i': id = TAG_INFO; break;
+                case 'l': id = TAG_LINK; break;
+                case 'n': id = TAG_NOTE; break;
+                case 'r': id = TAG_REPO; break;
+                case 's': id = TAG_SKIP; break;
+            }
+            break;
+        case 5:
+            switch (name[0]) {
+                case 'a': id = TAG_ALERT; break;
+                case 'b': id = TAG_BRIEF; break;
+                case 'e': id = TAG_ERROR; break;
+                case 'p': id = TAG_PARAM; break;
+                case 's': id = TAG_SINCE; break;
+            }
+            break;
+        case 6:
+            switch (name[0]) {
+                case 'a': id = TAG_AUTHOR; break;
+                case 'd': id = TAG_DANGER; break;
+                case 'm': id = TAG_MODULE; break;
+                case 'r': id = TAG_RETURN; break;
+                case 's': id = (name[3] == 'o') ? TAG_STDOUT : TAG_STDERR; break;
+            }
+            break;
+        case 7:
+            switch (name[0]) {
+                case 'c': id = TAG_CAUTION; break;
+                case 'e': id = TAG_EXAMPLE; break;
+                case 'l': id = TAG_LICENSE; break;
+                case 'p': id = TAG_PACKAGE; break;
+                case 'r': id = TAG_RETURNS; break;
+                case 'v': id = TAG_VERSION; break;
+                case 'w': id = TAG_WARNING; break;
+            }
+            break;
+        case 8:
+            switch (name[0]) {
+                case 'a': id = TAG_ARGUMENT; break;
+                case 'e': id = TAG_EXITCODE; break;
+                case 'f': id = TAG_FUNCTION; break;
+                case 'i': id = TAG_INTERNAL; break;
+            }
+            break;
+        case 9:
+            switch (name[0]) {
+                case 'c': id = TAG_COPYRIGHT; break;
+                case 'i': id = TAG_IMPORTANT; break;
+            }
+            break;
+        case 11:
+            if (name[0] == 'd') {
+                id = TAG_DESCRIPTION;
+            }
+            break;
     }
-    if (*content_start == ':') {
-        content_start++;
+    if (id != TAG_UNKNOWN && memcmp(name, tag_names[id], length) != 0) {
+        id = TAG_UNKNOWN;
     }
-    while (isspace((unsigned char)*content_start)) {
-        content_start++;
+    
+    return id;
+}
+
+/**
+ * @brief Get the name of a known tag
+ * 
+ * @param id The identifier of the tag
+ * 
+ * @return const char* The tag name (without @ prefix), NULL for TAG_UNKNOWN or
+ *                     an invalid identifier
+ */
+const char *tag_id_name(tag_id_t id) {
+    if ((unsigned int)id >= TAG_ID_COUNT) {
+        return NULL;
     }
-    return string_duplicate(content_start);
+    
+    return tag_names[id];
 }
 
 /**
@@ -42,6 +42,7 @@ bool is_set_tag(const char *tag) {
  * Parses the content of a set tag to extract the variable name, type, and description.
  * The expected format is "name type description" where type and description are optional.
  *
+ * @param arena The arena allocating the extracted strings
  * @param content The content of the set tag to parse
  * @param name Pointer to a string pointer that will store the extracted variable name
  * @param type Pointer to a string pointer that will store the extracted variable type
@@ -50,12 +51,11 @@ bool is_set_tag(const char *tag) {
  * @return bool true if parsing was successful and the variable information was extracted,
  *              false if an error occurred or if required parameters are NULL
  *
- * @note Memory is allocated for the name, type, and description, which must be freed
- *       by the caller when no longer needed
+ * @note Memory for the name, type, and description is allocated in the arena
  * @note If the content doesn't contain a type or description, empty strings are used
  * @note Leading whitespace in the content is skipped
  */
-bool parse_set_content(const char *content, char **name, char **type, char **description) {
+bool parse_set_content(arena_t *arena, const char *content, char **name, char **type, char **description) {
     if (content == NULL || name == NULL || type == NULL || description == NULL) {
         return false;
     }
@@ -72,42 +72,37 @@ bool parse_set_content(const char *content, char **name, char **type, char **des
     const char *name_start = content;
     const char *name_end = strchr(content, ' ');
     if (name_end == NULL) {
-        *name = string_duplicate(content);
-        *type = string_duplicate("");
-        *description = string_duplicate("");
+        *name = arena_strdup(arena, content);
+        *type = arena_strdup(arena, "");
+        *description = arena_strdup(arena, "");
         return true;
     }
     size_t name_len = name_end - name_start;
-    *name = malloc(name_len + 1);
+    *name = arena_strndup(arena, name_start, name_len);
     if (*name == NULL) {
         return false;
     }
-    strncpy(*name, name_start, name_len);
-    (*name)[name_len] = '\0';
     const char *type_start = name_end + 1;
     while (isspace(*type_start)) {
         type_start++;
     }
     const char *type_end = strchr(type_start, ' ');
     if (type_end == NULL) {
-        *type = string_duplicate(type_start);
-        *description = string_duplicate("");
+        *type = arena_strdup(arena, type_start);
+        *description = arena_strdup(arena, "");
         return true;
     }
     size_t type_len = type_end - type_start;
-    *type = malloc(type_len + 1);
+    *type = arena_strndup(arena, type_start, type_len);
     if (*type == NULL) {
-        free(*name);
         *name = NULL;
         return false;
     }
-    strncpy(*type, type_start, type_len);
-    (*type)[type_len] = '\0';
     const char *desc_start = type_end + 1;
     while (isspace(*desc_start)) {
         desc_start++;
     }
-    *description = string_duplicate(desc_start);
+    *description = arena_strdup(arena, desc_start);
     return true;
 }
 
@@ -125,8 +120,7 @@ bool parse_set_content(const char *content, char **name, char **type, char **des
  *              docblock, false if an error occurred or if required parameters are NULL
  *
  * @note This function uses parse_set_content to extract the variable components
- * @note Memory is allocated for the variable information, which will be freed
- *       when the docblock is freed
+ * @note Memory for the variable information is allocated in the arena of the docblock
  * @note Variables are stored in the set_vars array of the docblock structure
  * @note By default, variables are marked as not readonly, and no default value is set
  * 
@@ -139,23 +133,18 @@ bool process_set_tag(shellscribe_docblock_t *docblock, const char *content) {
     char *name = NULL;
     char *type = NULL;
     char *description = NULL;
-    if (!parse_set_content(content, &name, &type, &description)) {
+    if (!parse_set_content(docblock->arena, content, &name, &type, &description)) {
         return false;
     }
-    shellscribe_global_var_t *new_vars = realloc(docblock->set_vars, (docblock->set_var_count + 1) * sizeof(shellscribe_global_var_t));
-    if (new_vars == NULL) {
-        free(name);
-        free(type);
-        free(description);
+    shellscribe_global_var_t *variable = shellscribe_global_var_vector_push(&docblock->set_vars, docblock->arena);
+    if (variable == NULL) {
         return false;
     }
-    docblock->set_vars = new_vars;
-    docblock->set_vars[docblock->set_var_count].name = name;
-    docblock->set_vars[docblock->set_var_count].type = type;
-    docblock->set_vars[docblock->set_var_count].description = description;
-    docblock->set_vars[docblock->set_var_count].default_value = NULL;
-    docblock->set_vars[docblock->set_var_count].is_readonly = false;
-    docblock->set_var_count++;
+    variable->name = name;
+    variable->type = type;
+    variable->description = description;
+    variable->default_value = NULL;
+    variable->is_readonly = false;
     
     return true;
 } 
@@ -128,42 +128,42 @@ void render_arguments(const shellscribe_docblock_t *docblock, FILE *output, cons
     if (docblock == NULL || output == NULL || config == NULL) {
         return;
     }
-    if (docblock->arg_count > 0) {
+    if (docblock->arguments.count > 0) {
         fprintf(output, "#### Arguments\n\n");
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Argument | Type | Description |\n");
             fprintf(output, "|----------|------|-------------|\n");
-            for (int i = 0; i < docblock->arg_count; i++) {
+            for (int i = 0; i < docblock->arguments.count; i++) {
                 fprintf(output, "| %s | %s | %s |\n", 
-                        docblock->arguments[i].name ? docblock->arguments[i].name : "", 
-                        docblock->arguments[i].type ? docblock->arguments[i].type : "",
-                        docblock->arguments[i].description ? docblock->arguments[i].description : "");
+                        docblock->arguments.items[i].name ? docblock->arguments.items[i].name : "", 
+                        docblock->arguments.items[i].type ? docblock->arguments.items[i].type : "",
+                        docblock->arguments.items[i].description ? docblock->arguments.items[i].description : "");
             }
         } else {
-            for (int i = 0; i < docblock->arg_count; i++) {
+            for (int i = 0; i < docblock->arguments.count; i++) {
                 fprintf(output, "* %s (%s)\n  %s\n", 
-                        docblock->arguments[i].name ? docblock->arguments[i].name : "", 
-                        docblock->arguments[i].type ? docblock->arguments[i].type : "",
-                        docblock->arguments[i].description ? docblock->arguments[i].description : "");
+                        docblock->arguments.items[i].name ? docblock->arguments.items[i].name : "", 
+                        docblock->arguments.items[i].type ? docblock->arguments.items[i].type : "",
+                        docblock->arguments.items[i].description ? docblock->arguments.items[i].description : "");
             }
         }
         fprintf(output, "\n");
-    } else if (docblock->param_count > 0) {
+    } else if (docblock->params.count > 0) {
         fprintf(output, "#### Parameters\n\n");
         
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Parameter | Description |\n");
             fprintf(output, "|-----------|-------------|\n");
-            for (int i = 0; i < docblock->param_count; i++) {
+            for (int i = 0; i < docblock->params.count; i++) {
                 fprintf(output, "| `%s` | %s |\n", 
-                        docblock->params[i].name ? docblock->params[i].name : "", 
-                        docblock->params[i].description ? docblock->params[i].description : "");
+                        docblock->params.items[i].name ? docblock->params.items[i].name : "", 
+                        docblock->params.items[i].description ? docblock->params.items[i].description : "");
             }
         } else {
-            for (int i = 0; i < docblock->param_count; i++) {
+            for (int i = 0; i < docblock->params.count; i++) {
                 fprintf(output, "* `%s`: %s\n", 
-                        docblock->params[i].name ? docblock->params[i].name : "", 
-                        docblock->params[i].description ? docblock->params[i].description : "");
+                        docblock->params.items[i].name ? docblock->params.items[i].name : "", 
+                        docblock->params.items[i].description ? docblock->params.items[i].description : "");
             }
         }
         fprintf(output, "\n");
@@ -204,10 +204,10 @@ void render_docblock(const shellscribe_docblock_t *docblock,
     } else if (docblock->description != NULL) {
         fprintf(output, "%s\n\n", docblock->description);
     }
-    if (docblock->alert_count > 0 && config->show_alerts) {
-        for (int i = 0; i < docblock->alert_count; i++) {
-            const char *type = docblock->alerts[i].type ? docblock->alerts[i].type : "NOTE";
-            const char *content = docblock->alerts[i].content ? docblock->alerts[i].content : "";
+    if (docblock->alerts.count > 0 && config->show_alerts) {
+        for (int i = 0; i < docblock->alerts.count; i++) {
+            const char *type = docblock->alerts.items[i].type ? docblock->alerts.items[i].type : "NOTE";
+            const char *content = docblock->alerts.items[i].content ? docblock->alerts.items[i].content : "";
             char *type_upper = string_duplicate(type);
             if (type_upper) {
                 for (size_t j = 0; j < strlen(type_upper); j++) {
@@ -232,14 +232,14 @@ void render_docblock(const shellscribe_docblock_t *docblock,
     }
     render_arguments(docblock, output, config);
     render_dependencies(docblock, output, config);
-    if (docblock->return_count > 0 || docblock->return_desc != NULL) {
+    if (docblock->returns.count > 0 || docblock->return_desc != NULL) {
         fprintf(output, "#### Return Values\n\n");
         if (docblock->return_desc != NULL) {
             fprintf(output, "%s\n\n", docblock->return_desc);
         }
-        for (int i = 0; i < docblock->return_count; i++) {
+        for (int i = 0; i < docblock->returns.count; i++) {
             fprintf(output, "* %s\n", 
-                    docblock->returns[i].description ? docblock->returns[i].description : "");
+                    docblock->returns.items[i].description ? docblock->returns.items[i].description : "");
         }
         fprintf(output, "\n");
     }
@@ -247,23 +247,23 @@ void render_docblock(const shellscribe_docblock_t *docblock,
         fprintf(output, "#### Output on stdout\n");
         fprintf(output, "* %s\n\n", docblock->stdout_doc);
     }
-    if (docblock->shellcheck_count > 0) {
+    if (docblock->shellcheck_directives.count > 0) {
         fprintf(output, "#### Shellcheck Exceptions\n\n");
-        char **displayed_codes = (char **)calloc(docblock->shellcheck_count, sizeof(char *));
+        const char **displayed_codes = (const char **)calloc(docblock->shellcheck_directives.count, sizeof(const char *));
         int displayed_count = 0;
         bool has_any_reason = false;
-        for (int i = 0; i < docblock->shellcheck_count; i++) {
-            const char *code = docblock->shellcheck_directives[i].code ? docblock->shellcheck_directives[i].code : "";
-            const char *reason = docblock->shellcheck_directives[i].reason ? docblock->shellcheck_directives[i].reason : "";
+        for (int i = 0; i < docblock->shellcheck_directives.count; i++) {
+            const char *code = docblock->shellcheck_directives.items[i].code ? docblock->shellcheck_directives.items[i].code : "";
+            const char *reason = docblock->shellcheck_directives.items[i].reason ? docblock->shellcheck_directives.items[i].reason : "";
             bool duplicate = false;
             for (int j = 0; j < displayed_count; j++) {
-                if (displayed_codes[j] && strcmp(displayed_codes[j], code) == 0) {
+                if (displayed_codes[j] == code) {
                     duplicate = true;
                     break;
                 }
             }
             if (!duplicate && *code) {
-                displayed_codes[displayed_count++] = strdup(code);
+                displayed_codes[displayed_count++] = code;
                 if (reason && *reason) {
                     has_any_reason = true;
                 }
@@ -278,19 +278,19 @@ void render_docblock(const shellscribe_docblock_t *docblock,
                 fprintf(output, "| Code |\n");
                 fprintf(output, "|------|\n");
             }
-            for (int i = 0; i < docblock->shellcheck_count; i++) {
-                const char *code = docblock->shellcheck_directives[i].code ? docblock->shellcheck_directives[i].code : "";
-                const char *reason = docblock->shellcheck_directives[i].reason ? docblock->shellcheck_directives[i].reason : "";
+            for (int i = 0; i < docblock->shellcheck_directives.count; i++) {
+                const char *code = docblock->shellcheck_directives.items[i].code ? docblock->shellcheck_directives.items[i].code : "";
+                const char *reason = docblock->shellcheck_directives.items[i].reason ? docblock->shellcheck_directives.items[i].reason : "";
                 bool already_displayed = false;
                 for (int j = 0; j < i; j++) {
-                    const char *prev_code = docblock->shellcheck_directives[j].code ? docblock->shellcheck_directives[j].code : "";
-                    if (strcmp(prev_code, code) == 0) {
+                    const char *prev_code = docblock->shellcheck_directives.items[j].code ? docblock->shellcheck_directives.items[j].code : "";
+                    if (prev_code == code) {
                         already_displayed = true;
                         break;
                     }
                 }                
                 if (!already_displayed && *code) {
-                    if (strncmp(code, "SC", 2) == 0) {
+                    if (docblock->shellcheck_directives.items[i].code_number > 0) {
                         if (has_any_reason) {
                             fprintf(output, "| [%s](https://www.shellcheck.net/wiki/%s) | %s |\n", 
                                     code, code, reason);
@@ -308,19 +308,19 @@ void render_docblock(const shellscribe_docblock_t *docblock,
                 }
             }
         } else if (strcmp(display_mode, "sequential") == 0) {
-            for (int i = 0; i < docblock->shellcheck_count; i++) {
-                const char *code = docblock->shellcheck_directives[i].code ? docblock->shellcheck_directives[i].code : "";
-                const char *reason = docblock->shellcheck_directives[i].reason ? docblock->shellcheck_directives[i].reason : "";
+            for (int i = 0; i < docblock->shellcheck_directives.count; i++) {
+                const char *code = docblock->shellcheck_directives.items[i].code ? docblock->shellcheck_directives.items[i].code : "";
+                const char *reason = docblock->shellcheck_directives.items[i].reason ? docblock->shellcheck_directives.items[i].reason : "";
                 bool already_displayed = false;
                 for (int j = 0; j < i; j++) {
-                    const char *prev_code = docblock->shellcheck_directives[j].code ? docblock->shellcheck_directives[j].code : "";
-                    if (strcmp(prev_code, code) == 0) {
+                    const char *prev_code = docblock->shellcheck_directives.items[j].code ? docblock->shellcheck_directives.items[j].code : "";
+                    if (prev_code == code) {
                         already_displayed = true;
                         break;
                     }
                 }
                 if (!already_displayed && *code) {
-                    if (strncmp(code, "SC", 2) == 0) {
+                    if (docblock->shellcheck_directives.items[i].code_number > 0) {
                         fprintf(output, "[%s](https://www.shellcheck.net/wiki/%s)", code, code);
                     } else {
                         fprintf(output, "[%s]", code);
@@ -332,19 +332,19 @@ void render_docblock(const shellscribe_docblock_t *docblock,
                 }
             }
         } else {
-            for (int i = 0; i < docblock->shellcheck_count; i++) {
-                const char *code = docblock->shellcheck_directives[i].code ? docblock->shellcheck_directives[i].code : "";
-                const char *reason = docblock->shellcheck_directives[i].reason ? docblock->shellcheck_directives[i].reason : "";
+            for (int i = 0; i < docblock->shellcheck_directives.count; i++) {
+                const char *code = docblock->shellcheck_directives.items[i].code ? docblock->shellcheck_directives.items[i].code : "";
+                const char *reason = docblock->shellcheck_directives.items[i].reason ? docblock->shellcheck_directives.items[i].reason : "";
                 bool already_displayed = false; 
                 for (int j = 0; j < i; j++) {
-                    const char *prev_code = docblock->shellcheck_directives[j].code ? docblock->shellcheck_directives[j].code : "";
-                    if (strcmp(prev_code, code) == 0) {
+                    const char *prev_code = docblock->shellcheck_directives.items[j].code ? docblock->shellcheck_directives.items[j].code : "";
+                    if (prev_code == code) {
                         already_displayed = true;
                         break;
                     }
                 }                
                 if (!already_displayed && *code) {
-                    if (strncmp(code, "SC", 2) == 0) {
+                    if (docblock->shellcheck_directives.items[i].code_number > 0) {
                         fprintf(output, "* [%s](https://www.shellcheck.net/wiki/%s)", code, code);
                     } else {
                         fprintf(output, "* %s", code);
@@ -356,9 +356,6 @@ void render_docblock(const shellscribe_docblock_t *docblock,
                 }
             }
         }
-        for (int i = 0; i < displayed_count; i++) {
-            free(displayed_codes[i]);
-        }
         free(displayed_codes);
         fprintf(output, "\n");
     }
@@ -385,105 +382,105 @@ void render_dependencies(const shellscribe_docblock_t *docblock, FILE *output, c
     if (docblock == NULL || output == NULL || config == NULL) {
         return;
     }
-    if (docblock->requires_count == 0 && 
-        docblock->used_by_count == 0 && 
-        docblock->calls_count == 0 && 
-        docblock->provides_count == 0 &&
-        docblock->dependency_count == 0 && 
-        docblock->internal_call_count == 0) {
+    if (docblock->requires.count == 0 && 
+        docblock->used_by.count == 0 && 
+        docblock->calls.count == 0 && 
+        docblock->provides.count == 0 &&
+        docblock->dependencies.count == 0 && 
+        docblock->internal_calls.count == 0) {
         return;
     }
     
     fprintf(output, "#### Dependencies\n\n");
-    if (docblock->requires_count > 0) {
+    if (docblock->requires.count > 0) {
         fprintf(output, "##### Required Dependencies\n\n");
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Name |\n");
             fprintf(output, "|------|\n");
-            for (int i = 0; i < docblock->requires_count; i++) {
+            for (int i = 0; i < docblock->requires.count; i++) {
                 fprintf(output, "| `%s` |\n", 
-                        docblock->requires[i] ? docblock->requires[i] : "");
+                        docblock->requires.items[i] ? docblock->requires.items[i] : "");
             }
         } else {
-            for (int i = 0; i < docblock->requires_count; i++) {
+            for (int i = 0; i < docblock->requires.count; i++) {
                 fprintf(output, "* `%s`\n", 
-                        docblock->requires[i] ? docblock->requires[i] : "");
+                        docblock->requires.items[i] ? docblock->requires.items[i] : "");
             }
         }
         fprintf(output, "\n");
     }
-    if (docblock->used_by_count > 0) {
+    if (docblock->used_by.count > 0) {
         fprintf(output, "##### Used By\n\n");
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Function |\n");
             fprintf(output, "|---------|\n");
-            for (int i = 0; i < docblock->used_by_count; i++) {
+            for (int i = 0; i < docblock->used_by.count; i++) {
                 fprintf(output, "| `%s` |\n", 
-                        docblock->used_by[i] ? docblock->used_by[i] : "");
+                        docblock->used_by.items[i] ? docblock->used_by.items[i] : "");
             }
         } else {
-            for (int i = 0; i < docblock->used_by_count; i++) {
+            for (int i = 0; i < docblock->used_by.count; i++) {
                 fprintf(output, "* `%s`\n", 
-                        docblock->used_by[i] ? docblock->used_by[i] : "");
+                        docblock->used_by.items[i] ? docblock->used_by.items[i] : "");
             }
         }
         fprintf(output, "\n");
     }
-    if (docblock->calls_count > 0) {
+    if (docblock->calls.count > 0) {
         fprintf(output, "##### External Calls\n\n");
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Command/Function |\n");
             fprintf(output, "|----------------|\n");
-            for (int i = 0; i < docblock->calls_count; i++) {
+            for (int i = 0; i < docblock->calls.count; i++) {
                 fprintf(output, "| `%s` |\n", 
-                        docblock->calls[i] ? docblock->calls[i] : "");
+                        docblock->calls.items[i] ? docblock->calls.items[i] : "");
             }
         } else {
-            for (int i = 0; i < docblock->calls_count; i++) {
+            for (int i = 0; i < docblock->calls.count; i++) {
                 fprintf(output, "* `%s`\n", 
-                        docblock->calls[i] ? docblock->calls[i] : "");
+                        docblock->calls.items[i] ? docblock->calls.items[i] : "");
             }
         }
         fprintf(output, "\n");
     }
-    if (docblock->provides_count > 0) {
+    if (docblock->provides.count > 0) {
         fprintf(output, "##### Provides\n\n");
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Service/Feature |\n");
             fprintf(output, "|----------------|\n");
-            for (int i = 0; i < docblock->provides_count; i++) {
+            for (int i = 0; i < docblock->provides.count; i++) {
                 fprintf(output, "| %s |\n", 
-                        docblock->provides[i] ? docblock->provides[i] : "");
+                        docblock->provides.items[i] ? docblock->provides.items[i] : "");
             }
         } else {
-            for (int i = 0; i < docblock->provides_count; i++) {
+            for (int i = 0; i < docblock->provides.count; i++) {
                 fprintf(output, "* %s\n", 
-                        docblock->provides[i] ? docblock->provides[i] : "");
+                        docblock->provides.items[i] ? docblock->provides.items[i] : "");
             }
         }
         fprintf(output, "\n");
     }
-    if (docblock->dependency_count > 0 || docblock->internal_call_count > 0) {
+    if (docblock->dependencies.count > 0 || docblock->internal_calls.count > 0) {
         fprintf(output, "##### Other Dependencies\n\n");
         if (config->arguments_display && strcmp(config->arguments_display, "table") == 0) {
             fprintf(output, "| Name | Type |\n");
             fprintf(output, "|------|------|\n");
-            for (int i = 0; i < docblock->dependency_count; i++) {
+            for (int i = 0; i < docblock->dependencies.count; i++) {
                 fprintf(output, "| `%s` | Dependency |\n", 
-                        docblock->dependencies[i] ? docblock->dependencies[i] : "");
+                        docblock->dependencies.items[i] ? docblock->dependencies.items[i] : "");
             }
-            for (int i = 0; i < docblock->internal_call_count; i++) {
+            for (int i = 0; i < docblock->internal_calls.count; i++) {
                 fprintf(output, "| `%s` | Internal Call |\n", 
-                        docblock->internal_calls[i] ? docblock->internal_calls[i] : "");
+                        docblock->internal_calls.items[i] ? docblock->internal_calls.items[i] : "");
             }
         } else {
-            for (int i = 0; i < docblock->dependency_count; i++) {
+            for (int i = 0; i < docblock->dependencies.count; i++) {
                 fprintf(output, "* Dependency: `%s`\n", 
-                        docblock->dependencies[i] ? docblock->dependencies[i] : "");
+                        docblock->dependencies.items[i] ? docblock->dependencies.items[i] : "");
             }
-            for (int i = 0; i < docblock->internal_call_count; i++) {
+            for (int i = 0; i < docblock->internal_calls.count; i++) {
                 fprintf(output, "* Internal Call: `%s`\n", 
-                        docblock->internal_calls[i] ? docblock->internal_calls[i] : "");
+                        docblock->internal_calls.items[i] ? docblock->internal_calls.items[i] : "");
             }
         }
         fprintf(output, "\n");
@@ -47,10 +47,11 @@ void render_github_alert(const shellscribe_alert_t *alert, FILE *output, const s
     fprintf(output, "> [!%s]\n", valid_type);
     if (content != NULL) {
         char *message_copy = string_duplicate(content);
-        char *line = strtok(message_copy, "\n");
+        char *saveptr = NULL;
+        char *line = strtok_r(message_copy, "\n", &saveptr);
         while (line != NULL) {
             fprintf(output, "> %s\n", line);
-            line = strtok(NULL, "\n");
+            line = strtok_r(NULL, "\n", &saveptr);
         }
         free(message_copy);
     }
@@ -124,8 +125,8 @@ void render_alerts(const shellscribe_docblock_t *docblock, FILE *output, const s
     if (!config->show_alerts) {
         return;
     }
-    for (int i = 0; i < docblock->alert_count; i++) {
-        render_github_alert(&docblock->alerts[i], output, config);
+    for (int i = 0; i < docblock->alerts.count; i++) {
+        render_github_alert(&docblock->alerts.items[i], output, config);
     }
 }
 
@@ -73,7 +73,7 @@ bool render_markdown(const shellscribe_docblock_t *docblocks, int count, FILE *o
         if (has_about_section) {
             fprintf(output, "## About\n\n");
             if (file_metadata->interpreter != NULL) {
-                fprintf(output, "**Interpreter:** %s\n", file_metadata->interpreter);
+                fprintf(output, "**Interpreter:** %s\n\n", file_metadata->interpreter);
             }
             if (file_metadata->project != NULL) {
                 fprintf(output, "**Project:** %s\n\n", file_metadata->project);
@@ -0,0 +1,255 @@
+/**
+ * @file arena.c
+ * @brief Implementation of the arena allocator
+ *
+ * Allocations are carved out of the current chunk by moving an offset. When
+ * the chunk is full, a new one is allocated and chained in front of the
+ * previous ones; allocations larger than the chunk size get a chunk of their
+ * own. Resetting the arena frees every chunk but the first one, which is
+ * reused, so that an arena serving one file after another settles on a single
+ * allocation per file in the common case.
+ */
+
+#include "utils/arena.h"
+#include "utils/memory.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Default size of the chunks of an arena
+ */
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief Alignment of the allocations of an arena
+ */
+#define ARENA_ALIGNMENT 16
+
+/**
+ * @brief A chunk of memory of an arena
+ */
+typedef struct arena_chunk {
+    struct arena_chunk *next;   // Previously allocated chunk
+    size_t size;                // Usable size of the chunk
+    size_t used;                // Number of bytes already allocated
+    _Alignas(ARENA_ALIGNMENT) unsigned char data[]; // Memory of the chunk
+} arena_chunk_t;
+
+/**
+ * @brief An arena
+ */
+struct arena {
+    arena_chunk_t *head;        // Chunk serving allocations (NULL before the first one)
+    size_t chunk_size;          // Size of the chunks
+    void *last;                 // Last allocation, which can be resized in place
+};
+
+/**
+ * @brief Round a size up to the alignment of allocations
+ *
+ * @param size The size
+ * @return size_t The rounded size
+ */
+static size_t align_size(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Create an empty arena
+ *
+ * No memory is allocated for chunks until the first allocation.
+ *
+ * @param chunk_size Size of the chunks allocated by the arena (0 for the default size)
+ * @return arena_t* The new arena, NULL on allocation failure
+ */
+arena_t *arena_create(size_t chunk_size) {
+    arena_t *arena = (arena_t *)shell_calloc(1, sizeof(arena_t));
+    if (arena == NULL) {
+        return NULL;
+    }
+    arena->chunk_size = (chunk_size > 0) ? align_size(chunk_size) : ARENA_DEFAULT_CHUNK_SIZE;
+    return arena;
+}
+
+/**
+ * @brief Allocate memory from an arena
+ *
+ * @param arena The arena
+ * @param size Size of the allocation in bytes
+ * @return void* Pointer to the allocated memory, NULL on failure
+ */
+void *arena_alloc(arena_t *arena, size_t size) {
+    if (arena == NULL || size > SIZE_MAX - ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    size = align_size((size > 0) ? size : 1);
+    arena_chunk_t *chunk = arena->head;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        size_t chunk_size = (size > arena->chunk_size) ? size : arena->chunk_size;
+        chunk = (arena_chunk_t *)shell_malloc(sizeof(arena_chunk_t) + chunk_size);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+/**
+ * @brief Allocate zero-initialized memory from an arena
+ *
+ * @param arena The arena
+ * @param count Number of elements
+ * @param size Size of each element in bytes
+ * @return void* Pointer to the allocated memory, NULL on failure
+ */
+void *arena_calloc(arena_t *arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = arena_alloc(arena, count * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+/**
+ * @brief Resize an allocation of an arena
+ *
+ * Growing the last allocation only moves the offset of its chunk when the
+ * chunk has room, which makes appending to an array one element at a time
+ * cheap. Other allocations are copied to a new one.
+ *
+ * @param arena The arena
+ * @param ptr The allocation to resize (NULL to allocate)
+ * @param old_size Current size of the allocation in bytes
+ * @param new_size New size of the allocation in bytes
+ * @return void* Pointer to the resized allocation, NULL on failure
+ */
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size) {
+    if (ptr == NULL) {
+        return arena_alloc(arena, new_size);
+    }
+    if (arena == NULL || new_size > SIZE_MAX - ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    arena_chunk_t *chunk = arena->head;
+    if (ptr == arena->last) {
+        size_t offset = (size_t)((unsigned char *)ptr - chunk->data);
+        size_t size = align_size((new_size > 0) ? new_size : 1);
+        if (size <= chunk->size - offset) {
+            chunk->used = offset + size;
+            return ptr;
+        }
+    } else if (new_size <= old_size) {
+        return ptr;
+    }
+    void *new_ptr = arena_alloc(arena, new_size);
+    if (new_ptr != NULL) {
+        memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+    }
+    return new_ptr;
+}
+
+/**
+ * @brief Duplicate the beginning of a string in an arena
+ *
+ * @param arena The arena
+ * @param str The string to duplicate
+ * @param length Maximum number of characters to copy
+ * @return char* The NUL-terminated copy, NULL if str is NULL or on failure
+ */
+char *arena_strndup(arena_t *arena, const char *str, size_t length) {
+    if (str == NULL) {
+        return NULL;
+    }
+    length = strnlen(str, length);
+    char *copy = (char *)arena_alloc(arena, length + 1);
+    if (copy != NULL) {
+        memcpy(copy, str, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+/**
+ * @brief Duplicate a string in an arena
+ *
+ * @param arena The arena
+ * @param str The string to duplicate
+ * @return char* The copy, NULL if str is NULL or on failure
+ */
+char *arena_strdup(arena_t *arena, const char *str) {
+    if (str == NULL) {
+        return NULL;
+    }
+    return arena_strndup(arena, str, strlen(str));
+}
+
+/**
+ * @brief Concatenate two strings in an arena
+ *
+ * @param arena The arena
+ * @param str1 The first string
+ * @param str2 The second string
+ * @return char* The concatenation, NULL if a string is NULL or on failure
+ */
+char *arena_concat(arena_t *arena, const char *str1, const char *str2) {
+    if (str1 == NULL || str2 == NULL) {
+        return NULL;
+    }
+    size_t length1 = strlen(str1);
+    size_t length2 = strlen(str2);
+    char *result = (char *)arena_alloc(arena, length1 + length2 + 1);
+    if (result != NULL) {
+        memcpy(result, str1, length1);
+        memcpy(result + length1, str2, length2 + 1);
+    }
+    return result;
+}
+
+/**
+ * @brief Release all the allocations of an arena
+ *
+ * @param arena The arena (can be NULL)
+ */
+void arena_reset(arena_t *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    arena_chunk_t *chunk = arena->head;
+    while (chunk != NULL && chunk->next != NULL) {
+        arena_chunk_t *next = chunk->next;
+        shell_free((void **)&chunk);
+        chunk = next;
+    }
+    if (chunk != NULL && chunk->size != arena->chunk_size) {
+        shell_free((void **)&chunk);
+    }
+    if (chunk != NULL) {
+        chunk->used = 0;
+    }
+    arena->head = chunk;
+    arena->last = NULL;
+}
+
+/**
+ * @brief Free an arena and all its allocations
+ *
+ * @param arena The arena (can be NULL)
+ */
+void arena_destroy(arena_t *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    arena_reset(arena);
+    shell_free((void **)&arena->head);
+    shell_free((void **)&arena);
+}
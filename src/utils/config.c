@@ -288,7 +288,10 @@ bool load_config(shellscribe_config_t *config, const char *config_file) {
         .show_shellcheck = false,
         .arguments_display = shell_strdup("sequential"),
         .shellcheck_display = shell_strdup("sequential"),
-        .traverse_symlinks = true
+        .traverse_symlinks = true,
+        .parallel_walk = false,
+        .sort_files = false,
+        .jobs = 0
     };
     char footer_buffer[256];
     snprintf(footer_buffer, sizeof(footer_buffer), 
@@ -423,6 +426,23 @@ static void set_traverse_symlinks(shellscribe_config_t *cfg, const char *val) {
     cfg->traverse_symlinks = (strcmp(val, "true") == 0);
 }
 
+static void set_parallel_walk(shellscribe_config_t *cfg, const char *val) {
+    cfg->parallel_walk = (strcmp(val, "true") == 0);
+}
+
+static void set_sort_files(shellscribe_config_t *cfg, const char *val) {
+    cfg->sort_files = (strcmp(val, "true") == 0);
+}
+
+static void set_jobs(shellscribe_config_t *cfg, const char *val) {
+    long jobs = strtol(val, NULL, 10);
+    if (jobs > MAX_JOBS) {
+        fprintf(stderr, "Warning: Invalid number of jobs: %s (expected 1-%d), using %d\n", val, MAX_JOBS, MAX_JOBS);
+        jobs = MAX_JOBS;
+    }
+    cfg->jobs = (jobs > 0) ? (int)jobs : 0;
+}
+
 static void set_shellcheck_display(shellscribe_config_t *cfg, const char *val) {
     free(cfg->shellcheck_display);
     cfg->shellcheck_display = string_duplicate(val);
@@ -486,6 +506,9 @@ bool load_scribeconf(shellscribe_config_t *config) {
             {"arguments_display", set_arguments_display},
             {"shellcheck_display", set_shellcheck_display},
             {"traverse_symlinks", set_traverse_symlinks},
+            {"parallel_walk", set_parallel_walk},
+            {"sort_files", set_sort_files},
+            {"jobs", set_jobs},
         };
         bool handled = false;
         for (size_t i = 0; i < sizeof(config_map) / sizeof(config_map[0]); i++) {
@@ -531,4 +554,6 @@ static void set_defaults(shellscribe_config_t *config) {
     config->arguments_display          = string_duplicate("table");
     config->shellcheck_display         = string_duplicate("table");
     config->traverse_symlinks          = false;
+    config->parallel_walk              = false;
+    config->sort_files                 = false;
 }
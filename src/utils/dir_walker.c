@@ -0,0 +1,629 @@
+/**
+ * @file dir_walker.c
+ * @brief Implementation of the directory tree walkers
+ *
+ * Both walkers read directories through open file descriptors and rely on the
+ * entry type reported by readdir(), so that regular files and directories
+ * cost no extra syscall; fstatat() is only needed for entries of unknown type
+ * and for followed symbolic links. Names are matched before anything else,
+ * and paths are only built for the entries that are kept.
+ *
+ * The parallel walker gives each thread its own deque of directories to read.
+ * A directory stays open until all its subdirectories have been read, so that
+ * they are opened relative to it with openat(), like in the sequential walk.
+ * A thread pushes the subdirectories it finds onto its own deque and pops
+ * them back in LIFO order, while idle threads steal the oldest directories
+ * from the other deques. Matching files are passed to the thread that started
+ * the walk through a bounded queue, so that they can be processed while the
+ * walk continues.
+ */
+
+#include "utils/dir_walker.h"
+#include "utils/memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+/**
+ * @brief Number of matching files buffered between the walker threads and the visitor
+ */
+#define WALK_OUTPUT_CAPACITY 1024
+
+/**
+ * @brief Outcome of the classification of a directory entry
+ */
+typedef enum {
+    WALK_ENTRY_SKIP,                // Entry is ignored
+    WALK_ENTRY_FILE,                // Entry is a matching file
+    WALK_ENTRY_DIRECTORY,           // Entry is a directory to walk
+    WALK_ENTRY_LINKED_DIRECTORY     // Entry is a symbolic link to a directory to walk
+} walk_entry_t;
+
+/**
+ * @brief A directory being walked sequentially, linked to the directory it was reached from
+ */
+typedef struct walk_frame {
+    int dir_fd;                     // File descriptor of the directory
+    bool has_stat;                  // Whether file_stat has been filled
+    struct stat file_stat;          // Status of the directory (filled on demand)
+    struct walk_frame *parent;      // Parent directory, NULL for the root
+} walk_frame_t;
+
+/**
+ * @brief A directory being walked in parallel, shared by the walks of its subdirectories
+ */
+typedef struct walk_node {
+    DIR *dir;                       // The open directory, whose descriptor its subdirectories are opened from
+    dev_t dev;                      // Device of the directory
+    ino_t ino;                      // Inode of the directory
+    bool has_stat;                  // Whether dev and ino are known
+    struct walk_node *parent;       // Parent directory, NULL for the root
+    int refcount;                   // Number of references (the walk of the directory and of each subdirectory)
+} walk_node_t;
+
+/**
+ * @brief A directory waiting to be read by the parallel walker
+ */
+typedef struct {
+    char *path;                     // Path of the directory
+    size_t name_offset;             // Offset of the name of the directory in its path (0 for the root)
+    walk_node_t *parent;            // Directory it was found in (a reference is held), NULL for the root
+} walk_task_t;
+
+/**
+ * @brief Double-ended queue of directories owned by one walker thread
+ */
+typedef struct {
+    pthread_mutex_t lock;           // Protects the deque
+    walk_task_t **items;            // Ring buffer of directories
+    size_t head;                    // Index of the oldest directory
+    size_t count;                   // Number of directories
+    size_t capacity;                // Number of slots in the ring buffer
+} walk_deque_t;
+
+/**
+ * @brief State shared by the threads of a parallel walk
+ */
+typedef struct {
+    const dir_walker_options_t *options;    // Walk options
+    walk_deque_t *deques;                   // One deque per thread
+    int thread_count;                       // Number of walker threads
+    pthread_mutex_t idle_lock;              // Protects pending and generation
+    pthread_cond_t idle_cond;               // Signaled when work is pushed or the walk completes
+    size_t pending;                         // Number of directories pushed but not read yet
+    unsigned long generation;               // Incremented every time pending changes
+    pthread_mutex_t output_lock;            // Protects the output queue
+    pthread_cond_t output_ready;            // Signaled when a file is queued or a thread exits
+    pthread_cond_t output_space;            // Signaled when a file is dequeued
+    char **output;                          // Ring buffer of matching files
+    size_t output_head;                     // Index of the oldest matching file
+    size_t output_count;                    // Number of queued matching files
+    int running;                            // Number of walker threads still running
+} parallel_walk_t;
+
+/**
+ * @brief Arguments of a walker thread
+ */
+typedef struct {
+    parallel_walk_t *walk;          // Shared walk state
+    int index;                      // Index of the thread's own deque
+} walk_thread_t;
+
+/**
+ * @brief Classify a directory entry
+ *
+ * @param dir_fd The directory containing the entry
+ * @param entry The entry
+ * @param options The walk options
+ * @param target_stat Filled with the status of the directory a followed link points to
+ * @return walk_entry_t What to do with the entry
+ */
+static walk_entry_t classify_entry(int dir_fd, const struct dirent *entry, const dir_walker_options_t *options, struct stat *target_stat) {
+    const char *name = entry->d_name;
+    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+        return WALK_ENTRY_SKIP;
+    }
+    bool is_match = options->match(name);
+    unsigned char type = entry->d_type;
+    if (type == DT_UNKNOWN) {
+        struct stat file_stat;
+        if (fstatat(dir_fd, name, &file_stat, AT_SYMLINK_NOFOLLOW) != 0) {
+            return WALK_ENTRY_SKIP;
+        }
+        type = S_ISDIR(file_stat.st_mode) ? DT_DIR : S_ISREG(file_stat.st_mode) ? DT_REG : S_ISLNK(file_stat.st_mode) ? DT_LNK : DT_UNKNOWN;
+    }
+    switch (type) {
+        case DT_REG:
+            return is_match ? WALK_ENTRY_FILE : WALK_ENTRY_SKIP;
+        case DT_DIR:
+            return WALK_ENTRY_DIRECTORY;
+        case DT_LNK:
+            if (!options->traverse_symlinks || fstatat(dir_fd, name, target_stat, 0) != 0) {
+                return WALK_ENTRY_SKIP;
+            }
+            if (S_ISDIR(target_stat->st_mode)) {
+                return WALK_ENTRY_LINKED_DIRECTORY;
+            }
+            return (S_ISREG(target_stat->st_mode) && is_match) ? WALK_ENTRY_FILE : WALK_ENTRY_SKIP;
+        default:
+            return WALK_ENTRY_SKIP;
+    }
+}
+
+/**
+ * @brief Check whether a directory reached through a symbolic link is already being walked
+ *
+ * Status of the directories being walked is only queried here, so that walks
+ * without symbolic links to directories need no fstat() at all.
+ *
+ * @param frame The directory containing the symbolic link
+ * @param target_stat Status of the directory the link points to
+ * @return bool True if following the link would loop
+ */
+static bool is_frame_loop(walk_frame_t *frame, const struct stat *target_stat) {
+    for (walk_frame_t *current = frame; current != NULL; current = current->parent) {
+        if (!current->has_stat) {
+            if (fstat(current->dir_fd, &current->file_stat) != 0) {
+                continue;
+            }
+            current->has_stat = true;
+        }
+        if (current->file_stat.st_dev == target_stat->st_dev && current->file_stat.st_ino == target_stat->st_ino) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Walk an open directory sequentially
+ *
+ * @param dir The open directory to walk (closed by this function)
+ * @param parent The directory dir was reached from, NULL for the root
+ * @param path Buffer holding the path of the directory, extended in place for its entries
+ * @param path_len The length of the path of the directory
+ * @param options The walk options
+ * @return int The number of files visited
+ */
+static int walk_directory(DIR *dir, walk_frame_t *parent, char *path, size_t path_len, const dir_walker_options_t *options) {
+    int count = 0;
+    int dir_fd = dirfd(dir);
+    walk_frame_t frame = { .dir_fd = dir_fd, .has_stat = false, .parent = parent };
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        struct stat target_stat;
+        walk_entry_t kind = classify_entry(dir_fd, entry, options, &target_stat);
+        if (kind == WALK_ENTRY_SKIP || (kind == WALK_ENTRY_LINKED_DIRECTORY && is_frame_loop(&frame, &target_stat))) {
+            continue;
+        }
+        size_t name_len = strlen(entry->d_name);
+        if (path_len + 1 + name_len >= PATH_MAX) {
+            continue;
+        }
+        path[path_len] = '/';
+        memcpy(path + path_len + 1, entry->d_name, name_len + 1);
+        if (kind == WALK_ENTRY_FILE) {
+            options->visit(path, options->user_data);
+            count++;
+        } else {
+            int sub_fd = openat(dir_fd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            DIR *sub_dir = (sub_fd >= 0) ? fdopendir(sub_fd) : NULL;
+            if (sub_dir != NULL) {
+                count += walk_directory(sub_dir, &frame, path, path_len + 1 + name_len, options);
+            } else if (sub_fd >= 0) {
+                close(sub_fd);
+            }
+        }
+        path[path_len] = '\0';
+    }
+
+    closedir(dir);
+    return count;
+}
+
+/**
+ * @brief Walk a directory tree on the calling thread
+ *
+ * Files are visited as soon as they are found, in directory order.
+ * Symbolic links leading back to a directory being walked are not followed.
+ *
+ * @param root The root of the directory tree
+ * @param options The walk options
+ * @return int The number of files visited
+ */
+int dir_walker_walk(const char *root, const dir_walker_options_t *options) {
+    if (root == NULL || options == NULL || options->match == NULL || options->visit == NULL) {
+        return 0;
+    }
+    size_t path_len = strlen(root);
+    if (path_len >= PATH_MAX) {
+        return 0;
+    }
+    DIR *dir = opendir(root);
+    if (dir == NULL) {
+        return 0;
+    }
+    char path[PATH_MAX];
+    memcpy(path, root, path_len + 1);
+
+    return walk_directory(dir, NULL, path, path_len, options);
+}
+
+/**
+ * @brief Release a reference on a parallel walk node
+ *
+ * Nodes are freed, and their directory closed, once neither their directory
+ * nor any of its subdirectories are being walked, releasing in turn their
+ * reference on their parent.
+ *
+ * @param node The node (can be NULL)
+ */
+static void release_node(walk_node_t *node) {
+    while (node != NULL && __atomic_sub_fetch(&node->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        walk_node_t *parent = node->parent;
+        closedir(node->dir);
+        shell_free((void **)&node);
+        node = parent;
+    }
+}
+
+/**
+ * @brief Check whether a directory reached through a symbolic link is already being walked
+ *
+ * @param node The directory containing the symbolic link
+ * @param target_stat Status of the directory the link points to
+ * @return bool True if following the link would loop
+ */
+static bool is_node_loop(const walk_node_t *node, const struct stat *target_stat) {
+    for (; node != NULL; node = node->parent) {
+        if (node->has_stat && node->dev == target_stat->st_dev && node->ino == target_stat->st_ino) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Push a directory at the bottom of a deque
+ *
+ * @param deque The deque
+ * @param task The directory
+ * @return bool True on success, false on allocation failure
+ */
+static bool deque_push(walk_deque_t *deque, walk_task_t *task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        size_t new_capacity = (deque->capacity == 0) ? 64 : deque->capacity * 2;
+        walk_task_t **items = (walk_task_t **)shell_malloc(new_capacity * sizeof(walk_task_t *));
+        if (items == NULL) {
+            pthread_mutex_unlock(&deque->lock);
+            return false;
+        }
+        for (size_t i = 0; i < deque->count; i++) {
+            items[i] = deque->items[(deque->head + i) % deque->capacity];
+        }
+        shell_free((void **)&deque->items);
+        deque->items = items;
+        deque->head = 0;
+        deque->capacity = new_capacity;
+    }
+    deque->items[(deque->head + deque->count) % deque->capacity] = task;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+    return true;
+}
+
+/**
+ * @brief Pop a directory from a deque
+ *
+ * @param deque The deque
+ * @param steal True to take the oldest directory (from another thread's
+ *              deque), false to take the newest one (from the thread's own deque)
+ * @return walk_task_t* The directory, NULL if the deque is empty
+ */
+static walk_task_t *deque_pop(walk_deque_t *deque, bool steal) {
+    walk_task_t *task = NULL;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        if (steal) {
+            task = deque->items[deque->head];
+            deque->head = (deque->head + 1) % deque->capacity;
+        } else {
+            task = deque->items[(deque->head + deque->count - 1) % deque->capacity];
+        }
+        deque->count--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return task;
+}
+
+/**
+ * @brief Queue a directory for the parallel walk
+ *
+ * @param walk The walk state
+ * @param index The index of the deque to push the directory to
+ * @param path The path of the directory
+ * @param name_offset The offset of the name of the directory in its path (0 for the root)
+ * @param parent The directory it was found in (a new reference is taken)
+ */
+static void schedule_directory(parallel_walk_t *walk, int index, const char *path, size_t name_offset, walk_node_t *parent) {
+    walk_task_t *task = (walk_task_t *)shell_malloc(sizeof(walk_task_t));
+    if (task == NULL) {
+        return;
+    }
+    task->path = shell_strdup(path);
+    task->name_offset = name_offset;
+    task->parent = parent;
+    if (task->path == NULL) {
+        shell_free((void **)&task);
+        return;
+    }
+    if (parent != NULL) {
+        __atomic_add_fetch(&parent->refcount, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_lock(&walk->idle_lock);
+    walk->pending++;
+    pthread_mutex_unlock(&walk->idle_lock);
+    if (!deque_push(&walk->deques[index], task)) {
+        release_node(task->parent);
+        shell_free((void **)&task->path);
+        shell_free((void **)&task);
+        pthread_mutex_lock(&walk->idle_lock);
+        walk->pending--;
+        walk->generation++;
+        pthread_cond_broadcast(&walk->idle_cond);
+        pthread_mutex_unlock(&walk->idle_lock);
+        return;
+    }
+    pthread_mutex_lock(&walk->idle_lock);
+    walk->generation++;
+    pthread_cond_broadcast(&walk->idle_cond);
+    pthread_mutex_unlock(&walk->idle_lock);
+}
+
+/**
+ * @brief Pass a matching file to the visiting thread
+ *
+ * Blocks while the output queue is full.
+ *
+ * @param walk The walk state
+ * @param path The path of the file
+ */
+static void output_file(parallel_walk_t *walk, const char *path) {
+    char *copy = shell_strdup(path);
+    if (copy == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&walk->output_lock);
+    while (walk->output_count == WALK_OUTPUT_CAPACITY) {
+        pthread_cond_wait(&walk->output_space, &walk->output_lock);
+    }
+    walk->output[(walk->output_head + walk->output_count) % WALK_OUTPUT_CAPACITY] = copy;
+    walk->output_count++;
+    pthread_cond_signal(&walk->output_ready);
+    pthread_mutex_unlock(&walk->output_lock);
+}
+
+/**
+ * @brief Read one directory of the parallel walk
+ *
+ * Matching files are passed to the visiting thread and subdirectories are
+ * pushed onto the deque of the calling walker thread. The directory is opened
+ * relative to the directory it was found in, which stays open as long as
+ * some of its subdirectories remain to be read.
+ *
+ * @param walk The walk state
+ * @param index The index of the calling walker thread
+ * @param task The directory to read (freed by this function)
+ */
+static void walk_task(parallel_walk_t *walk, int index, walk_task_t *task) {
+    int dir_fd = (task->parent != NULL)
+        ? openat(dirfd(task->parent->dir), task->path + task->name_offset, O_RDONLY | O_DIRECTORY | O_CLOEXEC)
+        : open(task->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR *dir = (dir_fd >= 0) ? fdopendir(dir_fd) : NULL;
+    walk_node_t *node = (dir != NULL) ? (walk_node_t *)shell_calloc(1, sizeof(walk_node_t)) : NULL;
+    if (node == NULL) {
+        if (dir != NULL) {
+            closedir(dir);
+        } else if (dir_fd >= 0) {
+            close(dir_fd);
+        }
+        release_node(task->parent);
+        shell_free((void **)&task->path);
+        shell_free((void **)&task);
+        return;
+    }
+    node->dir = dir;
+    node->parent = task->parent;
+    node->refcount = 1;
+    struct stat dir_stat;
+    if (walk->options->traverse_symlinks && fstat(dir_fd, &dir_stat) == 0) {
+        node->dev = dir_stat.st_dev;
+        node->ino = dir_stat.st_ino;
+        node->has_stat = true;
+    }
+    char path[PATH_MAX];
+    size_t path_len = strlen(task->path);
+    memcpy(path, task->path, path_len + 1);
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        struct stat target_stat;
+        walk_entry_t kind = classify_entry(dir_fd, entry, walk->options, &target_stat);
+        if (kind == WALK_ENTRY_SKIP || (kind == WALK_ENTRY_LINKED_DIRECTORY && is_node_loop(node, &target_stat))) {
+            continue;
+        }
+        size_t name_len = strlen(entry->d_name);
+        if (path_len + 1 + name_len >= PATH_MAX) {
+            continue;
+        }
+        path[path_len] = '/';
+        memcpy(path + path_len + 1, entry->d_name, name_len + 1);
+        if (kind == WALK_ENTRY_FILE) {
+            output_file(walk, path);
+        } else {
+            schedule_directory(walk, index, path, path_len + 1, node);
+        }
+        path[path_len] = '\0';
+    }
+    release_node(node);
+    shell_free((void **)&task->path);
+    shell_free((void **)&task);
+}
+
+/**
+ * @brief Walker thread main loop
+ *
+ * Reads directories from the thread's own deque, steals from the other
+ * deques when it is empty, and sleeps when there is nothing to steal until
+ * more directories are pushed or the walk completes.
+ *
+ * @param arg Pointer to the walk_thread_t of the thread
+ * @return void* Always NULL
+ */
+static void *walker_thread(void *arg) {
+    walk_thread_t *thread = (walk_thread_t *)arg;
+    parallel_walk_t *walk = thread->walk;
+    for (;;) {
+        pthread_mutex_lock(&walk->idle_lock);
+        unsigned long generation = walk->generation;
+        bool done = (walk->pending == 0);
+        pthread_mutex_unlock(&walk->idle_lock);
+        if (done) {
+            break;
+        }
+        walk_task_t *task = deque_pop(&walk->deques[thread->index], false);
+        for (int i = 1; task == NULL && i < walk->thread_count; i++) {
+            task = deque_pop(&walk->deques[(thread->index + i) % walk->thread_count], true);
+        }
+        if (task != NULL) {
+            walk_task(walk, thread->index, task);
+            pthread_mutex_lock(&walk->idle_lock);
+            walk->pending--;
+            walk->generation++;
+            pthread_cond_broadcast(&walk->idle_cond);
+            pthread_mutex_unlock(&walk->idle_lock);
+            continue;
+        }
+        pthread_mutex_lock(&walk->idle_lock);
+        while (walk->generation == generation && walk->pending > 0) {
+            pthread_cond_wait(&walk->idle_cond, &walk->idle_lock);
+        }
+        pthread_mutex_unlock(&walk->idle_lock);
+    }
+    pthread_mutex_lock(&walk->output_lock);
+    walk->running--;
+    pthread_cond_broadcast(&walk->output_ready);
+    pthread_mutex_unlock(&walk->output_lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Walk a directory tree on several threads
+ *
+ * Files are visited on the calling thread as soon as a walker thread finds
+ * them; their order depends on scheduling. Falls back to the sequential walk
+ * if the walker threads cannot be started.
+ *
+ * @param root The root of the directory tree
+ * @param threads The number of walker threads (1 or less walks sequentially)
+ * @param options The walk options
+ * @return int The number of files visited
+ */
+int dir_walker_walk_parallel(const char *root, int threads, const dir_walker_options_t *options) {
+    if (threads <= 1 || root == NULL || options == NULL || options->match == NULL || options->visit == NULL) {
+        return dir_walker_walk(root, options);
+    }
+    parallel_walk_t walk = {
+        .options = options,
+        .thread_count = threads
+    };
+    walk.deques = (walk_deque_t *)shell_calloc((size_t)threads, sizeof(walk_deque_t));
+    walk.output = (char **)shell_calloc(WALK_OUTPUT_CAPACITY, sizeof(char *));
+    pthread_t *thread_ids = (pthread_t *)shell_calloc((size_t)threads, sizeof(pthread_t));
+    walk_thread_t *thread_args = (walk_thread_t *)shell_calloc((size_t)threads, sizeof(walk_thread_t));
+    if (walk.deques == NULL || walk.output == NULL || thread_ids == NULL || thread_args == NULL) {
+        shell_free((void **)&walk.deques);
+        shell_free((void **)&walk.output);
+        shell_free((void **)&thread_ids);
+        shell_free((void **)&thread_args);
+        return dir_walker_walk(root, options);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&walk.deques[i].lock, NULL);
+    }
+    pthread_mutex_init(&walk.idle_lock, NULL);
+    pthread_cond_init(&walk.idle_cond, NULL);
+    pthread_mutex_init(&walk.output_lock, NULL);
+    pthread_cond_init(&walk.output_ready, NULL);
+    pthread_cond_init(&walk.output_space, NULL);
+    schedule_directory(&walk, 0, root, 0, NULL);
+    int started = 0;
+    pthread_mutex_lock(&walk.output_lock);
+    for (; started < threads; started++) {
+        thread_args[started].walk = &walk;
+        thread_args[started].index = started;
+        if (pthread_create(&thread_ids[started], NULL, walker_thread, &thread_args[started]) != 0) {
+            break;
+        }
+        walk.running++;
+    }
+    pthread_mutex_unlock(&walk.output_lock);
+    int count = 0;
+    if (started == 0) {
+        walk_task_t *task = deque_pop(&walk.deques[0], false);
+        if (task != NULL) {
+            shell_free((void **)&task->path);
+            shell_free((void **)&task);
+        }
+        count = dir_walker_walk(root, options);
+    } else {
+        pthread_mutex_lock(&walk.output_lock);
+        for (;;) {
+            while (walk.output_count == 0 && walk.running > 0) {
+                pthread_cond_wait(&walk.output_ready, &walk.output_lock);
+            }
+            if (walk.output_count == 0) {
+                break;
+            }
+            char *path = walk.output[walk.output_head];
+            walk.output_head = (walk.output_head + 1) % WALK_OUTPUT_CAPACITY;
+            walk.output_count--;
+            pthread_cond_signal(&walk.output_space);
+            pthread_mutex_unlock(&walk.output_lock);
+            options->visit(path, options->user_data);
+            shell_free((void **)&path);
+            count++;
+            pthread_mutex_lock(&walk.output_lock);
+        }
+        pthread_mutex_unlock(&walk.output_lock);
+        for (int i = 0; i < started; i++) {
+            pthread_join(thread_ids[i], NULL);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        shell_free((void **)&walk.deques[i].items);
+        pthread_mutex_destroy(&walk.deques[i].lock);
+    }
+    pthread_cond_destroy(&walk.output_space);
+    pthread_cond_destroy(&walk.output_ready);
+    pthread_mutex_destroy(&walk.output_lock);
+    pthread_cond_destroy(&walk.idle_cond);
+    pthread_mutex_destroy(&walk.idle_lock);
+    shell_free((void **)&walk.deques);
+    shell_free((void **)&walk.output);
+    shell_free((void **)&thread_ids);
+    shell_free((void **)&thread_args);
+
+    return count;
+}
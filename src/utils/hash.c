@@ -0,0 +1,39 @@
+/**
+ * @file hash.c
+ * @brief Implementation of the FNV-1a hash
+ */
+
+#include "utils/hash.h"
+
+/**
+ * @brief FNV-1a 64-bit prime
+ */
+#define HASH_FNV1A_PRIME 0x100000001b3ULL
+
+/**
+ * @brief Continue an FNV-1a hash over a block of memory
+ *
+ * @param hash The current hash value (HASH_FNV1A_OFFSET_BASIS to start a hash)
+ * @param data The data to hash
+ * @param length The length of the data
+ * @return uint64_t The updated hash value
+ */
+uint64_t hash_fnv1a_update(uint64_t hash, const void *data, size_t length) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= HASH_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compute the FNV-1a hash of a block of memory
+ *
+ * @param data The data to hash
+ * @param length The length of the data
+ * @return uint64_t The hash value
+ */
+uint64_t hash_fnv1a(const void *data, size_t length) {
+    return hash_fnv1a_update(HASH_FNV1A_OFFSET_BASIS, data, length);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file intern.c
+ * @brief Implementation of the thread-safe string interning
+ *
+ * The strings of a run are stored in a string set, which already keeps a single
+ * copy of each string it is given and hands out that copy, even when several
+ * threads add the same string at once.
+ */
+
+#include "utils/intern.h"
+#include "utils/string_set.h"
+#include <string.h>
+#include <pthread.h>
+
+/**
+ * @brief Strings of the run, created on first use
+ */
+static string_set_t *run_table = NULL;
+
+/**
+ * @brief Guard of the creation of the table of the run
+ */
+static pthread_once_t run_table_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Create the table of the run
+ */
+static void create_run_table(void) {
+    run_table = string_set_create();
+}
+
+/**
+ * @brief Intern the beginning of a string in the table of the run
+ *
+ * @param str The string (can be NULL)
+ * @param length The length of the string
+ * @return const char* The canonical copy of the string, NULL if str is NULL or on failure
+ */
+const char *intern_string_length(const char *str, size_t length) {
+    if (str == NULL) {
+        return NULL;
+    }
+    pthread_once(&run_table_once, create_run_table);
+    return string_set_intern(run_table, str, length);
+}
+
+/**
+ * @brief Intern a string in the table of the run
+ *
+ * @param str The string (can be NULL)
+ * @return const char* The canonical copy of the string, NULL if str is NULL or on failure
+ */
+const char *intern_string(const char *str) {
+    if (str == NULL) {
+        return NULL;
+    }
+    return intern_string_length(str, strlen(str));
+}
+
+/**
+ * @brief Free the table of the run
+ *
+ * @note Every string interned with intern_string is released: this must only
+ *       be called once the run is over
+ */
+void intern_cleanup(void) {
+    string_set_free(run_table);
+    run_table = NULL;
+}
@@ -0,0 +1,484 @@
+/**
+ * @file line_scanner.c
+ * @brief Implementation of the zero-copy line scanner
+ *
+ * The buffer is split once when the scanner is initialized: newlines are
+ * replaced by NUL characters and the span of every line is recorded, in an
+ * array grown as lines are found so that the buffer is read only once. Returning
+ * a line, looking ahead, or going back to a previous one then only moves an
+ * index. As with fgets(), a final newline does not start an extra empty line.
+ *
+ * The buffer is split 64 bytes at a time. A kernel turns each block into
+ * bitmasks of its newlines, non-blank characters, '#' and '(' characters, and
+ * the lines are then cut by walking the set bits of the masks, so that the
+ * bytes between two interesting characters are never looked at one by one.
+ * The kernel is chosen at run time: AVX2 or SSE2 on x86 processors that
+ * support them, and a portable byte loop elsewhere.
+ */
+
+#include "utils/line_scanner.h"
+#include "utils/memory.h"
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LINE_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Number of bytes turned into bitmasks at once
+ */
+#define SPLIT_BLOCK_SIZE 64
+
+/**
+ * @brief Initial number of line spans allocated for a buffer
+ */
+#define SPLIT_INITIAL_LINES 64
+
+/**
+ * @brief Bitmasks of a block of the buffer (bit i stands for byte i)
+ */
+typedef struct {
+    uint64_t newlines;          // Newline characters
+    uint64_t nonblank;          // Characters other than whitespace
+    uint64_t hashes;            // '#' characters
+    uint64_t parens;            // '(' characters
+} block_masks_t;
+
+/**
+ * @brief Progress of the split of a buffer into lines
+ */
+typedef struct {
+    char *data;                 // Buffer being split
+    line_span_t *lines;         // Lines found so far
+    size_t line_count;          // Number of lines found so far
+    size_t line_capacity;       // Allocated number of line spans
+    bool failed;                // Whether growing the line spans failed
+    size_t start;               // Offset of the current line in the buffer
+    size_t indent;              // Offset of its first non-blank character (SIZE_MAX until found)
+    unsigned int flags;         // LINE_SPAN_* flags of the current line so far
+} line_split_t;
+
+/**
+ * @brief Kernel splitting the whole blocks of a buffer
+ *
+ * @param split The split, positioned at the start of the buffer
+ * @param length The length of the buffer
+ * @return size_t The number of bytes processed (a multiple of SPLIT_BLOCK_SIZE)
+ */
+typedef size_t (*split_kernel_t)(line_split_t *split, size_t length);
+
+/**
+ * @brief Kernel selected for the running processor
+ */
+static split_kernel_t split_kernel;
+static pthread_once_t split_kernel_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Get the index of the lowest set bit of a mask
+ *
+ * @param mask The mask (not 0)
+ * @return unsigned int The index of the bit
+ */
+static unsigned int lowest_bit(uint64_t mask) {
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctzll(mask);
+#else
+    unsigned int bit = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Double the number of line spans of a split
+ *
+ * @param split The split
+ * @return bool True on success, false on allocation failure
+ */
+static bool grow_lines(line_split_t *split) {
+    size_t new_capacity = (split->line_capacity > 0) ? split->line_capacity * 2 : SPLIT_INITIAL_LINES;
+    line_span_t *lines = (line_span_t *)shell_realloc(split->lines, new_capacity * sizeof(line_span_t));
+    if (lines == NULL) {
+        return false;
+    }
+    split->lines = lines;
+    split->line_capacity = new_capacity;
+    return true;
+}
+
+/**
+ * @brief End the current line of a split
+ *
+ * @param split The split
+ * @param offset The offset of the newline ending the line (or of the end of the buffer)
+ *
+ * @note Once growing the line spans has failed, lines are still terminated
+ *       but no longer recorded
+ */
+static void end_line(line_split_t *split, size_t offset) {
+    split->data[offset] = '\0';
+    if (split->line_count == split->line_capacity && (split->failed || !grow_lines(split))) {
+        split->failed = true;
+    } else {
+        line_span_t *line = &split->lines[split->line_count++];
+        line->start = split->data + split->start;
+        line->length = offset - split->start;
+        line->indent = (split->indent != SIZE_MAX) ? split->indent : line->length;
+        line->flags = split->flags;
+    }
+    split->start = offset + 1;
+    split->indent = SIZE_MAX;
+    split->flags = 0;
+}
+
+/**
+ * @brief Cut the lines of a block from its bitmasks
+ *
+ * Each iteration deals with the part of the current line lying before the
+ * next newline of the block, then ends the line at that newline.
+ *
+ * @param split The split
+ * @param offset The offset of the block in the buffer
+ * @param masks The bitmasks of the block (bits past the end of the buffer must be clear)
+ */
+static void split_block(line_split_t *split, size_t offset, block_masks_t masks) {
+    for (;;) {
+        uint64_t newline = masks.newlines & (~masks.newlines + 1);
+        uint64_t before = (newline != 0) ? newline - 1 : ~UINT64_C(0);
+        uint64_t nonblank = masks.nonblank & before;
+        if (split->indent == SIZE_MAX && nonblank != 0) {
+            unsigned int bit = lowest_bit(nonblank);
+            split->indent = offset + bit - split->start;
+            if ((masks.hashes >> bit) & 1) {
+                split->flags |= LINE_SPAN_COMMENT;
+            }
+        }
+        if ((masks.parens & before) != 0) {
+            split->flags |= LINE_SPAN_PAREN;
+        }
+        if (newline == 0) {
+            return;
+        }
+        end_line(split, offset + lowest_bit(newline));
+        uint64_t after = ~(before | newline);
+        masks.newlines &= after;
+        masks.nonblank &= after;
+        masks.hashes &= after;
+        masks.parens &= after;
+    }
+}
+
+/**
+ * @brief Compute the bitmasks of a block one byte at a time
+ *
+ * @param block The block
+ * @param size The size of the block (at most SPLIT_BLOCK_SIZE)
+ * @return block_masks_t The bitmasks of the block
+ */
+static block_masks_t scalar_masks(const char *block, size_t size) {
+    block_masks_t masks = {0, 0, 0, 0};
+    for (size_t i = 0; i < size; i++) {
+        unsigned char c = (unsigned char)block[i];
+        uint64_t bit = UINT64_C(1) << i;
+        if (c == '\n') {
+            masks.newlines |= bit;
+        } else if (c != ' ' && (unsigned int)(c - '\t') > '\r' - '\t') {
+            masks.nonblank |= bit;
+            if (c == '#') {
+                masks.hashes |= bit;
+            } else if (c == '(') {
+                masks.parens |= bit;
+            }
+        }
+    }
+    return masks;
+}
+
+/**
+ * @brief Split the whole blocks of a buffer without vector instructions
+ *
+ * @param split The split, positioned at the start of the buffer
+ * @param length The length of the buffer
+ * @return size_t The number of bytes processed
+ */
+static size_t split_blocks_scalar(line_split_t *split, size_t length) {
+    size_t offset = 0;
+    for (; length - offset >= SPLIT_BLOCK_SIZE; offset += SPLIT_BLOCK_SIZE) {
+        split_block(split, offset, scalar_masks(split->data + offset, SPLIT_BLOCK_SIZE));
+    }
+    return offset;
+}
+
+#ifdef LINE_SCANNER_X86
+/**
+ * @brief Split the whole blocks of a buffer with SSE2 instructions
+ *
+ * Blank characters are spaces and the control characters from '\t' to '\r':
+ * the latter are found by subtracting '\t' and keeping the bytes that an
+ * unsigned minimum with 4 leaves unchanged.
+ *
+ * @param split The split, positioned at the start of the buffer
+ * @param length The length of the buffer
+ * @return size_t The number of bytes processed
+ */
+__attribute__((target("sse2")))
+static size_t split_blocks_sse2(line_split_t *split, size_t length) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i controls = _mm_set1_epi8('\r' - '\t');
+    const __m128i hash = _mm_set1_epi8('#');
+    const __m128i paren = _mm_set1_epi8('(');
+    size_t offset = 0;
+    for (; length - offset >= SPLIT_BLOCK_SIZE; offset += SPLIT_BLOCK_SIZE) {
+        block_masks_t masks = {0, 0, 0, 0};
+        for (unsigned int i = 0; i < SPLIT_BLOCK_SIZE; i += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(split->data + offset + i));
+            __m128i shifted = _mm_sub_epi8(bytes, tab);
+            __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(bytes, space),
+                _mm_cmpeq_epi8(_mm_min_epu8(shifted, controls), shifted));
+            masks.newlines |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)) << i;
+            masks.nonblank |= (uint64_t)(uint16_t)~_mm_movemask_epi8(blank) << i;
+            masks.hashes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, hash)) << i;
+            masks.parens |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, paren)) << i;
+        }
+        split_block(split, offset, masks);
+    }
+    return offset;
+}
+
+/**
+ * @brief Split the whole blocks of a buffer with AVX2 instructions
+ *
+ * @param split The split, positioned at the start of the buffer
+ * @param length The length of the buffer
+ * @return size_t The number of bytes processed
+ * @see split_blocks_sse2
+ */
+__attribute__((target("avx2")))
+static size_t split_blocks_avx2(line_split_t *split, size_t length) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i controls = _mm256_set1_epi8('\r' - '\t');
+    const __m256i hash = _mm256_set1_epi8('#');
+    const __m256i paren = _mm256_set1_epi8('(');
+    size_t offset = 0;
+    for (; length - offset >= SPLIT_BLOCK_SIZE; offset += SPLIT_BLOCK_SIZE) {
+        block_masks_t masks = {0, 0, 0, 0};
+        for (unsigned int i = 0; i < SPLIT_BLOCK_SIZE; i += 32) {
+            __m256i bytes = _mm256_loadu_si256((const __m256i *)(split->data + offset + i));
+            __m256i shifted = _mm256_sub_epi8(bytes, tab);
+            __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, space),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, controls), shifted));
+            masks.newlines |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)) << i;
+            masks.nonblank |= (uint64_t)(uint32_t)~_mm256_movemask_epi8(blank) << i;
+            masks.hashes |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, hash)) << i;
+            masks.parens |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, paren)) << i;
+        }
+        split_block(split, offset, masks);
+    }
+    return offset;
+}
+#endif
+
+/**
+ * @brief Select the kernel matching the running processor
+ */
+static void select_split_kernel(void) {
+    split_kernel = split_blocks_scalar;
+#ifdef LINE_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        split_kernel = split_blocks_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        split_kernel = split_blocks_sse2;
+    }
+#endif
+}
+
+/**
+ * @brief Initialize a scanner over a buffer
+ *
+ * @param scanner The scanner to initialize
+ * @param data The buffer, split into lines in place; data[length] must be writable
+ * @param length The length of the buffer
+ * @return bool True on success, false on allocation failure
+ */
+bool line_scanner_init(line_scanner_t *scanner, char *data, size_t length) {
+    if (scanner == NULL || data == NULL) {
+        return false;
+    }
+    memset(scanner, 0, sizeof(*scanner));
+    data[length] = '\0';
+    pthread_once(&split_kernel_once, select_split_kernel);
+    line_split_t split = {
+        .data = data,
+        .lines = NULL,
+        .line_count = 0,
+        .line_capacity = 0,
+        .failed = false,
+        .start = 0,
+        .indent = SIZE_MAX,
+        .flags = 0
+    };
+    size_t offset = split_kernel(&split, length);
+    split_block(&split, offset, scalar_masks(data + offset, length - offset));
+    if (split.start < length) {
+        end_line(&split, length);
+    }
+    if (split.failed) {
+        shell_free((void **)&split.lines);
+        return false;
+    }
+    scanner->data = data;
+    scanner->length = length;
+    scanner->lines = split.lines;
+    scanner->line_count = split.line_count;
+
+    return true;
+}
+
+/**
+ * @brief Initialize a scanner over the contents of a file
+ *
+ * The file is read with a single read() loop into a buffer owned by the
+ * scanner (rather than mapped, since lines are terminated in place and the
+ * last one may need a NUL character past the end of the file).
+ *
+ * @param scanner The scanner to initialize
+ * @param file_path The file to read
+ * @return bool True on success, false if the file cannot be read or on allocation failure
+ */
+bool line_scanner_load(line_scanner_t *scanner, const char *file_path) {
+    if (scanner == NULL || file_path == NULL) {
+        return false;
+    }
+    int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    size_t capacity = (size_t)st.st_size;
+    char *data = (char *)shell_malloc(capacity + 1);
+    if (data == NULL) {
+        close(fd);
+        return false;
+    }
+    size_t length = 0;
+    while (length < capacity) {
+        ssize_t bytes_read = read(fd, data + length, capacity - length);
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            shell_free((void **)&data);
+            return false;
+        }
+        if (bytes_read == 0) {
+            break;
+        }
+        length += (size_t)bytes_read;
+    }
+    close(fd);
+    if (!line_scanner_init(scanner, data, length)) {
+        shell_free((void **)&data);
+        return false;
+    }
+    scanner->owns_data = true;
+
+    return true;
+}
+
+/**
+ * @brief Get the next line
+ *
+ * @param scanner The scanner
+ * @param line Filled with the next line
+ * @return bool True if a line was returned, false at the end of the buffer
+ */
+bool line_scanner_next(line_scanner_t *scanner, line_span_t *line) {
+    if (scanner->position >= scanner->line_count) {
+        return false;
+    }
+    *line = scanner->lines[scanner->position++];
+    return true;
+}
+
+/**
+ * @brief Look at a line ahead without consuming it
+ *
+ * @param scanner The scanner
+ * @param ahead The number of lines to look past (0 for the next line)
+ * @param line Filled with the line
+ * @return bool True if the line exists, false past the end of the buffer
+ */
+bool line_scanner_peek(const line_scanner_t *scanner, size_t ahead, line_span_t *line) {
+    if (ahead >= scanner->line_count - scanner->position) {
+        return false;
+    }
+    *line = scanner->lines[scanner->position + ahead];
+    return true;
+}
+
+/**
+ * @brief Consume lines without returning them
+ *
+ * @param scanner The scanner
+ * @param count The number of lines to consume
+ */
+void line_scanner_skip(line_scanner_t *scanner, size_t count) {
+    size_t remaining = scanner->line_count - scanner->position;
+    scanner->position += (count < remaining) ? count : remaining;
+}
+
+/**
+ * @brief Get the position of the scanner
+ *
+ * @param scanner The scanner
+ * @return size_t The index of the next line to return
+ */
+size_t line_scanner_tell(const line_scanner_t *scanner) {
+    return scanner->position;
+}
+
+/**
+ * @brief Move the scanner to a position returned by line_scanner_tell()
+ *
+ * @param scanner The scanner
+ * @param position The index of the next line to return
+ */
+void line_scanner_seek(line_scanner_t *scanner, size_t position) {
+    scanner->position = (position < scanner->line_count) ? position : scanner->line_count;
+}
+
+/**
+ * @brief Release the resources of a scanner
+ *
+ * @param scanner The scanner
+ */
+void line_scanner_free(line_scanner_t *scanner) {
+    if (scanner == NULL) {
+        return;
+    }
+    shell_free((void **)&scanner->lines);
+    if (scanner->owns_data) {
+        shell_free((void **)&scanner->data);
+    }
+    memset(scanner, 0, sizeof(*scanner));
+}
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
 
 /**
  * @brief Number of stack frames to capture for each allocation
@@ -72,6 +73,11 @@ static allocation_info_t tracked_allocations[MAX_TRACKED_ALLOCATIONS];
 static void *freed_pointers[MAX_CLEANUP_POINTERS];
 static int freed_count = 0;
 
+/**
+ * @brief Lock protecting the tracking tables when files are processed in parallel
+ */
+static pthread_mutex_t tracking_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /**
  * @brief Register a new allocation in the tracking system
  * 
@@ -87,6 +93,7 @@ static void register_allocation(void *ptr, size_t size) {
     if (!memory_tracking_enabled || ptr == NULL) {
         return;
     }
+    pthread_mutex_lock(&tracking_lock);
     for (int i = 0; i < MAX_TRACKED_ALLOCATIONS; i++) {
         if (tracked_allocations[i].ptr == NULL) {
             tracked_allocations[i].ptr = ptr;
@@ -99,11 +106,11 @@ static void register_allocation(void *ptr, size_t size) {
             if (total_allocated_size > peak_memory_usage) {
                 peak_memory_usage = total_allocated_size;
             }
-            
+            pthread_mutex_unlock(&tracking_lock);
             return;
         }
     }
-    
+    pthread_mutex_unlock(&tracking_lock);
     fprintf(stderr, "Warning: Maximum number of tracked allocations exceeded\n");
 }
 
@@ -137,6 +144,7 @@ static void unregister_allocation(void *ptr) {
     if (!memory_tracking_enabled || ptr == NULL) {
         return;
     }
+    pthread_mutex_lock(&tracking_lock);
     for (int i = 0; i < MAX_TRACKED_ALLOCATIONS; i++) {
         if (tracked_allocations[i].ptr == ptr) {
             total_allocated_size -= tracked_allocations[i].size;
@@ -146,11 +154,11 @@ static void unregister_allocation(void *ptr) {
             tracked_allocations[i].file = NULL;
             tracked_allocations[i].line = 0;
             tracked_allocations[i].backtrace_size = 0;
-            
+            pthread_mutex_unlock(&tracking_lock);
             return;
         }
     }
-    
+    pthread_mutex_unlock(&tracking_lock);
     fprintf(stderr, "Warning: attempt to free untracked pointer %p\n", ptr);
 }
 
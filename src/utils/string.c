@@ -10,6 +10,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <regex.h>
+#include <pthread.h>
 
 /**
  * @brief Duplicates a string
@@ -147,26 +148,80 @@ int string_starts_with(const char *str, const char *prefix) {
 }
 
 /**
- * @brief Checks if a string matches a regular expression
+ * @brief Maximum number of expressions kept compiled by the regex cache
+ */
+#define REGEX_CACHE_SIZE 32
+
+/**
+ * @brief Maximum number of groups captured by an extraction
+ */
+#define REGEX_MAX_GROUPS 30
+
+/**
+ * @brief A compiled regular expression
+ */
+struct string_regex {
+    regex_t regex;              // Compiled expression
+    char *pattern;              // Source pattern
+    int flags;                  // Compilation flags
+};
+
+/**
+ * @brief Expressions compiled by string_matches_regex and string_extract_regex
+ *
+ * The cache only grows: once it is full, patterns missing from it are
+ * compiled for a single use, so that an expression is never freed while
+ * another thread matches it.
+ */
+static string_regex_t *regex_cache[REGEX_CACHE_SIZE];
+static int regex_cache_count = 0;
+static pthread_rwlock_t regex_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/**
+ * @brief Compiles a regular expression once for repeated matching
  * 
- * @param str The string to check
- * @param pattern The regular expression pattern
- * @return int 1 if the string matches, 0 if it doesn't match, -1 on error
+ * @param pattern The regular expression
+ * @param flags The compilation flags of regcomp (e.g., REG_EXTENDED)
+ * @return string_regex_t* The compiled expression, or NULL on error
  */
-int string_matches_regex(const char *str, const char *pattern) {
-    if (str == NULL || pattern == NULL) {
-        return -1;
+string_regex_t *string_regex_compile(const char *pattern, int flags) {
+    if (pattern == NULL) {
+        return NULL;
     }
-    regex_t regex;
-    int ret = regcomp(&regex, pattern, REG_EXTENDED);
+    string_regex_t *regex = (string_regex_t *)shell_malloc(sizeof(string_regex_t));
+    if (regex == NULL) {
+        return NULL;
+    }
+    int ret = regcomp(&regex->regex, pattern, flags);
     if (ret != 0) {
         char error_buffer[100];
-        regerror(ret, &regex, error_buffer, sizeof(error_buffer));
+        regerror(ret, &regex->regex, error_buffer, sizeof(error_buffer));
         fprintf(stderr, "Regex compilation error: %s\n", error_buffer);
+        shell_free((void **)&regex);
+        return NULL;
+    }
+    regex->pattern = shell_strdup(pattern);
+    if (regex->pattern == NULL) {
+        regfree(&regex->regex);
+        shell_free((void **)&regex);
+        return NULL;
+    }
+    regex->flags = flags;
+    return regex;
+}
+
+/**
+ * @brief Checks if a string matches a compiled regular expression
+ * 
+ * @param regex The compiled expression
+ * @param str The string to check
+ * @return int 1 if the string matches, 0 if it doesn't match, -1 on error
+ */
+int string_regex_match(const string_regex_t *regex, const char *str) {
+    if (regex == NULL || str == NULL) {
         return -1;
     }
-    ret = regexec(&regex, str, 0, NULL, 0);
-    regfree(&regex);
+    int ret = regexec(&regex->regex, str, 0, NULL, 0);
     if (ret == 0) {
         return 1;  // Match
     } else if (ret == REG_NOMATCH) {
@@ -177,31 +232,21 @@ int string_matches_regex(const char *str, const char *pattern) {
 }
 
 /**
- * @brief Extracts substrings matching a regular expression pattern
+ * @brief Extracts substrings matching a compiled regular expression
  * 
+ * @param regex The compiled expression
  * @param str The source string
- * @param pattern The regular expression pattern
  * @param matches Array to store the extracted matches
  * @param max_matches Maximum number of matches to extract
  * @return int Number of matches found, 0 if no matches, -1 on error
  */
-int string_extract_regex(const char *str, const char *pattern, char **matches, int max_matches) {
-    if (str == NULL || pattern == NULL || matches == NULL || max_matches <= 0) {
-        return -1;
-    }
-    regex_t regex;
-    int ret = regcomp(&regex, pattern, REG_EXTENDED);
-    if (ret != 0) {
-        char error_buffer[100];
-        regerror(ret, &regex, error_buffer, sizeof(error_buffer));
-        fprintf(stderr, "Regex compilation error: %s\n", error_buffer);
+int string_regex_extract(const string_regex_t *regex, const char *str, char **matches, int max_matches) {
+    if (regex == NULL || str == NULL || matches == NULL || max_matches <= 0) {
         return -1;
     }
-    int actual_max_groups = (max_matches < 30) ? max_matches + 1 : 30;
-    regmatch_t pmatch[30];
-    ret = regexec(&regex, str, actual_max_groups, pmatch, 0);
-    if (ret != 0) {
-        regfree(&regex);
+    int actual_max_groups = (max_matches < REGEX_MAX_GROUPS) ? max_matches + 1 : REGEX_MAX_GROUPS;
+    regmatch_t pmatch[REGEX_MAX_GROUPS];
+    if (regexec(&regex->regex, str, actual_max_groups, pmatch, 0) != 0) {
         return 0;
     }
     int match_count = 0;
@@ -217,7 +262,6 @@ int string_extract_regex(const char *str, const char *pattern, char **matches, i
                     shell_free(&match_ptr);
                     matches[j] = NULL;
                 }
-                regfree(&regex);
                 return -1;
             }
             strncpy(matches[match_count], str + start, length);
@@ -226,6 +270,257 @@ int string_extract_regex(const char *str, const char *pattern, char **matches, i
         }
     }
     
-    regfree(&regex);
     return match_count;
 }
+
+/**
+ * @brief Frees a compiled regular expression
+ * 
+ * @param regex The compiled expression (can be NULL)
+ */
+void string_regex_free(string_regex_t *regex) {
+    if (regex == NULL) {
+        return;
+    }
+    regfree(&regex->regex);
+    shell_free((void **)&regex->pattern);
+    shell_free((void **)&regex);
+}
+
+/**
+ * @brief Looks up an expression in the regex cache
+ * 
+ * @param pattern The regular expression
+ * @param flags The compilation flags
+ * @return string_regex_t* The cached expression, or NULL if it is not cached
+ * @note The caller holds the lock of the cache
+ */
+static string_regex_t *find_cached_regex(const char *pattern, int flags) {
+    for (int i = 0; i < regex_cache_count; i++) {
+        if (regex_cache[i]->flags == flags && strcmp(regex_cache[i]->pattern, pattern) == 0) {
+            return regex_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Gets the compiled form of a regular expression from the regex cache
+ * 
+ * The expression is compiled and added to the cache the first time it is
+ * requested. When the cache is full, it is compiled for the caller alone.
+ * 
+ * @param pattern The regular expression
+ * @param flags The compilation flags
+ * @param owned Set to true if the caller must free the expression
+ * @return string_regex_t* The compiled expression, or NULL on error
+ */
+static string_regex_t *get_cached_regex(const char *pattern, int flags, bool *owned) {
+    *owned = false;
+    pthread_rwlock_rdlock(&regex_cache_lock);
+    string_regex_t *regex = find_cached_regex(pattern, flags);
+    pthread_rwlock_unlock(&regex_cache_lock);
+    if (regex != NULL) {
+        return regex;
+    }
+    pthread_rwlock_wrlock(&regex_cache_lock);
+    regex = find_cached_regex(pattern, flags);
+    if (regex == NULL) {
+        regex = string_regex_compile(pattern, flags);
+        if (regex != NULL && regex_cache_count < REGEX_CACHE_SIZE) {
+            regex_cache[regex_cache_count++] = regex;
+        } else {
+            *owned = (regex != NULL);
+        }
+    }
+    pthread_rwlock_unlock(&regex_cache_lock);
+    return regex;
+}
+
+/**
+ * @brief Checks if a string matches a regular expression
+ * 
+ * @param str The string to check
+ * @param pattern The regular expression pattern
+ * @return int 1 if the string matches, 0 if it doesn't match, -1 on error
+ * 
+ * @note The pattern is compiled on its first use only
+ */
+int string_matches_regex(const char *str, const char *pattern) {
+    if (str == NULL || pattern == NULL) {
+        return -1;
+    }
+    bool owned;
+    string_regex_t *regex = get_cached_regex(pattern, REG_EXTENDED, &owned);
+    if (regex == NULL) {
+        return -1;
+    }
+    int ret = string_regex_match(regex, str);
+    if (owned) {
+        string_regex_free(regex);
+    }
+    return ret;
+}
+
+/**
+ * @brief Extracts substrings matching a regular expression pattern
+ * 
+ * @param str The source string
+ * @param pattern The regular expression pattern
+ * @param matches Array to store the extracted matches
+ * @param max_matches Maximum number of matches to extract
+ * @return int Number of matches found, 0 if no matches, -1 on error
+ * 
+ * @note The pattern is compiled on its first use only
+ */
+int string_extract_regex(const char *str, const char *pattern, char **matches, int max_matches) {
+    if (str == NULL || pattern == NULL || matches == NULL || max_matches <= 0) {
+        return -1;
+    }
+    bool owned;
+    string_regex_t *regex = get_cached_regex(pattern, REG_EXTENDED, &owned);
+    if (regex == NULL) {
+        return -1;
+    }
+    int ret = string_regex_extract(regex, str, matches, max_matches);
+    if (owned) {
+        string_regex_free(regex);
+    }
+    return ret;
+}
+
+/**
+ * @brief Frees the expressions cached by string_matches_regex and string_extract_regex
+ */
+void string_regex_cleanup(void) {
+    pthread_rwlock_wrlock(&regex_cache_lock);
+    for (int i = 0; i < regex_cache_count; i++) {
+        string_regex_free(regex_cache[i]);
+        regex_cache[i] = NULL;
+    }
+    regex_cache_count = 0;
+    pthread_rwlock_unlock(&regex_cache_lock);
+}
+
+/**
+ * @brief Smallest allocation of a string builder
+ */
+#define STRING_BUILDER_MIN_CAPACITY 64
+
+/**
+ * @brief Initializes an empty string builder
+ * 
+ * @param builder The string builder to initialize
+ * @param arena The arena allocating the string, or NULL to allocate it on the heap
+ */
+void string_builder_init(string_builder_t *builder, arena_t *arena) {
+    if (builder == NULL) {
+        return;
+    }
+    builder->arena = arena;
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+}
+
+/**
+ * @brief Makes room in a string builder for characters to be appended
+ * 
+ * The allocation at least doubles whenever it grows, so that appending n
+ * characters one piece at a time copies O(n) characters overall. In an arena,
+ * the string is grown in place as long as it is the last allocation.
+ * 
+ * @param builder The string builder
+ * @param length The number of characters that will be appended
+ * @return bool true on success, false on allocation failure
+ */
+bool string_builder_reserve(string_builder_t *builder, size_t length) {
+    if (builder == NULL) {
+        return false;
+    }
+    if (length < builder->capacity - builder->length) {
+        return true;
+    }
+    size_t needed = builder->length + length + 1;
+    size_t capacity = (builder->capacity > 0) ? builder->capacity * 2 : STRING_BUILDER_MIN_CAPACITY;
+    if (capacity < needed) {
+        capacity = needed;
+    }
+    char *data;
+    if (builder->arena != NULL) {
+        data = (char *)arena_realloc(builder->arena, builder->data, builder->capacity, capacity);
+    } else {
+        data = (char *)shell_realloc(builder->data, capacity);
+    }
+    if (data == NULL) {
+        return false;
+    }
+    builder->data = data;
+    builder->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Appends the beginning of a string to a string builder
+ * 
+ * @param builder The string builder
+ * @param str The string to append
+ * @param length The number of characters to append
+ * @return bool true on success, false on allocation failure
+ */
+bool string_builder_append_length(string_builder_t *builder, const char *str, size_t length) {
+    if (str == NULL || !string_builder_reserve(builder, length)) {
+        return false;
+    }
+    memcpy(builder->data + builder->length, str, length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+    return true;
+}
+
+/**
+ * @brief Appends a string to a string builder
+ * 
+ * @param builder The string builder
+ * @param str The string to append
+ * @return bool true on success, false on allocation failure
+ */
+bool string_builder_append(string_builder_t *builder, const char *str) {
+    if (str == NULL) {
+        return false;
+    }
+    return string_builder_append_length(builder, str, strlen(str));
+}
+
+/**
+ * @brief Takes the string out of a string builder, leaving the builder empty
+ * 
+ * @param builder The string builder
+ * @return char* The string (an empty string if nothing was appended), or NULL on allocation failure
+ */
+char *string_builder_finish(string_builder_t *builder) {
+    if (builder == NULL || !string_builder_reserve(builder, 0)) {
+        return NULL;
+    }
+    char *data = builder->data;
+    data[builder->length] = '\0';
+    string_builder_init(builder, builder->arena);
+    return data;
+}
+
+/**
+ * @brief Releases the string of a string builder, leaving the builder empty
+ * 
+ * A string allocated in an arena is released along with the arena.
+ * 
+ * @param builder The string builder
+ */
+void string_builder_free(string_builder_t *builder) {
+    if (builder == NULL) {
+        return;
+    }
+    if (builder->arena == NULL) {
+        shell_free((void **)&builder->data);
+    }
+    string_builder_init(builder, builder->arena);
+}
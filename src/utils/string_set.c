@@ -0,0 +1,201 @@
+/**
+ * @file string_set.c
+ * @brief Implementation of the thread-safe string set
+ *
+ * Strings are copied into an arena owned by the set and indexed by their
+ * FNV-1a hash in an open addressing table, which is grown to keep it at most
+ * half full. Lookups take a shared lock, so that threads only wait on each
+ * other when a string is added; a string missing from the set is looked up
+ * again under the exclusive lock before being added, so that two threads
+ * adding the same string get the same copy.
+ */
+
+#include "utils/string_set.h"
+#include "utils/arena.h"
+#include "utils/hash.h"
+#include "utils/memory.h"
+#include <string.h>
+#include <pthread.h>
+
+/**
+ * @brief Initial number of slots of a set (power of two)
+ */
+#define STRING_SET_INITIAL_SIZE 64
+
+/**
+ * @brief Size of the arena chunks holding the strings of a set
+ */
+#define STRING_SET_ARENA_CHUNK_SIZE (16 * 1024)
+
+/**
+ * @brief A string set
+ */
+struct string_set {
+    pthread_rwlock_t lock;      // Shared for lookups, exclusive for insertions
+    arena_t *arena;             // Storage of the strings
+    const char **slots;         // Open addressing table of strings (NULL if empty)
+    size_t size;                // Number of slots (power of two)
+    size_t count;               // Number of strings
+};
+
+/**
+ * @brief Find the slot of a string, or the empty slot where it belongs
+ *
+ * @param slots The table
+ * @param size The number of slots (power of two)
+ * @param str The string
+ * @param length The length of the string
+ * @return size_t The slot
+ */
+static size_t find_slot(const char **slots, size_t size, const char *str, size_t length) {
+    size_t mask = size - 1;
+    size_t slot = (size_t)hash_fnv1a(str, length) & mask;
+    while (slots[slot] != NULL && (strncmp(slots[slot], str, length) != 0 || slots[slot][length] != '\0')) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Create an empty string set
+ *
+ * @return string_set_t* The new set, NULL on allocation failure
+ */
+string_set_t *string_set_create(void) {
+    string_set_t *set = (string_set_t *)shell_calloc(1, sizeof(string_set_t));
+    if (set == NULL) {
+        return NULL;
+    }
+    set->arena = arena_create(STRING_SET_ARENA_CHUNK_SIZE);
+    set->slots = (const char **)shell_calloc(STRING_SET_INITIAL_SIZE, sizeof(const char *));
+    if (set->arena == NULL || set->slots == NULL) {
+        arena_destroy(set->arena);
+        shell_free((void **)&set->slots);
+        shell_free((void **)&set);
+        return NULL;
+    }
+    set->size = STRING_SET_INITIAL_SIZE;
+    pthread_rwlock_init(&set->lock, NULL);
+    return set;
+}
+
+/**
+ * @brief Look up the stored copy of a string
+ *
+ * @param set The set
+ * @param str The string
+ * @param length The length of the string
+ * @return const char* The stored copy, NULL if the string is not in the set
+ */
+static const char *find_string(string_set_t *set, const char *str, size_t length) {
+    pthread_rwlock_rdlock(&set->lock);
+    const char *stored = set->slots[find_slot(set->slots, set->size, str, length)];
+    pthread_rwlock_unlock(&set->lock);
+    return stored;
+}
+
+/**
+ * @brief Check whether a string is in a set
+ *
+ * @param set The set (can be NULL)
+ * @param str The string
+ * @param length The length of the string
+ * @return bool True if the string is in the set
+ */
+bool string_set_contains(string_set_t *set, const char *str, size_t length) {
+    if (set == NULL) {
+        return false;
+    }
+    return (find_string(set, str, length) != NULL);
+}
+
+/**
+ * @brief Double the number of slots of a set
+ *
+ * @param set The set, locked for writing
+ * @return bool True on success, false on allocation failure
+ */
+static bool grow_set(string_set_t *set) {
+    size_t new_size = set->size * 2;
+    const char **new_slots = (const char **)shell_calloc(new_size, sizeof(const char *));
+    if (new_slots == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < set->size; i++) {
+        if (set->slots[i] != NULL) {
+            new_slots[find_slot(new_slots, new_size, set->slots[i], strlen(set->slots[i]))] = set->slots[i];
+        }
+    }
+    shell_free((void **)&set->slots);
+    set->slots = new_slots;
+    set->size = new_size;
+    return true;
+}
+
+/**
+ * @brief Add a string to a set and get its stored copy
+ *
+ * @param set The set (can be NULL)
+ * @param str The string (need not be NUL-terminated)
+ * @param length The length of the string
+ * @return const char* The copy of the string stored in the set, NULL on allocation failure
+ *
+ * @note The stored copy lives until the set is freed, and every call with the
+ *       same string returns the same pointer
+ */
+const char *string_set_intern(string_set_t *set, const char *str, size_t length) {
+    if (set == NULL || str == NULL) {
+        return NULL;
+    }
+    const char *stored = find_string(set, str, length);
+    if (stored != NULL) {
+        return stored;
+    }
+    pthread_rwlock_wrlock(&set->lock);
+    size_t slot = find_slot(set->slots, set->size, str, length);
+    stored = set->slots[slot];
+    if (stored == NULL) {
+        bool success = true;
+        if ((set->count + 1) * 2 > set->size) {
+            success = grow_set(set);
+            slot = find_slot(set->slots, set->size, str, length);
+        }
+        char *copy = success ? (char *)arena_alloc(set->arena, length + 1) : NULL;
+        if (copy != NULL) {
+            memcpy(copy, str, length);
+            copy[length] = '\0';
+            set->slots[slot] = copy;
+            set->count++;
+            stored = copy;
+        }
+    }
+    pthread_rwlock_unlock(&set->lock);
+    return stored;
+}
+
+/**
+ * @brief Add a string to a set
+ *
+ * @param set The set (can be NULL)
+ * @param str The string
+ * @param length The length of the string
+ * @return bool True if the string is in the set, false on allocation failure
+ */
+bool string_set_add(string_set_t *set, const char *str, size_t length) {
+    return (string_set_intern(set, str, length) != NULL);
+}
+
+/**
+ * @brief Free a string set
+ *
+ * @param set The set (can be NULL)
+ */
+void string_set_free(string_set_t *set) {
+    if (set == NULL) {
+        return;
+    }
+    arena_destroy(set->arena);
+    shell_free((void **)&set->slots);
+    pthread_rwlock_destroy(&set->lock);
+    shell_free((void **)&set);
+}
@@ -0,0 +1,58 @@
+/**
+ * @file vector.c
+ * @brief Implementation of the growth of typed vectors
+ *
+ * The functions generated by VECTOR_DEFINE only check whether a vector is
+ * full; growing it is done here once for all element types. The capacity
+ * doubles on each growth, so appending n elements copies O(n) elements
+ * overall, whichever allocator the vector uses.
+ */
+
+#include "utils/vector.h"
+#include "utils/memory.h"
+#include <limits.h>
+#include <stdint.h>
+
+/**
+ * @brief Number of elements allocated by the first growth of a vector
+ */
+#define VECTOR_INITIAL_CAPACITY 4
+
+/**
+ * @brief Make room for elements in a vector of any type
+ *
+ * @param items Pointer to the elements of the vector
+ * @param capacity Pointer to the number of allocated elements
+ * @param count Number of elements in use
+ * @param needed Number of elements the vector must be able to hold
+ * @param element_size Size of an element in bytes
+ * @param arena Arena allocating the elements (NULL for the heap)
+ * @return bool true on success, false on allocation failure
+ */
+bool vector_reserve(void **items, int *capacity, int count, int needed, size_t element_size, arena_t *arena) {
+    if (items == NULL || capacity == NULL || needed < 0) {
+        return false;
+    }
+    if (needed <= *capacity) {
+        return true;
+    }
+    int new_capacity = (*capacity > 0) ? *capacity : VECTOR_INITIAL_CAPACITY;
+    while (new_capacity < needed) {
+        new_capacity = (new_capacity <= INT_MAX / 2) ? new_capacity * 2 : INT_MAX;
+    }
+    if ((size_t)new_capacity > SIZE_MAX / element_size) {
+        return false;
+    }
+    void *new_items;
+    if (arena != NULL) {
+        new_items = arena_realloc(arena, *items, (size_t)count * element_size, (size_t)new_capacity * element_size);
+    } else {
+        new_items = shell_realloc(*items, (size_t)new_capacity * element_size);
+    }
+    if (new_items == NULL) {
+        return false;
+    }
+    *items = new_items;
+    *capacity = new_capacity;
+    return true;
+}
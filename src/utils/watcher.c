@@ -0,0 +1,416 @@
+/**
+ * @file watcher.c
+ * @brief Implementation of the recursive directory change watcher
+ *
+ * inotify only watches single directories, so every directory of the tree
+ * gets its own watch. The path of each watched directory is kept in a table
+ * indexed by watch descriptor to turn events back into full paths. When the
+ * kernel event queue overflows, the roots of the watched trees are reported
+ * as changed so that the caller can rescan them. Excluded directories are
+ * recognized by device and inode, so that they are found whatever the path
+ * they are reached through, and even when they are created after the
+ * exclusion.
+ */
+
+#include "utils/watcher.h"
+#include "utils/memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <dirent.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+/**
+ * @brief Events watched on every directory
+ */
+#define WATCH_EVENTS (IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)
+
+/**
+ * @brief A watcher
+ */
+struct watcher {
+    int fd;                     // inotify instance
+    char **dirs;                // Path of the directory watched by each watch descriptor
+    size_t dir_capacity;        // Number of slots in dirs
+    char **roots;               // Roots of the watched trees
+    size_t root_count;          // Number of roots
+    size_t root_capacity;       // Allocated number of roots
+    char **excluded;            // Directories excluded from the watched trees
+    size_t excluded_count;      // Number of excluded directories
+    size_t excluded_capacity;   // Allocated number of excluded directories
+    char **changes;             // Paths changed since the last watcher_take_changes()
+    size_t change_count;        // Number of changed paths
+    size_t change_capacity;     // Allocated number of changed paths
+};
+
+/**
+ * @brief Append a string to a growable string array
+ *
+ * @param array The array
+ * @param count The number of strings in the array
+ * @param capacity The allocated number of strings
+ * @param str The string to copy into the array
+ * @return bool True on success, false on allocation failure
+ */
+static bool append_string(char ***array, size_t *count, size_t *capacity, const char *str) {
+    if (*count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+        char **new_array = (char **)shell_realloc(*array, new_capacity * sizeof(char *));
+        if (new_array == NULL) {
+            return false;
+        }
+        *array = new_array;
+        *capacity = new_capacity;
+    }
+    char *copy = shell_strdup(str);
+    if (copy == NULL) {
+        return false;
+    }
+    (*array)[(*count)++] = copy;
+    return true;
+}
+
+/**
+ * @brief Create a watcher
+ *
+ * @return watcher_t* The new watcher, NULL if inotify is unavailable or on allocation failure
+ */
+watcher_t *watcher_create(void) {
+    watcher_t *watcher = (watcher_t *)shell_calloc(1, sizeof(watcher_t));
+    if (watcher == NULL) {
+        return NULL;
+    }
+    watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher->fd < 0) {
+        shell_free((void **)&watcher);
+        return NULL;
+    }
+    return watcher;
+}
+
+/**
+ * @brief Watch a single directory
+ *
+ * @param watcher The watcher
+ * @param dir_path The directory
+ * @return bool True if the directory is newly watched, false if it was already
+ *              watched (e.g. through a symlink) or could not be watched
+ */
+static bool watch_directory(watcher_t *watcher, const char *dir_path) {
+    int wd = inotify_add_watch(watcher->fd, dir_path, WATCH_EVENTS | IN_ONLYDIR);
+    if (wd < 0) {
+        return false;
+    }
+    if ((size_t)wd >= watcher->dir_capacity) {
+        size_t new_capacity = (watcher->dir_capacity == 0) ? 64 : watcher->dir_capacity;
+        while (new_capacity <= (size_t)wd) {
+            new_capacity *= 2;
+        }
+        char **new_dirs = (char **)shell_realloc(watcher->dirs, new_capacity * sizeof(char *));
+        if (new_dirs == NULL) {
+            inotify_rm_watch(watcher->fd, wd);
+            return false;
+        }
+        memset(new_dirs + watcher->dir_capacity, 0, (new_capacity - watcher->dir_capacity) * sizeof(char *));
+        watcher->dirs = new_dirs;
+        watcher->dir_capacity = new_capacity;
+    }
+    if (watcher->dirs[wd] != NULL) {
+        return false;
+    }
+    watcher->dirs[wd] = shell_strdup(dir_path);
+    return (watcher->dirs[wd] != NULL);
+}
+
+/**
+ * @brief Check whether a directory is excluded from the watched trees
+ *
+ * @param watcher The watcher
+ * @param dir_stat The status of the directory
+ * @return bool True if the directory is one of the excluded directories
+ */
+static bool is_excluded(const watcher_t *watcher, const struct stat *dir_stat) {
+    struct stat excluded_stat;
+    for (size_t i = 0; i < watcher->excluded_count; i++) {
+        if (stat(watcher->excluded[i], &excluded_stat) == 0 &&
+            excluded_stat.st_dev == dir_stat->st_dev && excluded_stat.st_ino == dir_stat->st_ino) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether a path is an excluded directory
+ *
+ * @param watcher The watcher
+ * @param path The path
+ * @return bool True if the path is one of the excluded directories
+ */
+static bool is_excluded_path(const watcher_t *watcher, const char *path) {
+    struct stat path_stat;
+    if (watcher->excluded_count == 0 || stat(path, &path_stat) != 0 || !S_ISDIR(path_stat.st_mode)) {
+        return false;
+    }
+    return is_excluded(watcher, &path_stat);
+}
+
+/**
+ * @brief Watch a directory and its subdirectories
+ *
+ * Excluded subdirectories are left out, along with everything below them.
+ *
+ * @param watcher The watcher
+ * @param dir_path The directory
+ * @return bool True if the directory is watched
+ */
+static bool watch_tree(watcher_t *watcher, const char *dir_path) {
+    if (!watch_directory(watcher, dir_path)) {
+        return false;
+    }
+    DIR *dir = opendir(dir_path);
+    if (dir == NULL) {
+        return true;
+    }
+    struct dirent *entry;
+    char full_path[PATH_MAX];
+    struct stat file_stat;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        snprintf(full_path, sizeof(full_path), "%s/%s", dir_path, entry->d_name);
+        if (stat(full_path, &file_stat) == 0 && S_ISDIR(file_stat.st_mode) && !is_excluded(watcher, &file_stat)) {
+            watch_tree(watcher, full_path);
+        }
+    }
+    closedir(dir);
+    return true;
+}
+
+/**
+ * @brief Exclude a directory and its subdirectories from the watched trees
+ *
+ * @param watcher The watcher
+ * @param dir_path The directory (need not exist yet)
+ * @return bool True on success, false on allocation failure
+ *
+ * @note Must be called before the trees holding the directory are added
+ */
+bool watcher_exclude(watcher_t *watcher, const char *dir_path) {
+    if (watcher == NULL || dir_path == NULL) {
+        return false;
+    }
+    return append_string(&watcher->excluded, &watcher->excluded_count, &watcher->excluded_capacity, dir_path);
+}
+
+/**
+ * @brief Watch a directory and all its subdirectories
+ *
+ * @param watcher The watcher
+ * @param dir_path The root of the directory tree
+ * @return bool True if the root directory is watched
+ */
+bool watcher_add_tree(watcher_t *watcher, const char *dir_path) {
+    if (watcher == NULL || dir_path == NULL) {
+        return false;
+    }
+    if (!append_string(&watcher->roots, &watcher->root_count, &watcher->root_capacity, dir_path)) {
+        return false;
+    }
+    return watch_tree(watcher, dir_path);
+}
+
+/**
+ * @brief Stop watching a directory and its subdirectories
+ *
+ * Used when a directory is moved out of its watched location, since its
+ * watches would otherwise keep reporting events under its former path.
+ *
+ * @param watcher The watcher
+ * @param dir_path The former path of the directory
+ */
+static void unwatch_tree(watcher_t *watcher, const char *dir_path) {
+    size_t len = strlen(dir_path);
+    for (size_t wd = 0; wd < watcher->dir_capacity; wd++) {
+        const char *path = watcher->dirs[wd];
+        if (path != NULL && strncmp(path, dir_path, len) == 0 && (path[len] == '\0' || path[len] == '/')) {
+            inotify_rm_watch(watcher->fd, (int)wd);
+            shell_free((void **)&watcher->dirs[wd]);
+        }
+    }
+}
+
+/**
+ * @brief Handle a single inotify event
+ *
+ * Events about an excluded directory, e.g. its creation inside a watched
+ * directory, are dropped; the events below it never arrive, since it is
+ * not watched.
+ *
+ * @param watcher The watcher
+ * @param event The event
+ * @return int Number of changes collected
+ */
+static int handle_event(watcher_t *watcher, const struct inotify_event *event) {
+    if (event->mask & IN_Q_OVERFLOW) {
+        int count = 0;
+        for (size_t i = 0; i < watcher->root_count; i++) {
+            count += append_string(&watcher->changes, &watcher->change_count, &watcher->change_capacity, watcher->roots[i]) ? 1 : 0;
+        }
+        return count;
+    }
+    if (event->wd < 0 || (size_t)event->wd >= watcher->dir_capacity || watcher->dirs[event->wd] == NULL) {
+        return 0;
+    }
+    if (event->mask & IN_IGNORED) {
+        shell_free((void **)&watcher->dirs[event->wd]);
+        return 0;
+    }
+    if (event->len == 0) {
+        return 0;
+    }
+    char full_path[PATH_MAX];
+    snprintf(full_path, sizeof(full_path), "%s/%s", watcher->dirs[event->wd], event->name);
+    if ((event->mask & IN_ISDIR) && is_excluded_path(watcher, full_path)) {
+        return 0;
+    }
+    if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+            watch_tree(watcher, full_path);
+        } else if (event->mask & IN_MOVED_FROM) {
+            unwatch_tree(watcher, full_path);
+        }
+    }
+    return append_string(&watcher->changes, &watcher->change_count, &watcher->change_capacity, full_path) ? 1 : 0;
+}
+
+/**
+ * @brief Wait for changes in the watched trees
+ *
+ * Waits up to timeout_ms for inotify events, then collects the paths of all
+ * pending events without blocking.
+ *
+ * @param watcher The watcher
+ * @param timeout_ms Maximum time to wait in milliseconds (-1 to wait indefinitely)
+ * @return int Number of changes collected, 0 on timeout, -1 on error or interruption
+ */
+int watcher_poll(watcher_t *watcher, int timeout_ms) {
+    if (watcher == NULL) {
+        return -1;
+    }
+    struct pollfd pfd = { .fd = watcher->fd, .events = POLLIN };
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) {
+        return ready;
+    }
+    char buffer[16 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int count = 0;
+    for (;;) {
+        ssize_t length = read(watcher->fd, buffer, sizeof(buffer));
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (length == 0) {
+            break;
+        }
+        for (char *ptr = buffer; ptr < buffer + length; ) {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            count += handle_event(watcher, event);
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Compare two strings for qsort()
+ *
+ * @param a Pointer to the first string
+ * @param b Pointer to the second string
+ * @return int Result of strcmp()
+ */
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/**
+ * @brief Take the paths changed since the last call
+ *
+ * Paths are sorted and duplicates are removed, so that a burst of events on
+ * the same file yields a single change.
+ *
+ * @param watcher The watcher
+ * @param count Pointer to store the number of paths
+ * @return char** Sorted array of unique paths (to be freed with watcher_free_changes()), NULL if none
+ */
+char **watcher_take_changes(watcher_t *watcher, size_t *count) {
+    *count = 0;
+    if (watcher == NULL || watcher->change_count == 0) {
+        return NULL;
+    }
+    char **paths = watcher->changes;
+    size_t path_count = watcher->change_count;
+    watcher->changes = NULL;
+    watcher->change_count = 0;
+    watcher->change_capacity = 0;
+    qsort(paths, path_count, sizeof(char *), compare_paths);
+    size_t unique = 0;
+    for (size_t i = 0; i < path_count; i++) {
+        if (unique > 0 && strcmp(paths[unique - 1], paths[i]) == 0) {
+            shell_free((void **)&paths[i]);
+        } else {
+            paths[unique++] = paths[i];
+        }
+    }
+    *count = unique;
+    return paths;
+}
+
+/**
+ * @brief Free an array returned by watcher_take_changes()
+ *
+ * @param paths The paths (can be NULL)
+ * @param count The number of paths
+ */
+void watcher_free_changes(char **paths, size_t count) {
+    if (paths == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        shell_free((void **)&paths[i]);
+    }
+    shell_free((void **)&paths);
+}
+
+/**
+ * @brief Free a watcher
+ *
+ * @param watcher The watcher (can be NULL)
+ */
+void watcher_free(watcher_t *watcher) {
+    if (watcher == NULL) {
+        return;
+    }
+    close(watcher->fd);
+    for (size_t i = 0; i < watcher->dir_capacity; i++) {
+        shell_free((void **)&watcher->dirs[i]);
+    }
+    shell_free((void **)&watcher->dirs);
+    watcher_free_changes(watcher->roots, watcher->root_count);
+    watcher_free_changes(watcher->excluded, watcher->excluded_count);
+    watcher_free_changes(watcher->changes, watcher->change_count);
+    shell_free((void **)&watcher);
+}
@@ -0,0 +1,325 @@
+/**
+ * @file worker_pool.c
+ * @brief Implementation of the worker thread pool
+ *
+ * This file provides a small streaming thread pool. Items are submitted to a
+ * bounded ring buffer from which worker threads pull their work, while the
+ * submitting thread reports completed items in submission order and runs the
+ * completion callbacks itself. This keeps all console reporting on a single
+ * thread and in a reproducible order, independently of how the items were
+ * scheduled, and lets processing start before all items are known.
+ */
+
+#define _GNU_SOURCE
+
+#include "utils/worker_pool.h"
+#include "utils/memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/**
+ * @brief cgroup v2 CPU bandwidth file
+ */
+#define CGROUP_V2_CPU_MAX "/sys/fs/cgroup/cpu.max"
+
+/**
+ * @brief cgroup v1 CPU quota and period files
+ */
+#define CGROUP_V1_CPU_QUOTA "/sys/fs/cgroup/cpu/cpu.cfs_quota_us"
+#define CGROUP_V1_CPU_PERIOD "/sys/fs/cgroup/cpu/cpu.cfs_period_us"
+
+/**
+ * @brief State of a running worker pool
+ *
+ * Submitted items are stored in a ring buffer of capacity slots. Items are
+ * identified by a monotonic sequence number; the slot of an item is its
+ * sequence number modulo the capacity. Items between head and next are being
+ * processed or are waiting to be reported, items between next and tail are
+ * waiting for a worker.
+ */
+struct worker_pool {
+    void **items;               // Ring buffer of submitted items
+    bool *completed;            // Completion flag for each slot
+    size_t capacity;            // Number of slots in the ring buffer
+    size_t head;                // Sequence number of the oldest unreported item
+    size_t next;                // Sequence number of the next item to hand out
+    size_t tail;                // Sequence number of the next submitted item
+    bool closed;                // Set once no more items will be submitted
+    worker_pool_task_t task;    // Task callback
+    worker_pool_done_t done;    // Completion callback (can be NULL)
+    void *user_data;            // Opaque pointer passed to the callbacks
+    pthread_t *threads;         // Worker threads
+    int thread_count;           // Number of running worker threads (0 when sequential)
+    pthread_mutex_t lock;       // Protects the ring buffer state
+    pthread_cond_t task_ready;  // Signaled when an item is submitted or the pool is closed
+    pthread_cond_t task_done;   // Signaled every time an item completes
+};
+
+/**
+ * @brief Read a single integer value from a file
+ *
+ * @param path Path of the file to read
+ * @param value Pointer to store the value
+ * @return bool true if a value was read, false otherwise
+ */
+static bool read_long_from_file(const char *path, long *value) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    bool found = (fscanf(file, "%ld", value) == 1);
+    fclose(file);
+    return found;
+}
+
+/**
+ * @brief Get the CPU limit imposed by the cgroup quota
+ *
+ * Reads the cgroup v2 cpu.max file, falling back to the cgroup v1 CFS quota
+ * files. The quota is rounded up to the next whole CPU.
+ *
+ * @return int Number of CPUs allowed by the quota, or 0 if there is no quota
+ */
+static int get_cgroup_cpu_limit(void) {
+    long quota = -1;
+    long period = 0;
+    FILE *file = fopen(CGROUP_V2_CPU_MAX, "r");
+    if (file != NULL) {
+        char quota_str[32];
+        if (fscanf(file, "%31s %ld", quota_str, &period) == 2 && strcmp(quota_str, "max") != 0) {
+            quota = strtol(quota_str, NULL, 10);
+        }
+        fclose(file);
+    } else if (!read_long_from_file(CGROUP_V1_CPU_QUOTA, &quota) ||
+               !read_long_from_file(CGROUP_V1_CPU_PERIOD, &period)) {
+        return 0;
+    }
+    if (quota <= 0 || period <= 0) {
+        return 0;
+    }
+    return (int)((quota + period - 1) / period);
+}
+
+/**
+ * @brief Determine the default number of worker threads
+ *
+ * Starts from the number of online CPUs, then restricts it to the CPUs the
+ * process is allowed to run on and to the cgroup CPU quota, so that running
+ * inside a container does not oversubscribe the allotted CPU time.
+ *
+ * @return int Number of worker threads to use (always at least 1)
+ */
+int worker_pool_default_jobs(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int jobs = (online > 0) ? (int)online : 1;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        int allowed = CPU_COUNT(&cpu_set);
+        if (allowed > 0 && allowed < jobs) {
+            jobs = allowed;
+        }
+    }
+    int quota = get_cgroup_cpu_limit();
+    if (quota > 0 && quota < jobs) {
+        jobs = quota;
+    }
+
+    return jobs;
+}
+
+/**
+ * @brief Worker thread main loop
+ *
+ * Repeatedly claims the next unassigned item, runs the task on it and marks it
+ * as completed, until the pool is closed and every item has been handed out.
+ *
+ * @param arg Pointer to the shared worker_pool_t
+ * @return void* Always NULL
+ */
+static void *worker_pool_thread(void *arg) {
+    worker_pool_t *pool = (worker_pool_t *)arg;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->next == pool->tail && !pool->closed) {
+            pthread_cond_wait(&pool->task_ready, &pool->lock);
+        }
+        if (pool->next == pool->tail) {
+            break;
+        }
+        size_t slot = pool->next++ % pool->capacity;
+        void *item = pool->items[slot];
+        pthread_mutex_unlock(&pool->lock);
+
+        pool->task(item, pool->user_data);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->completed[slot] = true;
+        pthread_cond_broadcast(&pool->task_done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Report completed items in submission order
+ *
+ * Runs the completion callback for every completed item at the head of the
+ * ring buffer, and keeps waiting for the oldest item until at most pending
+ * items remain unreported. The completion callback is run without holding the
+ * lock, so that workers can make progress in the meantime.
+ *
+ * @param pool The worker pool (its lock must be held by the caller)
+ * @param pending Number of items allowed to remain unreported
+ */
+static void worker_pool_report(worker_pool_t *pool, size_t pending) {
+    while (pool->head < pool->tail) {
+        size_t slot = pool->head % pool->capacity;
+        if (!pool->completed[slot]) {
+            if (pool->tail - pool->head <= pending) {
+                break;
+            }
+            pthread_cond_wait(&pool->task_done, &pool->lock);
+            continue;
+        }
+        void *item = pool->items[slot];
+        pool->head++;
+        if (pool->done != NULL) {
+            pthread_mutex_unlock(&pool->lock);
+            pool->done(item, pool->user_data);
+            pthread_mutex_lock(&pool->lock);
+        }
+    }
+}
+
+/**
+ * @brief Create a worker pool
+ *
+ * Spawns up to jobs worker threads that process submitted items concurrently.
+ * At most capacity items can be in flight (queued, running or waiting to be
+ * reported); worker_pool_submit() blocks once that limit is reached, which
+ * bounds memory usage regardless of how many items are submitted overall.
+ *
+ * @param jobs Number of worker threads to use (1 or less runs sequentially)
+ * @param capacity Maximum number of items in flight
+ * @param task Callback executed for each item on a worker thread
+ * @param done Callback executed in submission order on the submitting thread (can be NULL)
+ * @param user_data Opaque pointer passed to both callbacks
+ *
+ * @return worker_pool_t* The new pool, or NULL if task is NULL or if the pool
+ *                        bookkeeping could not be allocated
+ *
+ * @note If no worker thread can be created, items are processed sequentially
+ * @note The task callback must be thread-safe; the completion callback is not
+ *       required to be, since it always runs on the submitting thread
+ */
+worker_pool_t *worker_pool_create(int jobs, size_t capacity, worker_pool_task_t task, worker_pool_done_t done, void *user_data) {
+    if (task == NULL) {
+        return NULL;
+    }
+    worker_pool_t *pool = (worker_pool_t *)shell_calloc(1, sizeof(worker_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->task = task;
+    pool->done = done;
+    pool->user_data = user_data;
+    if (jobs <= 1) {
+        return pool;
+    }
+    pool->capacity = (capacity > (size_t)jobs) ? capacity : (size_t)jobs;
+    pool->items = (void **)shell_calloc(pool->capacity, sizeof(void *));
+    pool->completed = (bool *)shell_calloc(pool->capacity, sizeof(bool));
+    pool->threads = (pthread_t *)shell_calloc((size_t)jobs, sizeof(pthread_t));
+    if (pool->items == NULL || pool->completed == NULL || pool->threads == NULL) {
+        shell_free((void **)&pool->items);
+        shell_free((void **)&pool->completed);
+        shell_free((void **)&pool->threads);
+        shell_free((void **)&pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->task_ready, NULL);
+    pthread_cond_init(&pool->task_done, NULL);
+    while (pool->thread_count < jobs &&
+           pthread_create(&pool->threads[pool->thread_count], NULL, worker_pool_thread, pool) == 0) {
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0) {
+        fprintf(stderr, "Warning: unable to start worker threads, processing sequentially\n");
+    }
+
+    return pool;
+}
+
+/**
+ * @brief Submit an item to a worker pool
+ *
+ * Queues the item for processing and reports every item that has completed in
+ * the meantime. If the pool is full, waits for the oldest item to complete and
+ * reports it before queuing the new one.
+ *
+ * @param pool The worker pool
+ * @param item The item to process
+ *
+ * @return bool true if the item was accepted, false if pool is NULL
+ */
+bool worker_pool_submit(worker_pool_t *pool, void *item) {
+    if (pool == NULL) {
+        return false;
+    }
+    if (pool->thread_count == 0) {
+        pool->task(item, pool->user_data);
+        if (pool->done != NULL) {
+            pool->done(item, pool->user_data);
+        }
+        return true;
+    }
+    pthread_mutex_lock(&pool->lock);
+    worker_pool_report(pool, pool->capacity - 1);
+    pool->items[pool->tail % pool->capacity] = item;
+    pool->completed[pool->tail % pool->capacity] = false;
+    pool->tail++;
+    pthread_cond_signal(&pool->task_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    return true;
+}
+
+/**
+ * @brief Wait for every submitted item and destroy a worker pool
+ *
+ * Closes the pool, reports the remaining items in submission order, joins the
+ * worker threads and releases the pool.
+ *
+ * @param pool The worker pool (can be NULL)
+ */
+void worker_pool_finish(worker_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    if (pool->thread_count > 0) {
+        pthread_mutex_lock(&pool->lock);
+        pool->closed = true;
+        pthread_cond_broadcast(&pool->task_ready);
+        worker_pool_report(pool, 0);
+        pthread_mutex_unlock(&pool->lock);
+        for (int i = 0; i < pool->thread_count; i++) {
+            pthread_join(pool->threads[i], NULL);
+        }
+    }
+    if (pool->threads != NULL) {
+        pthread_cond_destroy(&pool->task_done);
+        pthread_cond_destroy(&pool->task_ready);
+        pthread_mutex_destroy(&pool->lock);
+    }
+    shell_free((void **)&pool->threads);
+    shell_free((void **)&pool->completed);
+    shell_free((void **)&pool->items);
+    shell_free((void **)&pool);
+}
@@ -0,0 +1,57 @@
+#!/bin/sh
+# Watch a tree holding its own documentation directory, edit one script, and
+# check that the edit is processed exactly once: writing the documentation and
+# the build manifest must not be reported as changes of the tree.
+
+scribe="$1"
+work_dir=$(mktemp -d) || exit 1
+watch_pid=
+cleanup() {
+    if [ -n "$watch_pid" ]; then
+        kill "$watch_pid" 2>/dev/null
+        wait "$watch_pid" 2>/dev/null
+    fi
+    rm -rf "$work_dir"
+}
+trap cleanup EXIT
+trap 'exit 1' INT TERM
+
+# Wait until the log holds at least COUNT lines matching PATTERN, polling every
+# 100 ms for at most TIMEOUT tenths of a second
+wait_for() {
+    pattern="$1"
+    count="$2"
+    timeout="$3"
+    while [ "$(grep -c "$pattern" "$work_dir/watch.log")" -lt "$count" ]; do
+        if [ "$timeout" -le 0 ]; then
+            return 1
+        fi
+        timeout=$((timeout - 1))
+        sleep 0.1
+    done
+    return 0
+}
+
+fail() {
+    echo "$1" >&2
+    cat "$work_dir/watch.log" >&2
+    exit 1
+}
+
+mkdir "$work_dir/tree"
+cd "$work_dir/tree" || exit 1
+printf 'doc_path = ./docs\n' > .scribeconf
+printf '#!/bin/bash\n# @file a.sh\n# @brief A script\n\n# @function f\n# @brief Does f\nf() { :; }\n' > a.sh
+
+"$scribe" -w . > "$work_dir/watch.log" 2>&1 &
+watch_pid=$!
+wait_for "Watching" 1 300 || fail "watch mode did not start"
+printf '# @function g\n# @brief Does g\ng() { :; }\n' >> a.sh
+wait_for "Summary" 2 300 || fail "the edit was not processed"
+grep -q "Does g" docs/a.md || fail "documentation not regenerated"
+
+# A regeneration loop shows up within the 200 ms debounce delay; a slow machine
+# can only hide a loop from this check, not make it fail spuriously
+if wait_for "Changes detected" 2 20; then
+    fail "expected 1 regeneration, got $(grep -c "Changes detected" "$work_dir/watch.log")"
+fi